@@ -0,0 +1,459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "sourcecode/ensemble.h"
+#define OBSFILE "obsfile.txt" //observed outlet discharge (m^3/s), one value per line, first day 1962/01/02
+#define OUTPUTDIR "./output/" //Streamflow.Only.[k] written by DHSVM
+#define WARMUP 365 //first step used by the metrics, unless the metric has its own @start
+#define MAXMETRIC 64
+
+//objective functions of all DHSVM runs in one pass over the simulated discharge.
+//replaces NS.c and Q5.c: every output file (or ensemble store row) is read once
+//and all requested metrics are computed from it. Samples are spread over threads.
+//
+//build: gcc -O2 -fopenmp objective.c -o objective -lm   (without -fopenmp it runs serially)
+//usage: ./objective [-o obsfile] [-d outputdir] [-s ensemble_store] [-n nsample] [-w warmup] metric=file ...
+//metrics, each optionally followed by @start to override the warm-up:
+//  nse           Nash-Sutcliffe efficiency, with the mean of Obs over the whole record as in NS.c
+//  lognse        NSE of ln(Q+eps), eps = mean(Obs)/100
+//  kge           Kling-Gupta efficiency
+//  pbias         percent bias of the volume, 100*sum(Sim-Obs)/sum(Obs)
+//  fdc:LO:HI     percent bias of the flow duration curve segment between exceedance
+//                probabilities LO and HI, e.g. fdc:0:0.05 (Q5), fdc:0.2:0.7 (Q20-70)
+//  peak          percent error of the largest flow
+//  volume:T      sum of Sim on the days with Obs >= T, as in Q5.c
+//the former programs are
+//  ./NS NS.txt  ->  ./objective nse=NS.txt
+//  ./Q5 Q5.txt  ->  ./objective volume:140@30=Q5.txt
+//each file gets one value per sample, in RunNumber order. The number of samples is
+//the number of rows of the store or the highest Streamflow.Only.[k] in outputdir + 1,
+//the number of steps is the length of obsfile. Samples without a complete
+//simulation get nan.
+
+typedef enum {NSE, LOGNSE, KGE, PBIAS, FDC, PEAK, VOLUME} METRICTYPE;
+
+typedef struct {
+    METRICTYPE type;
+    char *spec; //as given on the command line
+    char *outfile;
+    int start; //first step used
+    double lo,hi; //fdc: exceedance probabilities
+    double threshold; //volume: Obs threshold
+    //Obs statistics, computed once for all samples
+    double obsmean; //mean of Obs (of ln(Obs+eps) for lognse)
+    double obsss; //sum of squared deviations from obsmean
+    double obssum;
+    double obssd;
+    double eps; //lognse
+    int bandlo,bandhi; //fdc: segment [bandlo, bandhi) of the sorted window
+    double *value; //one per sample
+} METRIC;
+
+METRIC metric[MAXMETRIC];
+int nmetric=0;
+double *Obs;
+int nstep;
+long nsample=-1;
+char *outputdir=OUTPUTDIR;
+
+//binary ensemble store written by DHSVM ("Ensemble Store" in the [OUTPUT] section)
+char *Store=NULL;
+ENSEMBLEHEADER *StoreHeader;
+long StoreRows;
+
+int CompareDescending(const void *a, const void *b)
+{
+    double x=*(const double *)a,y=*(const double *)b;
+    return (x<y)-(x>y);
+}
+
+void ParseMetric(char *arg, int warmup)
+{
+    METRIC *m=&metric[nmetric];
+    char *eq,*at,*name;
+
+    if (nmetric==MAXMETRIC) {
+        printf("too many metrics, at most %d.\n",MAXMETRIC);
+        exit(1);
+    }
+    eq=strchr(arg,'=');
+    if (eq==NULL || eq[1]=='\0') {
+        printf("%s: expected metric=file.\n",arg);
+        exit(1);
+    }
+    memset(m,0,sizeof(METRIC));
+    m->spec=arg;
+    m->outfile=eq+1;
+    name=strndup(arg,eq-arg);
+    m->start=warmup;
+    if ((at=strchr(name,'@'))!=NULL) {
+        *at='\0';
+        m->start=atoi(at+1);
+    }
+    if (strcmp(name,"nse")==0) m->type=NSE;
+    else if (strcmp(name,"lognse")==0) m->type=LOGNSE;
+    else if (strcmp(name,"kge")==0) m->type=KGE;
+    else if (strcmp(name,"pbias")==0) m->type=PBIAS;
+    else if (strcmp(name,"peak")==0) m->type=PEAK;
+    else if (sscanf(name,"fdc:%lf:%lf",&m->lo,&m->hi)==2 && 0<=m->lo && m->lo<m->hi && m->hi<=1)
+        m->type=FDC;
+    else if (sscanf(name,"volume:%lf",&m->threshold)==1) m->type=VOLUME;
+    else {
+        printf("%s: unknown metric.\n",arg);
+        exit(1);
+    }
+    if (m->start<0) {
+        printf("%s: negative start.\n",arg);
+        exit(1);
+    }
+    free(name);
+    nmetric++;
+}
+
+void LoadInput(char *obsfile)
+{
+    FILE *fp;
+    double x;
+    int size=1024;
+
+    fp=fopen(obsfile,"r");
+    if (fp==NULL) {
+        printf("can not open %s.\n",obsfile);
+        exit(1);
+    }
+    Obs=(double *)malloc(size*sizeof(double));
+    nstep=0;
+    while (fscanf(fp,"%lf",&x)==1) {
+        if (nstep==size) {
+            size*=2;
+            Obs=(double *)realloc(Obs,size*sizeof(double));
+        }
+        Obs[nstep++]=x;
+    }
+    fclose(fp);
+    if (nstep==0) {
+        printf("no values in %s.\n",obsfile);
+        exit(1);
+    }
+}
+
+void OpenStore(char *filename)
+{
+    struct stat st;
+    int fd;
+
+    fd=open(filename,O_RDONLY);
+    if (fd==-1 || fstat(fd,&st)==-1) {
+        printf("can not open %s.\n",filename);
+        exit(1);
+    }
+    Store=(char *)mmap(NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+    close(fd);
+    if (Store==(char *)MAP_FAILED || st.st_size<(long)sizeof(ENSEMBLEHEADER)) {
+        printf("can not read %s.\n",filename);
+        exit(1);
+    }
+    StoreHeader=(ENSEMBLEHEADER *)Store;
+    if (strncmp(StoreHeader->Magic,ENSEMBLE_MAGIC,8)!=0 || StoreHeader->Version!=ENSEMBLE_VERSION ||
+        StoreHeader->NSeries<1 || st.st_size<StoreHeader->DataOffset) {
+        printf("%s is not an ensemble store.\n",filename);
+        exit(1);
+    }
+    //step 0 is the start date, which has no value in Streamflow.Only either
+    if (StoreHeader->NSteps-1<nstep) {
+        printf("%s has %d steps, obsfile has %d.\n",filename,StoreHeader->NSteps-1,nstep);
+        exit(1);
+    }
+    //the daily conversion of LoadOutput() only holds for a daily time step
+    if (StoreHeader->Dt!=3600*24) {
+        printf("%s has a time step of %d s, not one day.\n",filename,StoreHeader->Dt);
+        exit(1);
+    }
+    StoreRows=(st.st_size-StoreHeader->DataOffset)/StoreHeader->RowSize;
+}
+
+//number of samples: highest k of the Streamflow.Only.[k] files + 1
+long CountOutputFiles(void)
+{
+    DIR *dir;
+    struct dirent *entry;
+    long k,n=0;
+
+    dir=opendir(outputdir);
+    if (dir==NULL) {
+        printf("can not open %s.\n",outputdir);
+        exit(1);
+    }
+    while ((entry=readdir(dir))!=NULL) {
+        if (sscanf(entry->d_name,"Streamflow.Only.[%ld]",&k)==1 && k+1>n)
+            n=k+1;
+    }
+    closedir(dir);
+    return n;
+}
+
+//Sim[j] is the discharge (m^3/s) on the day of Obs[j]. Returns 0 if the run is missing or short.
+int LoadOutput(long k, double *Sim, char **line, size_t *len)
+{
+    char filename[300];
+    FILE *fp;
+    char *p,*end;
+    int j;
+
+    sprintf(filename,"%sStreamflow.Only.[%ld]",outputdir,k);
+    fp=fopen(filename,"r");
+    if (fp==NULL)
+        return 0;
+    //delete "DATE OUTLET " and "01.01.1962-00:00:00 "
+    if (getline(line,len,fp)==-1 || getline(line,len,fp)==-1) {
+        fclose(fp);
+        return 0;
+    }
+    for (j=0;j<nstep;j++) {
+        if (getline(line,len,fp)==-1 || (p=strchr(*line,' '))==NULL)
+            break;
+        Sim[j]=strtod(p,&end);
+        if (end==p)
+            break;
+        Sim[j]=Sim[j]/3600/24; //conversion of unit:m^3/day to m^3/s (same as obsfile).
+    }
+    fclose(fp);
+    return j==nstep;
+}
+
+int LoadOutputStore(long k, double *Sim)
+{
+    ENSEMBLEROW *row;
+    float *value;
+    int j;
+
+    if (k>=StoreRows)
+        return 0;
+    row=(ENSEMBLEROW *)(Store+StoreHeader->DataOffset+k*StoreHeader->RowSize);
+    if (row->Status!=ENSEMBLE_ROW_DONE)
+        return 0;
+    value=(float *)(row+1);
+    //first series is the outlet, Sim[j] is step j+1 as in LoadOutput()
+    for (j=0;j<nstep;j++)
+        Sim[j]=(double)value[(long)(j+1)*StoreHeader->NSeries]/3600/24; //conversion of unit:m^3/day to m^3/s (same as obsfile).
+    return 1;
+}
+
+//Obs statistics that do not depend on the sample
+void PrepareMetric(METRIC *m, double *sorted)
+{
+    int j,n;
+    double sum;
+
+    if (m->start>=nstep) {
+        printf("%s: start %d is beyond the %d steps.\n",m->spec,m->start,nstep);
+        exit(1);
+    }
+    n=nstep-m->start;
+    m->value=(double *)malloc(nsample*sizeof(double));
+    switch (m->type) {
+    case NSE:
+        //mean over the whole record, squared deviations over the window, as in NS.c
+        sum=0;
+        for (j=0;j<nstep;j++)
+            sum=sum+Obs[j];
+        m->obsmean=sum/nstep;
+        m->obsss=0;
+        for (j=m->start;j<nstep;j++)
+            m->obsss=m->obsss+(Obs[j]-m->obsmean)*(Obs[j]-m->obsmean);
+        break;
+    case LOGNSE:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+Obs[j];
+        m->eps=sum/n/100;
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+log(Obs[j]+m->eps);
+        m->obsmean=sum/n;
+        m->obsss=0;
+        for (j=m->start;j<nstep;j++)
+            m->obsss=m->obsss+(log(Obs[j]+m->eps)-m->obsmean)*(log(Obs[j]+m->eps)-m->obsmean);
+        break;
+    case KGE:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+Obs[j];
+        m->obsmean=sum/n;
+        m->obsss=0;
+        for (j=m->start;j<nstep;j++)
+            m->obsss=m->obsss+(Obs[j]-m->obsmean)*(Obs[j]-m->obsmean);
+        m->obssd=sqrt(m->obsss/n);
+        break;
+    case PBIAS:
+        m->obssum=0;
+        for (j=m->start;j<nstep;j++)
+            m->obssum=m->obssum+Obs[j];
+        break;
+    case FDC:
+        m->bandlo=(int)floor(m->lo*n);
+        m->bandhi=(int)ceil(m->hi*n);
+        if (m->bandhi>n) m->bandhi=n;
+        if (m->bandhi<=m->bandlo) m->bandhi=m->bandlo+1;
+        memcpy(sorted,Obs+m->start,n*sizeof(double));
+        qsort(sorted,n,sizeof(double),CompareDescending);
+        m->obssum=0;
+        for (j=m->bandlo;j<m->bandhi;j++)
+            m->obssum=m->obssum+sorted[j];
+        break;
+    case PEAK:
+        m->obssum=Obs[m->start];
+        for (j=m->start;j<nstep;j++)
+            if (Obs[j]>m->obssum) m->obssum=Obs[j];
+        break;
+    case VOLUME:
+        break;
+    }
+}
+
+//sorted holds Sim sorted in descending order from step *sortedstart on (-1: not sorted yet)
+double Evaluate(METRIC *m, double *Sim, double *sorted, int *sortedstart)
+{
+    int j,n=nstep-m->start;
+    double sum,sum2,mean,ss,cov,r,alpha,beta,max;
+
+    switch (m->type) {
+    case NSE:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+(Obs[j]-Sim[j])*(Obs[j]-Sim[j]);
+        return 1-sum/m->obsss;
+    case LOGNSE:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+(log(Obs[j]+m->eps)-log(Sim[j]+m->eps))*(log(Obs[j]+m->eps)-log(Sim[j]+m->eps));
+        return 1-sum/m->obsss;
+    case KGE:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+Sim[j];
+        mean=sum/n;
+        ss=0;
+        cov=0;
+        for (j=m->start;j<nstep;j++) {
+            ss=ss+(Sim[j]-mean)*(Sim[j]-mean);
+            cov=cov+(Sim[j]-mean)*(Obs[j]-m->obsmean);
+        }
+        r=cov/sqrt(ss*m->obsss);
+        alpha=sqrt(ss/n)/m->obssd;
+        beta=mean/m->obsmean;
+        return 1-sqrt((r-1)*(r-1)+(alpha-1)*(alpha-1)+(beta-1)*(beta-1));
+    case PBIAS:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            sum=sum+Sim[j];
+        return 100*(sum-m->obssum)/m->obssum;
+    case FDC:
+        if (*sortedstart!=m->start) {
+            memcpy(sorted,Sim+m->start,n*sizeof(double));
+            qsort(sorted,n,sizeof(double),CompareDescending);
+            *sortedstart=m->start;
+        }
+        sum2=0;
+        for (j=m->bandlo;j<m->bandhi;j++)
+            sum2=sum2+sorted[j];
+        return 100*(sum2-m->obssum)/m->obssum;
+    case PEAK:
+        max=Sim[m->start];
+        for (j=m->start;j<nstep;j++)
+            if (Sim[j]>max) max=Sim[j];
+        return 100*(max-m->obssum)/m->obssum;
+    case VOLUME:
+        sum=0;
+        for (j=m->start;j<nstep;j++)
+            if (Obs[j]>=m->threshold)
+                sum=sum+Sim[j];
+        return sum;
+    }
+    return NAN;
+}
+
+int main(int argc, char* argv[])
+{
+    char *obsfile=OBSFILE,*storefile=NULL;
+    int warmup=WARMUP;
+    int opt,i;
+    long k,nmissing=0;
+    double *sorted;
+    FILE *fp;
+
+    while ((opt=getopt(argc,argv,"o:d:s:n:w:"))!=-1) {
+        switch (opt) {
+        case 'o': obsfile=optarg; break;
+        case 'd': outputdir=optarg; break;
+        case 's': storefile=optarg; break;
+        case 'n': nsample=atol(optarg); break;
+        case 'w': warmup=atoi(optarg); break;
+        default: nmetric=-1; break;
+        }
+    }
+    for (i=optind;i<argc && nmetric>=0;i++)
+        ParseMetric(argv[i],warmup);
+    if (nmetric<=0) {
+        fprintf(stderr,"\nUsage: ./objective [-o obsfile] [-d outputdir] [-s ensemble_store] [-n nsample] [-w warmup] metric=file ...\n");
+        fprintf(stderr,"metrics: nse lognse kge pbias fdc:LO:HI peak volume:T, each optionally @start\n\n");
+        exit(EXIT_FAILURE);
+    }
+
+    LoadInput(obsfile);
+    if (storefile!=NULL)
+        OpenStore(storefile);
+    if (nsample<0)
+        nsample=Store!=NULL ? StoreRows : CountOutputFiles();
+    if (nsample==0) {
+        printf("no simulations found.\n");
+        exit(1);
+    }
+
+    sorted=(double *)malloc(nstep*sizeof(double));
+    for (i=0;i<nmetric;i++)
+        PrepareMetric(&metric[i],sorted);
+    free(sorted);
+
+    #pragma omp parallel reduction(+:nmissing)
+    {
+        double *Sim=(double *)malloc(nstep*sizeof(double));
+        double *sorted=(double *)malloc(nstep*sizeof(double));
+        char *line=NULL;
+        size_t len=0;
+        int m,sortedstart,ok;
+
+        #pragma omp for schedule(dynamic,16)
+        for (k=0;k<nsample;k++) {
+            ok=Store!=NULL ? LoadOutputStore(k,Sim) : LoadOutput(k,Sim,&line,&len);
+            sortedstart=-1;
+            for (m=0;m<nmetric;m++)
+                metric[m].value[k]=ok ? Evaluate(&metric[m],Sim,sorted,&sortedstart) : NAN;
+            if (!ok)
+                nmissing++;
+        }
+        free(Sim);
+        free(sorted);
+        free(line);
+    }
+    if (nmissing>0)
+        fprintf(stderr,"%ld of %ld samples have no complete simulation, their objectives are nan.\n",nmissing,nsample);
+
+    for (i=0;i<nmetric;i++) {
+        fp=fopen(metric[i].outfile,"w");
+        if (fp==NULL) {
+            printf("fail to open %s.\n",metric[i].outfile);
+            exit(1);
+        }
+        for (k=0;k<nsample;k++)
+            fprintf(fp,"%lf\n",metric[i].value[k]);
+        fclose(fp);
+    }
+    return 0;
+}
@@ -40,115 +40,74 @@
    WORK IN PROGRESS:
    Calculate slope based on Ice and Snow on top of topography.
    Transfer Cold Content of Snowpack with Mass.
+
+   The snow surface slopes and directions go into Work, which is allocated
+   once per run and shared with RouteSubSurface().
  *****************************************************************************/
 void Avalanche(MAPSIZE *Map, TOPOPIX **TopoMap, TIMESTRUCT *Time, OPTIONSTRUCT *Options,
-  SNOWPIX **Snow)
+  SNOWPIX **Snow, ROUTEWORK *Work)
 {
 
   float Shd;                     /*Snow Holding Depth of a cell(m) as a function slope*/
-  unsigned char ***SubDir;       /* Fraction of flux moving in each direction*/
-  unsigned int **SubTotalDir;    /* Sum of Dir array */
-  float **slope_deg;             /* Surface Slope in Degrees */
-  float **SubSnowGrad;           /* Snow Surface Slope*/
-  const char *Routine = "Avalanche";
+  const unsigned char *SubDir;   /* Fraction of flux moving in each direction*/
+  float slope_deg;               /* Surface Slope in Degrees */
+  int c;                         /* basin cell counter */
   int x;                         /* counter */
   int y;                         /* counter */
-  int i, j, k;
+  int i, k;
   float Snowout;
 
-  /*****************************************************************************
-     Allocate memory
-    ****************************************************************************/
-  if (!(SubSnowGrad = (float **)calloc(Map->NY, sizeof(float *))))
-    ReportError((char *)Routine, 1);
-  for (i = 0; i < Map->NY; i++) {
-    if (!(SubSnowGrad[i] = (float *)calloc(Map->NX, sizeof(float))))
-      ReportError((char *)Routine, 1);
-  }
-  if (!(slope_deg = (float **)calloc(Map->NY, sizeof(float *))))
-    ReportError((char *)Routine, 1);
-  for (i = 0; i < Map->NY; i++) {
-    if (!(slope_deg[i] = (float *)calloc(Map->NX, sizeof(float))))
-      ReportError((char *)Routine, 1);
-  }
-  if (!((SubDir) = (unsigned char ***)calloc(Map->NY, sizeof(unsigned char **))))
-    ReportError((char *)Routine, 1);
-  for (i = 0; i < Map->NY; i++) {
-    if (!((SubDir)[i] = (unsigned char **)calloc(Map->NX, sizeof(unsigned char*))))
-      ReportError((char *)Routine, 1);
-    for (j = 0; j < Map->NX; j++) {
-      if (!(SubDir[i][j] = (unsigned char *)calloc(NDIRS, sizeof(unsigned char))))
-        ReportError((char *)Routine, 1);
-    }
-  }
-  if (!(SubTotalDir = (unsigned int **)calloc(Map->NY, sizeof(unsigned int *))))
-    ReportError((char *)Routine, 1);
-  for (i = 0; i < Map->NY; i++) {
-    if (!(SubTotalDir[i] = (unsigned int *)calloc(Map->NX, sizeof(unsigned int))))
-      ReportError((char *)Routine, 1);
-  }
+  /* calculate snow surface slope in the same approach as subflow direction;
+     Work->FlowGrad holds the snow surface slope */
+  SnowSlopeAspect(Map, TopoMap, Snow, Work->FlowGrad, Work->Dir, Work->TotalDir);
 
-  /* calculate snow surface slope in the same approach as subflow direction */
-  SnowSlopeAspect(Map, TopoMap, Snow, SubSnowGrad, SubDir, SubTotalDir);
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    i = Map->BasinCell[c];
+    SubDir = &(Work->Dir[i * NDIRS]);
 
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-        /* convert slope from radian to degree */
-        slope_deg[y][x] = atan(SubSnowGrad[y][x])*(180 / PI);
+    /* convert slope from radian to degree */
+    slope_deg = atan(Work->FlowGrad[i])*(180 / PI);
 
-        /* snow holding depth as a function of slope and slide parameters */
-        Shd = SNOWSLIDE1*exp(-slope_deg[y][x] * SNOWSLIDE2);
+    /* snow holding depth as a function of slope and slide parameters */
+    Shd = SNOWSLIDE1*exp(-slope_deg * SNOWSLIDE2);
 
-        /* only redistribute snow if Swq is above holding capacity */
-        if (slope_deg[y][x] > 30. && Snow[y][x].Swq > Shd) {
+    /* only redistribute snow if Swq is above holding capacity */
+    if (slope_deg > 30. && Snow[y][x].Swq > Shd) {
 
-          /*If avalanche occurs on glacier surface, Leave a 10mm of snow behind so that glacier 
-          surface is not prematurely exposed */
-          /* if (Snow[y][x].Iwq > 1.0) {
-            Snowout = Snow[y][x].Swq - 0.01;
-            Snow[y][x].Swq = 0.01;
-          } */
+      /*If avalanche occurs on glacier surface, Leave a 10mm of snow behind so that glacier 
+      surface is not prematurely exposed */
+      /* if (Snow[y][x].Iwq > 1.0) {
+        Snowout = Snow[y][x].Swq - 0.01;
+        Snow[y][x].Swq = 0.01;
+      } */
           
-          Snowout = Snow[y][x].Swq;
-          Snow[y][x].Swq = 0.0;
+      Snowout = Snow[y][x].Swq;
+      Snow[y][x].Swq = 0.0;
           
 
-          Snow[y][x].TSurf = 0.0;
-          Snow[y][x].TPack = 0.0;
-          Snow[y][x].PackWater = 0.0;
-          Snow[y][x].SurfWater = 0.0;
+      Snow[y][x].TSurf = 0.0;
+      Snow[y][x].TPack = 0.0;
+      Snow[y][x].PackWater = 0.0;
+      Snow[y][x].SurfWater = 0.0;
           
-          /* Assign the avalanched snow to appropriate surrounding pixels */
-          if (SubTotalDir[y][x] > 0) {
-            Snowout /= (float)SubTotalDir[y][x];
+      /* Assign the avalanched snow to appropriate surrounding pixels */
+      if (Work->TotalDir[i] > 0) {
+        Snowout /= (float)Work->TotalDir[i];
 
-          }
-          else {
-            Snowout = 0.0;
-            Snow[y][x].Swq = Snowout;
-          }
-          for (k = 0; k < NDIRS; k++) {
-            int nx = xdirection[k] + x;
-            int ny = ydirection[k] + y;
-            if (valid_cell(Map, nx, ny)) {
-              Snow[ny][nx].Swq += Snowout * SubDir[y][x][k];
-            }
-          }
+      }
+      else {
+        Snowout = 0.0;
+        Snow[y][x].Swq = Snowout;
+      }
+      for (k = 0; k < NDIRS; k++) {
+        int nx = xdirection[k] + x;
+        int ny = ydirection[k] + y;
+        if (valid_cell(Map, nx, ny)) {
+          Snow[ny][nx].Swq += Snowout * SubDir[k];
         }
       }
     }
   }
-  for (i = 0; i < Map->NY; i++) {
-    free(SubTotalDir[i]);
-    free(slope_deg[i]);
-    free(SubSnowGrad[i]);
-    for (j = 0; j < Map->NX; j++)
-      free(SubDir[i][j]);
-    free(SubDir[i]);
-  }
-  free(SubDir);
-  free(SubTotalDir);
-  free(slope_deg);
-  free(SubSnowGrad);
 }
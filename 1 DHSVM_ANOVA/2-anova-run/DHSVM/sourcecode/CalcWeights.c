@@ -11,7 +11,13 @@
  *               stations is variable.
  * DESCRIP-END.
  * FUNCTIONS:    CalcWeights()
- * COMMENTS:
+ * COMMENTS:     The weights are stored sparse: only the nonzero weights of
+ *               each pixel, see METWEIGHTS in data.h.  The NEAREST and
+ *               VARCRESS schemes take the closest stations from a bucket
+ *               index (see StationIndex.c) and do the rows of the map in
+ *               parallel when DHSVM is built with OpenMP.  The GRIDCELL and
+ *               BILINEAR schemes take the grid points of gridded met input
+ *               around a pixel (see MetLattice.c).
  * $Id: CalcWeights.c,v 1.5 2003/10/28 20:02:41 colleen Exp $
  */
 
@@ -24,6 +30,30 @@
 #include "data.h"
 #include "DHSVMerror.h"
 #include "functions.h"
+#include "stationindex.h"
+
+/* work space of one thread for NearestWeights() */
+typedef struct {
+  STATIONDISTANCE *Nearest;	/* Closest stations */
+  double *InvDist2;		/* Cressman weight of the closest stations */
+  double *Distance;		/* Distances to all stations */
+  int *Order;			/* Stations after the first pass of the sort */
+  int *Queue;			/* Tied stations in sorted order */
+} WEIGHTSCRATCH;
+
+static int NearestWeights(METLOCATION *Station, int NStats,
+			  STATIONINDEX *Index, COORD *Loc,
+			  OPTIONSTRUCT *Options, int crstat,
+			  WEIGHTSCRATCH *Scratch, METWEIGHT *CellWeights);
+static void BreakTies(METLOCATION *Station, int NStats, COORD *Loc,
+		      int crstat, STATIONDISTANCE *Nearest,
+		      WEIGHTSCRATCH *Scratch);
+static int GridWeights(GRID *Grid, OPTIONSTRUCT *Options, double Row,
+		       double Col, METWEIGHT *CellWeights);
+static int CompareStation(const void *A, const void *B);
+static void StoreCellWeights(METWEIGHTS *MetWeights, int Cell,
+			     METWEIGHT *CellWeights, int NCellWeights,
+			     size_t *Capacity);
 
  /*****************************************************************************
    Function name: CalcWeights()
@@ -38,62 +68,79 @@
      int NX               - Number of pixels in East - West direction
      int NY               - Number of pixels in North - South direction
      uchar ** BasinMask   - BasinMask
-     uchar ***WeightArray - 3D array with interpolation weights
+     METWEIGHTS *MetWeights - Interpolation weights
+     GRID *Grid           - Grid of gridded met input, for GRIDCELL and
+                            BILINEAR
 
    Returns      :  void
 
    Modifies     :
-     The values stored at the addresses pointed to by WeightArray (i.e. it
-     calculates the weights and stores them)
-
-   Comments     :
+     MetWeights (i.e. it calculates the weights and stores the nonzero ones)
+
+   Comments     : The weights of a pixel are first calculated in CellWeights,
+                  and then only the nonzero ones are kept, in station order.
+                  NEAREST and VARCRESS give the same weights as a search
+                  through all stations would.  GRIDCELL and BILINEAR give a
+                  pixel the nearest station if none of its grid points has
+                  a station.
  *****************************************************************************/
 void CalcWeights(METLOCATION * Station, int NStats, int NX, int NY,
-  uchar ** BasinMask, uchar **** WeightArray,
+  uchar ** BasinMask, METWEIGHTS * MetWeights, GRID * Grid,
   OPTIONSTRUCT * Options)
 {
-  double *Weights;		/* Array with weights for all stations */
+  METWEIGHT *CellWeights;	/* Weights of the current pixel for all stations */
+  METWEIGHT *Slots;		/* Weights of the closest stations of each pixel */
+  int *NSlots;			/* Number of weights in Slots of each pixel */
+  size_t Capacity;		/* Number of weights allocated */
+  size_t k;			/* Counter for weights */
   double *Distance;		/* Array with distances to all stations */
   double *InvDist2;		/* Array with inverse distance squared */
   double Denominator;		/* Sum of 1/Distance^2 */
-  double mindistance;
-  double avgdistance;
-  double tempdistance;
-  double cr, crt;
+  double cr;
   int totalweight;
   int y;			/* Counter for rows */
   int x;			/* Counter for columns */
-  int i, j;			/* Counter for stations */
+  int i;			/* Counter for stations */
   int CurrentStation;		/* Station at current location (if any) */
   int *stationid;		/* index array for sorted list of station distances */
   int *stat;
   int tempid;
-  int closest;
   int crstat;
   COORD Loc;			/* Location of current point */
-
-  /* Allocate memory for a 3 dimensional array */
+  STATIONINDEX Index;		/* Buckets of stations */
+  WEIGHTSCRATCH Scratch;
+  STATIONDISTANCE *Nearest;	/* Nearest station, for GRIDCELL and BILINEAR */
+  METWEIGHT GridCell[4];	/* Weights of the grid points of a pixel */
+  int NGridCell;		/* Number of weights in GridCell */
+  int NOffGrid;			/* Pixels that take the nearest station */
+  double Row;			/* Latitude index of a pixel in the met grid */
+  double Col;			/* Longitude index of a pixel in the met grid */
+
+  /* Allocate memory for the sparse weights, starting with room for one
+     station per pixel */
 
   if (DEBUG)
     printf("Calculating interpolation weights for %d stations\n", NStats);
 
-  if (!((*WeightArray) = (uchar ***)calloc(NY, sizeof(uchar **))))
-    ReportError("CalcWeights()", 1);
+  MetWeights->NY = NY;
+  MetWeights->NX = NX;
+  MetWeights->NWeights = 0;
+  Capacity = (size_t) NY * NX;
 
-  for (y = 0; y < NY; y++)
-    if (!((*WeightArray)[y] = (uchar **)calloc(NX, sizeof(uchar *))))
-      ReportError("CalcWeights()", 1);
+  if (!(MetWeights->Start = (size_t *)calloc((size_t) NY * NX + 1,
+                                             sizeof(size_t))))
+    ReportError("CalcWeights()", 1);
 
-  for (y = 0; y < NY; y++)
-    for (x = 0; x < NX; x++)
-      if (!((*WeightArray)[y][x] = (uchar *)calloc(NStats, sizeof(uchar))))
-        ReportError("CalcWeights()", 1);
+  if (!(MetWeights->Weight = (METWEIGHT *)calloc(Capacity, sizeof(METWEIGHT))))
+    ReportError("CalcWeights()", 1);
 
   /* Allocate memory for the array that will contain weights, and the array for
      the distances to each of the towers, and the inverse distance squared */
 
-  if (!(Weights = (double *) calloc(NStats, sizeof(double))))
+  if (!(CellWeights = (METWEIGHT *) calloc(NStats, sizeof(METWEIGHT))))
     ReportError("CalcWeights()", 1);
+  for (i = 0; i < NStats; i++)
+    CellWeights[i].Station = i;
 
   if (!(Distance = (double *)calloc(NStats, sizeof(double))))
     ReportError("CalcWeights()", 1);
@@ -120,9 +167,9 @@ void CalcWeights(METLOCATION * Station, int NStats, int NX, int NY,
           if (IsStationLocation(&Loc, NStats, Station, &CurrentStation)) {
             for (i = 0; i < NStats; i++) {
               if (i == CurrentStation)
-                (*WeightArray)[y][x][i] = MAXUCHAR;
+                CellWeights[i].Weight = MAXUCHAR;
               else
-                (*WeightArray)[y][x][i] = 0;
+                CellWeights[i].Weight = 0;
             }
           }
           else {
@@ -132,118 +179,148 @@ void CalcWeights(METLOCATION * Station, int NStats, int NX, int NY,
               Denominator += InvDist2[i];
             }
             for (i = 0; i < NStats; i++) {
-              (*WeightArray)[y][x][i] =
+              CellWeights[i].Weight =
                 (uchar)Round(InvDist2[i] / Denominator * MAXUCHAR);
             }
           }
-        }
-        else {
-          for (i = 0; i < NStats; i++)
-            (*WeightArray)[y][x][i] = 0;
+          StoreCellWeights(MetWeights, y * NX + x, CellWeights, NStats,
+                           &Capacity);
         }
       }
     }
   }
-  if (Options->Interpolation == NEAREST) {
+  if (Options->Interpolation == NEAREST ||
+      Options->Interpolation == VARCRESS) {
 
-    /* this next scheme is a nearest station */
-    printf("Number of stations is %d \n", NStats);
+    if (Options->Interpolation == NEAREST) {
+      /* this next scheme is a nearest station */
+      printf("Number of stations is %d \n", NStats);
+      crstat = 1;
+    }
+    else {
+      /* this next scheme is a variable radius cressman */
+      /* find the distance to the nearest station */
+      /* make a decision based on the maximum allowable radius, cr */
+      /* and the distance to the closest station */
+      /* while limiting the number of interpolation stations to three */
+      cr = (double)Options->CressRadius;
+      if (cr < 2)
+        ReportError("CalcWeights.c", 42);
+      crstat = Options->CressStations;
+      if (crstat < 2)
+        ReportError("CalcWeights.c", 42);
+    }
 
-    for (y = 0; y < NY; y++) {
-      Loc.N = y;
-      for (x = 0; x < NX; x++) {
-        Loc.E = x;
-        if (INBASIN(BasinMask[y][x])) {	/*we are inside the basin mask */
-          /* find the distance to nearest station */
-          mindistance = DHSVM_HUGE;
-          avgdistance = 0.0;
-          for (i = 0; i < NStats; i++) {
-            Distance[i] = CalcDistance(&(Station[i].Loc), &Loc);
-            avgdistance += Distance[i] / ((double)NStats);
-            if (Distance[i] < mindistance) {
-              mindistance = Distance[i];
-              closest = i;
-            }
-          }
-          /* got closest station */
+    /* the pixels only use their crstat closest stations, so they are done
+       independently, each into crstat slots, and stored in order after */
+    InitStationIndex(Station, NStats, &Index);
 
-          for (i = 0; i < NStats; i++) {
-            if (i == closest)
-              (*WeightArray)[y][x][i] = MAXUCHAR;
-            else
-              (*WeightArray)[y][x][i] = 0;
-          }
+    if (!(Slots = (METWEIGHT *)calloc((size_t) NY * NX * crstat,
+                                      sizeof(METWEIGHT))))
+      ReportError("CalcWeights()", 1);
+    if (!(NSlots = (int *)calloc((size_t) NY * NX, sizeof(int))))
+      ReportError("CalcWeights()", 1);
 
-        }			/* done in basin mask */
-        else {
-          for (i = 0; i < NStats; i++)
-            (*WeightArray)[y][x][i] = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(Options->Threads) private(y, x, Loc, Scratch)
+#endif
+    {
+      if (!(Scratch.Nearest =
+            (STATIONDISTANCE *)calloc(NStats, sizeof(STATIONDISTANCE))))
+        ReportError("CalcWeights()", 1);
+      if (!(Scratch.InvDist2 = (double *)calloc(crstat, sizeof(double))))
+        ReportError("CalcWeights()", 1);
+      if (!(Scratch.Distance = (double *)calloc(NStats, sizeof(double))))
+        ReportError("CalcWeights()", 1);
+      if (!(Scratch.Order = (int *)calloc(NStats, sizeof(int))))
+        ReportError("CalcWeights()", 1);
+      if (!(Scratch.Queue = (int *)calloc(2 * NStats, sizeof(int))))
+        ReportError("CalcWeights()", 1);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (y = 0; y < NY; y++) {
+        Loc.N = y;
+        for (x = 0; x < NX; x++) {
+          Loc.E = x;
+          if (INBASIN(BasinMask[y][x]))	/*we are inside the basin mask */
+            NSlots[y * NX + x] =
+              NearestWeights(Station, NStats, &Index, &Loc, Options, crstat,
+                             &Scratch, &(Slots[((size_t) y * NX + x) * crstat]));
         }
       }
+
+      free(Scratch.Nearest);
+      free(Scratch.InvDist2);
+      free(Scratch.Distance);
+      free(Scratch.Order);
+      free(Scratch.Queue);
     }
+
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        if (INBASIN(BasinMask[y][x]))
+          StoreCellWeights(MetWeights, y * NX + x,
+                           &(Slots[((size_t) y * NX + x) * crstat]),
+                           NSlots[y * NX + x], &Capacity);
+
+    free(Slots);
+    free(NSlots);
+    FreeStationIndex(&Index);
   }
+  if (Options->Interpolation == GRIDCELL ||
+      Options->Interpolation == BILINEAR) {
+
+    /* this next scheme takes the grid points of gridded met input, the one
+       of the grid cell that the pixel is in, or the four around the pixel
+       weighted bilinear.  Grid points without a station are left out. */
+    InitStationIndex(Station, NStats, &Index);
+    if (!(Nearest = (STATIONDISTANCE *)calloc(NStats, sizeof(STATIONDISTANCE))))
+      ReportError("CalcWeights()", 1);
 
-  if (Options->Interpolation == VARCRESS) {
-
-    /* this next scheme is a variable radius cressman */
-    /* find the distance to the nearest station */
-    /* make a decision based on the maximum allowable radius, cr */
-    /* and the distance to the closest station */
-    /* while limiting the number of interpolation stations to three */
-    cr = (double)Options->CressRadius;
-    if (cr < 2)
-      ReportError("CalcWeights.c", 42);
-    crstat = Options->CressStations;
-    if (crstat < 2)
-      ReportError("CalcWeights.c", 42);
+    /* the position of the first pixel is searched from the middle of the
+       grid, and of the others from the pixel before them */
+    Row = 0.5 * (Grid->NLat - 1);
+    Col = 0.5 * (Grid->NLon - 1);
+    NOffGrid = 0;
     for (y = 0; y < NY; y++) {
       Loc.N = y;
       for (x = 0; x < NX; x++) {
         Loc.E = x;
-        if (INBASIN(BasinMask[y][x])) {	/*we are inside the basin mask */
-          /* find the distance to nearest station */
-          for (i = 0; i < NStats; i++) {
-            Distance[i] = CalcDistance(&(Station[i].Loc), &Loc);
-            stationid[i] = i;
-          }
-          /* got distances for each station */
-          /* now sort the list by distance */
-          for (i = 0; i < NStats; i++) {
-            for (j = 0; j < NStats; j++) {
-              if (Distance[j] > Distance[i]) {
-                tempdistance = Distance[i];
-                tempid = stationid[i];
-                Distance[i] = Distance[j];
-                stationid[i] = stationid[j];
-                Distance[j] = tempdistance;
-                stationid[j] = tempid;
-              }
-            }
-          }
-
-          crt = Distance[0] * 2.0;
-          if (crt < 1.0)
-            crt = 1.0;
-          for (i = 0, Denominator = 0; i < NStats; i++) {
-            if (i < crstat && Distance[i] < crt) {
-              InvDist2[i] =
-                (crt * crt - Distance[i] * Distance[i]) /
-                (crt * crt + Distance[i] * Distance[i]);
-              Denominator += InvDist2[i];
-            }
-            else
-              InvDist2[i] = 0.0;
+        if (INBASIN(BasinMask[y][x])) {
+          MetLatticePosition(Grid, (double) y, (double) x, &Row, &Col);
+          NGridCell = GridWeights(Grid, Options, Row, Col, GridCell);
+          if (NGridCell == 0) {
+            FindNearestStations(&Index, Station, &Loc, 1, Nearest);
+            GridCell[0].Station = Nearest[0].Station;
+            GridCell[0].Weight = MAXUCHAR;
+            NGridCell = 1;
+            NOffGrid++;
           }
-
-          for (i = 0; i < NStats; i++)
-            (*WeightArray)[y][x][stationid[i]] =
-            (uchar)Round(InvDist2[i] / Denominator * MAXUCHAR);
-
-          /*at this point all weights have been assigned to one or more stations */
-
+          StoreCellWeights(MetWeights, y * NX + x, GridCell, NGridCell,
+                           &Capacity);
         }
       }
     }
+    if (NOffGrid > 0)
+      printf("%d pixels have no met grid point with a station around them "
+             "and take the nearest station\n", NOffGrid);
+
+    free(Nearest);
+    FreeStationIndex(&Index);
+  }
+
+  /* pixels outside the basin mask have no weights, so they start where the
+     pixel before them starts */
+  for (i = 0; i < NY * NX; i++)
+    if (MetWeights->Start[i + 1] < MetWeights->Start[i])
+      MetWeights->Start[i + 1] = MetWeights->Start[i];
+
+  if (MetWeights->NWeights > 0 && MetWeights->NWeights < Capacity) {
+    if (!(MetWeights->Weight = (METWEIGHT *)realloc(MetWeights->Weight,
+      MetWeights->NWeights * sizeof(METWEIGHT))))
+      ReportError("CalcWeights()", 1);
   }
 
   /*check that all weights add up to MAXUCHAR */
@@ -265,12 +342,11 @@ void CalcWeights(METLOCATION * Station, int NStats, int NX, int NY,
         tempid = 0;
         totalweight = 0;
 
-        for (i = 0; i < NStats; i++) {
-          totalweight += (int)(*WeightArray)[y][x][i];
-          if ((*WeightArray)[y][x][i] > 0) {
-            tempid += 1;
-            stationid[i] = 1;
-          }
+        for (k = MetWeights->Start[y * NX + x];
+             k < MetWeights->Start[y * NX + x + 1]; k++) {
+          totalweight += (int)MetWeights->Weight[k].Weight;
+          tempid += 1;
+          stationid[MetWeights->Weight[k].Station] = 1;
         }
 
         if (totalweight < 250 || totalweight > 260)
@@ -293,9 +369,246 @@ void CalcWeights(METLOCATION * Station, int NStats, int NX, int NY,
   */
   /* Free memory */
 
-  free(Weights);
+  free(CellWeights);
   free(Distance);
   free(InvDist2);
   free(stationid);
   free(stat);
 }
+
+/*****************************************************************************
+  NearestWeights()
+
+  Weights of a pixel for the NEAREST and VARCRESS schemes.  The closest
+  stations come sorted by distance, so the nearest station is the first one
+  and the cressman stations are the first crstat ones.  Returns the number
+  of weights in CellWeights, by station.
+*****************************************************************************/
+static int NearestWeights(METLOCATION *Station, int NStats,
+			  STATIONINDEX *Index, COORD *Loc,
+			  OPTIONSTRUCT *Options, int crstat,
+			  WEIGHTSCRATCH *Scratch, METWEIGHT *CellWeights)
+{
+  STATIONDISTANCE *Nearest = Scratch->Nearest;
+  double *InvDist2 = Scratch->InvDist2;
+  double Denominator;
+  double crt;
+  int NNearest;
+  int i;
+
+  NNearest = FindNearestStations(Index, Station, Loc, crstat, Nearest);
+
+  /* the first of the closest stations, as the lowest index wins a tie */
+  if (Options->Interpolation == NEAREST) {
+    CellWeights[0].Station = Nearest[0].Station;
+    CellWeights[0].Weight = MAXUCHAR;
+    return 1;
+  }
+
+  crt = Nearest[0].Distance * 2.0;
+  if (crt < 1.0)
+    crt = 1.0;
+  if (NNearest > crstat) {
+    if (Nearest[crstat - 1].Distance < crt)
+      BreakTies(Station, NStats, Loc, crstat, Nearest, Scratch);
+    NNearest = crstat;
+  }
+
+  for (i = 0, Denominator = 0; i < NNearest; i++) {
+    if (Nearest[i].Distance < crt) {
+      InvDist2[i] =
+        (crt * crt - Nearest[i].Distance * Nearest[i].Distance) /
+        (crt * crt + Nearest[i].Distance * Nearest[i].Distance);
+      Denominator += InvDist2[i];
+    }
+    else
+      InvDist2[i] = 0.0;
+  }
+
+  for (i = 0; i < NNearest; i++) {
+    CellWeights[i].Station = Nearest[i].Station;
+    CellWeights[i].Weight =
+      (uchar)Round(InvDist2[i] / Denominator * MAXUCHAR);
+  }
+  qsort(CellWeights, NNearest, sizeof(METWEIGHT), CompareStation);
+
+  return NNearest;
+}
+
+/*****************************************************************************
+  BreakTies()
+
+  Choose among the stations that tie for the last of the crstat places.
+  VARCRESS used to sort the distances to all stations with an exchange sort
+  that does not keep tied stations in order, so the stations it kept depend
+  on all distances.  The sort first moves each running maximum to the place
+  of the next one and the last to the front, then inserts the stations one
+  by one behind the closer ones.  A tied station is inserted behind the
+  tied stations already there, and a closer station moves the first of them
+  to the back.  This is replayed for the tied stations only, and the ones
+  that end in the first crstat places are put in Nearest.
+*****************************************************************************/
+static void BreakTies(METLOCATION *Station, int NStats, COORD *Loc,
+		      int crstat, STATIONDISTANCE *Nearest,
+		      WEIGHTSCRATCH *Scratch)
+{
+  double *Distance = Scratch->Distance;
+  int *Order = Scratch->Order;
+  int *Queue = Scratch->Queue;
+  double Tie;			/* Distance of the tied stations */
+  int First;			/* First place of a tied station */
+  int Head;
+  int Tail;
+  int Last;
+  int i;
+
+  Tie = Nearest[crstat - 1].Distance;
+  for (i = 0; i < NStats; i++) {
+    Distance[i] = CalcDistance(&(Station[i].Loc), Loc);
+    Order[i] = i;
+  }
+
+  Last = 0;
+  for (i = 1; i < NStats; i++)
+    if (Distance[i] > Distance[Last]) {
+      Order[i] = Last;
+      Last = i;
+    }
+  Order[0] = Last;
+
+  Head = Tail = 0;
+  for (i = 0; i < NStats; i++) {
+    if (Distance[Order[i]] == Tie)
+      Queue[Tail++] = Order[i];
+    else if (Distance[Order[i]] < Tie && Tail - Head > 1)
+      Queue[Tail++] = Queue[Head++];
+  }
+
+  for (First = crstat - 1; First > 0 && Nearest[First - 1].Distance == Tie;
+       First--)
+    ;
+  for (i = First; i < crstat; i++)
+    Nearest[i].Station = Queue[Head + i - First];
+}
+
+/*****************************************************************************
+  GridWeights()
+
+  Weights of a pixel for the GRIDCELL and BILINEAR schemes, from its
+  position in the met grid.  Outside the grid the pixel takes the edge.
+  Returns the number of weights in CellWeights, by station, or 0 if none of
+  the grid points has a station.
+*****************************************************************************/
+static int GridWeights(GRID *Grid, OPTIONSTRUCT *Options, double Row,
+		       double Col, METWEIGHT *CellWeights)
+{
+  double Fraction[4];		/* Bilinear weight of the grid points */
+  double Total;
+  double u;
+  double v;
+  int Corner[4];		/* Station at the grid points */
+  int NCorners;
+  int r;
+  int c;
+  int k;
+  int i;
+
+  if (Options->Interpolation == GRIDCELL) {
+    r = Round(Row);
+    if (r > Grid->NLat - 1)
+      r = Grid->NLat - 1;
+    if (r < 0)
+      r = 0;
+    c = Round(Col);
+    if (c > Grid->NLon - 1)
+      c = Grid->NLon - 1;
+    if (c < 0)
+      c = 0;
+    if (Grid->Node[r * Grid->NLon + c] < 0)
+      return 0;
+    CellWeights[0].Station = Grid->Node[r * Grid->NLon + c];
+    CellWeights[0].Weight = MAXUCHAR;
+    return 1;
+  }
+
+  r = (int) floor(Row);
+  if (r > Grid->NLat - 2)
+    r = Grid->NLat - 2;
+  if (r < 0)
+    r = 0;
+  c = (int) floor(Col);
+  if (c > Grid->NLon - 2)
+    c = Grid->NLon - 2;
+  if (c < 0)
+    c = 0;
+  u = Row - r;
+  u = (u < 0.0) ? 0.0 : ((u > 1.0) ? 1.0 : u);
+  v = Col - c;
+  v = (v < 0.0) ? 0.0 : ((v > 1.0) ? 1.0 : v);
+
+  k = r * Grid->NLon + c;
+  Corner[0] = Grid->Node[k];
+  Fraction[0] = (1 - u) * (1 - v);
+  Corner[1] = Grid->Node[k + 1];
+  Fraction[1] = (1 - u) * v;
+  Corner[2] = Grid->Node[k + Grid->NLon];
+  Fraction[2] = u * (1 - v);
+  Corner[3] = Grid->Node[k + Grid->NLon + 1];
+  Fraction[3] = u * v;
+
+  for (i = 0, Total = 0.0; i < 4; i++)
+    if (Corner[i] >= 0)
+      Total += Fraction[i];
+  if (Total <= 0.0)
+    return 0;
+
+  for (i = 0, NCorners = 0; i < 4; i++) {
+    if (Corner[i] >= 0) {
+      CellWeights[NCorners].Station = Corner[i];
+      CellWeights[NCorners].Weight =
+        (uchar)Round(Fraction[i] / Total * MAXUCHAR);
+      NCorners++;
+    }
+  }
+  qsort(CellWeights, NCorners, sizeof(METWEIGHT), CompareStation);
+
+  return NCorners;
+}
+
+/*****************************************************************************
+  CompareStation()
+
+  Compare two METWEIGHT elements for qsort, by station
+*****************************************************************************/
+static int CompareStation(const void *A, const void *B)
+{
+  return ((const METWEIGHT *) A)->Station - ((const METWEIGHT *) B)->Station;
+}
+
+/*****************************************************************************
+  StoreCellWeights()
+
+  Append the nonzero weights of a pixel to MetWeights, growing it if needed,
+  and set the start of the next pixel.  The pixels must be stored in order.
+  The start of the pixels that are skipped is set in CalcWeights().
+*****************************************************************************/
+static void StoreCellWeights(METWEIGHTS *MetWeights, int Cell,
+			     METWEIGHT *CellWeights, int NCellWeights,
+			     size_t *Capacity)
+{
+  int i;
+
+  for (i = 0; i < NCellWeights; i++) {
+    if (CellWeights[i].Weight == 0)
+      continue;
+    if (MetWeights->NWeights == *Capacity) {
+      *Capacity *= 2;
+      if (!(MetWeights->Weight = (METWEIGHT *)realloc(MetWeights->Weight,
+        *Capacity * sizeof(METWEIGHT))))
+        ReportError("CalcWeights()", 1);
+    }
+    MetWeights->Weight[MetWeights->NWeights] = CellWeights[i];
+    MetWeights->NWeights++;
+  }
+  MetWeights->Start[Cell + 1] = MetWeights->NWeights;
+}
@@ -24,10 +24,11 @@
 #include "constants.h"
 
 void CheckOut(OPTIONSTRUCT *Options, LAYER Veg, LAYER Soil, VEGTABLE *VType, SOILTABLE *SType,
-  MAPSIZE *Map, TOPOPIX **TopoMap, VEGPIX **VegMap, SOILPIX **SoilMap)
+  MAPSIZE *Map, TOPOPIX **TopoMap, VEGPIX **VegMap, SOILPIX **SoilMap,
+  SOILCELLS *SoilCells)
 
 {
-  int y, x, i, j, k;
+  int c, y, x, i, j, k;
   int *count = NULL, *scount = NULL;
   float a, b, l, Taud, Taub20, Taub40, Taub60, Taub80;
 
@@ -133,17 +134,15 @@ void CheckOut(OPTIONSTRUCT *Options, LAYER Veg, LAYER Soil, VEGTABLE *VType, SOI
     }
   }
 
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-        if (SoilMap[y][x].Depth <= VType[VegMap[y][x].Veg - 1].TotalDepth) {
-          printf("Error for class %d of Type %s  \n", VegMap[y][x].Veg,
-            VType[VegMap[y][x].Veg - 1].Desc);
-          printf("%d %d Soil depth is %f, Root depth is %f \n", y, x, SoilMap[y][x].Depth,
-            VType[VegMap[y][x].Veg - 1].TotalDepth);
-          exit(-1);
-        }
-      }
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    if (SoilCells->Depth[c] <= VType[VegMap[y][x].Veg - 1].TotalDepth) {
+      printf("Error for class %d of Type %s  \n", VegMap[y][x].Veg,
+        VType[VegMap[y][x].Veg - 1].Desc);
+      printf("%d %d Soil depth is %f, Root depth is %f \n", y, x,
+        SoilCells->Depth[c], VType[VegMap[y][x].Veg - 1].TotalDepth);
+      exit(-1);
     }
   }
 
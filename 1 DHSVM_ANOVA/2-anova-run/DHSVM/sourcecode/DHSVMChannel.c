@@ -28,7 +28,7 @@
    -------------------------------------------------------------------------- */
 void
 InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
-	    SOILPIX ** SoilMap, int *MaxStreamID, int *MaxRoadID, OPTIONSTRUCT *Options)
+	    SOILCELLS *SoilCells, int *MaxStreamID, int *MaxRoadID, OPTIONSTRUCT *Options)
 {
   int i;
   STRINIENTRY StrEnv[] = {
@@ -64,8 +64,12 @@ InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
   channel->road_class = NULL;
   channel->streams = NULL;
   channel->roads = NULL;
+  channel->stream_route = NULL;
+  channel->road_route = NULL;
   channel->stream_map = NULL;
   channel->road_map = NULL;
+  channel->stream_lookup = NULL;
+  channel->road_lookup = NULL;
 
   channel_init();
   channel_grid_init(Map->NX, Map->NY);
@@ -85,12 +89,17 @@ InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
     }
     if ((channel->stream_map =
 	 channel_grid_read_map(channel->streams,
-			       StrEnv[stream_map].VarStr, SoilMap)) == NULL) {
+			       StrEnv[stream_map].VarStr, Map, SoilCells)) == NULL) {
       ReportError(StrEnv[stream_map].VarStr, 5);
     }
+    channel->stream_lookup = channel_grid_compile(channel->stream_map);
     error_handler(ERRHDL_STATUS,
 		  "InitChannel: computing stream network routing coefficients");
     channel_routing_parameters(channel->streams, (double) deltat);
+    if ((channel->stream_route =
+	 channel_order_network(channel->streams)) == NULL) {
+      ReportError("InitChannel", 1);
+    }
   }
 
   if (Options->StreamTemp) {
@@ -115,12 +124,17 @@ InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
     }
     if ((channel->road_map =
 	 channel_grid_read_map(channel->roads,
-			       StrEnv[road_map].VarStr, SoilMap)) == NULL) {
+			       StrEnv[road_map].VarStr, Map, SoilCells)) == NULL) {
       ReportError(StrEnv[road_map].VarStr, 5);
     }
+    channel->road_lookup = channel_grid_compile(channel->road_map);
     error_handler(ERRHDL_STATUS,
 		  "InitChannel: computing road network routing coefficients");
     channel_routing_parameters(channel->roads, (double) deltat);
+    if ((channel->road_route =
+	 channel_order_network(channel->roads)) == NULL) {
+      ReportError("InitChannel", 1);
+    }
   }
 }
 
@@ -128,48 +142,53 @@ InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
    InitChannelDump
    ------------------------------------------------------------- */
 void InitChannelDump(OPTIONSTRUCT *Options, CHANNEL * channel, 
-					 char *DumpPath, int RunNumber)
+					 char *DumpPath, char *EnsemblePath, TIMESTRUCT *Time,
+					 int RunNumber)
 {
   char buffer[NAMESIZE];
 
   if (channel->streams != NULL) {
     sprintf(buffer, "%sStream.Flow.[%d]", DumpPath, RunNumber);
-    OpenFile(&(channel->streamout), buffer, "w", TRUE);
+    OpenOutputFile(&(channel->streamout), buffer, "w");
     sprintf(buffer, "%sStreamflow.Only.[%d]", DumpPath, RunNumber);
-    OpenFile(&(channel->streamflowout), buffer, "w", TRUE);
+    OpenOutputFile(&(channel->streamflowout), buffer, "w");
+    /* optional binary store shared by all runs */
+    if (strncmp(EnsemblePath, "none", 4))
+      InitEnsembleStore(EnsemblePath, Time, channel->streams, RunNumber,
+			&(channel->ensemble));
     /* output files for John's RBM model */
 	if (Options->StreamTemp) {
       //inflow to segment
       sprintf(buffer, "%sInflow.Only", DumpPath);
-      OpenFile(&(channel->streaminflow), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streaminflow), buffer, "w");
       // outflow ( redundant but it's a check
       sprintf(buffer, "%sOutflow.Only", DumpPath);
-      OpenFile(&(channel->streamoutflow), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamoutflow), buffer, "w");
       //net incoming short wave
       sprintf(buffer, "%sNSW.Only", DumpPath);
-      OpenFile(&(channel->streamNSW), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamNSW), buffer, "w");
       // net incoming long wave
       sprintf(buffer, "%sNLW.Only", DumpPath);
-      OpenFile(&(channel->streamNLW), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamNLW), buffer, "w");
       //Vapor pressure
       sprintf(buffer, "%sVP.Only", DumpPath);
-      OpenFile(&(channel->streamVP), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamVP), buffer, "w");
       //wind speed
       sprintf(buffer, "%sWND.Only", DumpPath);
-      OpenFile(&(channel->streamWND), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamWND), buffer, "w");
       //air temperature
       sprintf(buffer, "%sATP.Only", DumpPath);
-      OpenFile(&(channel->streamATP), buffer, "w", TRUE);
+      OpenOutputFile(&(channel->streamATP), buffer, "w");
       //melt water in flow
       sprintf(buffer, "%sMelt.Only", DumpPath);
-      OpenFile(&(channel->streamMelt), buffer, "w", TRUE);                      
+      OpenOutputFile(&(channel->streamMelt), buffer, "w");                      
 	}
   }
   if (channel->roads != NULL) {
     sprintf(buffer, "%sRoad.Flow", DumpPath);
-    OpenFile(&(channel->roadout), buffer, "w", TRUE);
+    OpenOutputFile(&(channel->roadout), buffer, "w");
     sprintf(buffer, "%sRoadflow.Only", DumpPath);
-    OpenFile(&(channel->roadflowout), buffer, "w", TRUE);
+    OpenOutputFile(&(channel->roadflowout), buffer, "w");
 
   }
 }
@@ -182,8 +201,8 @@ void InitChannelDump(OPTIONSTRUCT *Options, CHANNEL * channel,
    ------------------------------------------------------------- */
 double ChannelCulvertFlow(int y, int x, CHANNEL * ChannelData)
 {
-  if (channel_grid_has_channel(ChannelData->road_map, x, y)) {
-    return channel_grid_outflow(ChannelData->road_map, x, y);
+  if (channel_lookup_has_channel(ChannelData->road_lookup, x, y)) {
+    return channel_lookup_outflow(ChannelData->road_lookup, x, y);
   }
   else {
     return 0;
@@ -209,10 +228,10 @@ RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
   for (y = 0; y < Map->NY; y++) {
     for (x = 0; x < Map->NX; x++) {
       if (INBASIN(TopoMap[y][x].Mask)) {
-        if (channel_grid_has_channel(ChannelData->road_map, x, y) && 
-          !channel_grid_has_sink(ChannelData->road_map, x, y)) {	/* road w/o sink */
+        if (channel_lookup_has_channel(ChannelData->road_lookup, x, y) && 
+          !channel_lookup_has_sink(ChannelData->road_lookup, x, y)) {	/* road w/o sink */
             SoilMap[y][x].RoadInt += SoilMap[y][x].IExcess; 
-          channel_grid_inc_inflow(ChannelData->road_map, x, y, SoilMap[y][x].IExcess * Map->DX * Map->DY);
+          channel_lookup_inc_inflow(ChannelData->road_lookup, x, y, SoilMap[y][x].IExcess * Map->DX * Map->DY);
           SoilMap[y][x].IExcess = 0.0f;
         }
       }
@@ -223,9 +242,10 @@ RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
   SPrintDate(&(Time->Current), buffer);
   flag = IsEqualTime(&(Time->Current), &(Time->Start));
   if (ChannelData->roads != NULL) {
-    channel_route_network(ChannelData->roads, Time->Dt);
+    channel_route_network(ChannelData->road_route, Time->Dt);
     channel_save_outflow_text(buffer, ChannelData->roads,
-			      ChannelData->roadout, ChannelData->roadflowout, flag);
+			      ChannelData->roadout, ChannelData->roadflowout,
+			      NULL, flag);
   }
   
   /* add culvert outflow to surface water */
@@ -237,15 +257,15 @@ RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
 		CulvertFlow /= Map->DX * Map->DY;
 		
 		/* CulvertFlow = (CulvertFlow > 0.0) ? CulvertFlow : 0.0; */
-		if (channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-		  channel_grid_inc_inflow(ChannelData->stream_map, x, y,
+		if (channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+		  channel_lookup_inc_inflow(ChannelData->stream_lookup, x, y,
 				  (SoilMap[y][x].IExcess + CulvertFlow) * Map->DX * Map->DY);
 
 		  if (SnowMap[y][x].Outflow > SoilMap[y][x].IExcess)
         temp = SoilMap[y][x].IExcess;
 		  else
         temp = SnowMap[y][x].Outflow;
-		  channel_grid_inc_melt(ChannelData->stream_map, x, y, temp * Map->DX * Map->DY);                                                                                  
+		  channel_lookup_inc_melt(ChannelData->stream_lookup, x, y, temp * Map->DX * Map->DY);                                                                                  
 		  SoilMap[y][x].ChannelInt += SoilMap[y][x].IExcess;
 		  Total->CulvertToChannel += CulvertFlow;
 		  SoilMap[y][x].IExcess = 0.0f;
@@ -259,10 +279,11 @@ RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
   }
   /* route stream channels */
   if (ChannelData->streams != NULL) {
-    channel_route_network(ChannelData->streams, Time->Dt);
+    channel_route_network(ChannelData->stream_route, Time->Dt);
     channel_save_outflow_text(buffer, ChannelData->streams,
 			      ChannelData->streamout,
-			      ChannelData->streamflowout, flag);
+			      ChannelData->streamflowout,
+			      EnsembleStep(ChannelData->ensemble, buffer), flag);
 	/* save parameters for John's RBM model */
 	if (Options->StreamTemp)
 	  channel_save_outflow_text_cplmt(Time, buffer,ChannelData->streams,ChannelData, flag);
@@ -280,15 +301,15 @@ void ChannelCut(int y, int x, CHANNEL * ChannelData, ROADSTRUCT * Network)
   float bank_height = 0.0;
   float cut_area = 0.0;
 
-  if (channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-    bank_height = channel_grid_cell_bankht(ChannelData->stream_map, x, y);
-    cut_area = channel_grid_cell_width(ChannelData->stream_map, x, y) * 
-      channel_grid_cell_length(ChannelData->stream_map, x, y);
+  if (channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+    bank_height = channel_lookup_cell_bankht(ChannelData->stream_lookup, x, y);
+    cut_area = channel_lookup_cell_width(ChannelData->stream_lookup, x, y) * 
+      channel_lookup_cell_length(ChannelData->stream_lookup, x, y);
   }
-  else if (channel_grid_has_channel(ChannelData->road_map, x, y)) {
-    bank_height = channel_grid_cell_bankht(ChannelData->road_map, x, y);
-    cut_area = channel_grid_cell_width(ChannelData->road_map, x, y) * 
-      channel_grid_cell_length(ChannelData->road_map, x, y);
+  else if (channel_lookup_has_channel(ChannelData->road_lookup, x, y)) {
+    bank_height = channel_lookup_cell_bankht(ChannelData->road_lookup, x, y);
+    cut_area = channel_lookup_cell_width(ChannelData->road_lookup, x, y) * 
+      channel_lookup_cell_length(ChannelData->road_lookup, x, y);
   }
   Network->Area = cut_area;
   Network->BankHeight = bank_height;
@@ -18,6 +18,7 @@
 #include "getinit.h"
 #include "channel.h"
 #include "channel_grid.h"
+#include "ensemble.h"
 
 /* -------------------------------------------------------------
    struct CHANNEL
@@ -27,8 +28,12 @@ typedef struct {
   ChannelClass *road_class;
   Channel *streams;
   Channel *roads;
+  ChannelRoute *stream_route;	/* streams in routing order */
+  ChannelRoute *road_route;	/* roads in routing order */
   ChannelMapPtr **stream_map;
   ChannelMapPtr **road_map;
+  ChannelLookup *stream_lookup;	/* stream_map compiled for the time step */
+  ChannelLookup *road_lookup;	/* road_map compiled for the time step */
   FILE *streamout;
   FILE *roadout;
   FILE *streamflowout;
@@ -42,14 +47,17 @@ typedef struct {
   FILE *streamWND;
   FILE *streamATP;
   FILE *streamMelt;
+  ENSEMBLEWRITER *ensemble;	/* binary ensemble store, NULL if none */
 } CHANNEL;
 
 /* -------------------------------------------------------------
    available functions
    ------------------------------------------------------------- */
 void InitChannel(LISTPTR Input, MAPSIZE *Map, int deltat, CHANNEL *channel,
-		 SOILPIX **SoilMap, int *MaxStreamID, int *MaxRoadID, OPTIONSTRUCT *Options);
-void InitChannelDump(OPTIONSTRUCT *Options, CHANNEL *channel, char *DumpPath, int RunNumber);
+		 SOILCELLS *SoilCells, int *MaxStreamID, int *MaxRoadID,
+		 OPTIONSTRUCT *Options);
+void InitChannelDump(OPTIONSTRUCT *Options, CHANNEL *channel, char *DumpPath,
+		     char *EnsemblePath, TIMESTRUCT *Time, int RunNumber);
 double ChannelCulvertFlow(int y, int x, CHANNEL *ChannelData);
 void RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
 		  TOPOPIX **TopoMap, SOILPIX **SoilMap, AGGREGATED *Total, 
@@ -57,5 +65,10 @@ void RouteChannel(CHANNEL *ChannelData, TIMESTRUCT *Time, MAPSIZE *Map,
 		  PRECIPPIX **PrecipMap, float Tair, float Rh, SNOWPIX **SnowMap);
 void ChannelCut(int y, int x, CHANNEL *ChannelData, ROADSTRUCT *Network);
 uchar ChannelFraction(TOPOPIX *topo, ChannelMapRec *rds);
+void InitEnsembleStore(char *FileName, TIMESTRUCT *Time, Channel *streams,
+		       int RunNumber, ENSEMBLEWRITER **Ensemble);
+float *EnsembleStep(ENSEMBLEWRITER *Ensemble, char *tstring);
+void SaveEnsembleStore(char *FileName, ENSEMBLEWRITER *Ensemble);
+void FreeEnsembleStore(ENSEMBLEWRITER **Ensemble);
 
 #endif
@@ -16,8 +16,16 @@
 #ifndef DHSVM_ERROR_H
 #define DHSVM_ERROR_H
 
+#include <setjmp.h>
+
 extern char errorstr[];
+extern jmp_buf *ErrorJump;	/* if not NULL, ReportError() returns here */
+extern jmp_buf *LoopJump;	/* same, for this thread in a parallel loop */
+#ifdef _OPENMP
+#pragma omp threadprivate(LoopJump)
+#endif
 void ReportError(char *ErrorString, int ErrorCode);
+char *LoopErrorString(void);
 void ReportWarning(char *ErrorString, int ErrorCode);
 
 #endif
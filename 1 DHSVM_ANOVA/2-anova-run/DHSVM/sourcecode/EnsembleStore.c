@@ -0,0 +1,286 @@
+/*
+ * SUMMARY:      EnsembleStore.c - Write streamflow to the binary ensemble store
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Buffer the outflow of the recorded stream segments during a
+ *               run and write it as one row of the ensemble store (see
+ *               ensemble.h) when the run has finished.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitEnsembleStore()
+ *               EnsembleStep()
+ *               SaveEnsembleStore()
+ *               FreeEnsembleStore()
+ * COMMENTS:     Runs of a campaign, in one or in many processes, share the
+ *               store.  Each run only writes its own row with pwrite() and
+ *               all runs write the same header bytes, so no locking is
+ *               needed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "DHSVMChannel.h"
+#include "ensemble.h"
+
+static void MakeHeader(ENSEMBLEWRITER *Ensemble, char **Block, int *Size,
+		       ENSEMBLEHEADER *Header);
+static int WriteAt(int fd, void *Buffer, size_t Size, off_t Offset);
+
+/*****************************************************************************
+  Function name: InitEnsembleStore()
+
+  Purpose      : Open the ensemble store and set up the buffer for one run
+
+  Required     :
+    char *FileName     - Ensemble store, created if it does not exist
+    TIMESTRUCT *Time   - Model period
+    Channel *streams   - Stream network
+    int RunNumber      - Row to write
+    ENSEMBLEWRITER **Ensemble - Writer to create
+
+  Returns      : void
+
+  Modifies     : Ensemble
+
+  Comments     : Every segment with a record flag in the stream network file
+                 becomes a series, in network order
+*****************************************************************************/
+void InitEnsembleStore(char *FileName, TIMESTRUCT *Time, Channel *streams,
+		       int RunNumber, ENSEMBLEWRITER **Ensemble)
+{
+  const char *Routine = "InitEnsembleStore";
+  ENSEMBLEWRITER *Ens;
+  Channel *net;
+  int i;
+
+  if (RunNumber < 0) {
+    sprintf(errorstr, "%s, run %d", FileName, RunNumber);
+    ReportError(errorstr, 47);
+  }
+
+  if (!(Ens = (ENSEMBLEWRITER *) calloc(1, sizeof(ENSEMBLEWRITER))))
+    ReportError((char *) Routine, 1);
+  Ens->fd = -1;
+  *Ensemble = Ens;
+
+  Ens->RunNumber = RunNumber;
+  Ens->NSteps = Time->NTotalSteps;
+  Ens->Dt = Time->Dt;
+  for (net = streams; net != NULL; net = net->next)
+    if (net->record)
+      Ens->NSeries++;
+
+  if (!(Ens->Dates = (char *) calloc(Ens->NSteps, ENSEMBLE_DATELEN)))
+    ReportError((char *) Routine, 1);
+  if (!(Ens->Names = (char *) calloc(Ens->NSeries > 0 ? Ens->NSeries : 1,
+				     ENSEMBLE_NAMELEN)))
+    ReportError((char *) Routine, 1);
+  if (!(Ens->Values = (float *) calloc((size_t) Ens->NSteps *
+				       (Ens->NSeries > 0 ? Ens->NSeries : 1),
+				       sizeof(float))))
+    ReportError((char *) Routine, 1);
+
+  for (i = 0, net = streams; net != NULL; net = net->next) {
+    if (net->record) {
+      if (net->record_name != NULL)
+	strncpy(Ens->Names + i * ENSEMBLE_NAMELEN, net->record_name,
+		ENSEMBLE_NAMELEN - 1);
+      else
+	sprintf(Ens->Names + i * ENSEMBLE_NAMELEN, "%d", net->id);
+      i++;
+    }
+  }
+
+  if ((Ens->fd = open(FileName, O_RDWR | O_CREAT, 0644)) == -1)
+    ReportError(FileName, 3);
+}
+
+/*****************************************************************************
+  Function name: EnsembleStep()
+
+  Purpose      : Start the next time step of the run
+
+  Required     :
+    ENSEMBLEWRITER *Ensemble - Writer, may be NULL
+    char *tstring            - Date of the step
+
+  Returns      : float * - NSeries values to fill with the outflow of the
+                           recorded segments, or NULL if there is no store
+
+  Modifies     : Ensemble
+*****************************************************************************/
+float *EnsembleStep(ENSEMBLEWRITER *Ensemble, char *tstring)
+{
+  float *Values;
+
+  if (Ensemble == NULL)
+    return NULL;
+
+  if (Ensemble->Step >= Ensemble->NSteps) {
+    sprintf(errorstr, "ensemble store, step %d of %d", Ensemble->Step,
+	    Ensemble->NSteps);
+    ReportError(errorstr, 47);
+  }
+
+  strncpy(Ensemble->Dates + Ensemble->Step * ENSEMBLE_DATELEN, tstring,
+	  ENSEMBLE_DATELEN - 1);
+  Values = Ensemble->Values + (size_t) Ensemble->Step * Ensemble->NSeries;
+  Ensemble->Step++;
+
+  return Values;
+}
+
+/*****************************************************************************
+  Function name: SaveEnsembleStore()
+
+  Purpose      : Write the buffered outflow as the row of this run
+
+  Required     :
+    char *FileName           - Ensemble store, for error messages
+    ENSEMBLEWRITER *Ensemble - Writer
+
+  Returns      : void
+
+  Modifies     : The store
+
+  Comments     : The header is written if the store is new, and otherwise
+                 must match the existing header, so that runs with a
+                 different model period or network cannot share a store.
+                 The row status is part of the same write as the values.
+*****************************************************************************/
+void SaveEnsembleStore(char *FileName, ENSEMBLEWRITER *Ensemble)
+{
+  const char *Routine = "SaveEnsembleStore";
+  ENSEMBLEHEADER Header;
+  ENSEMBLEROW *Row;
+  struct stat FileStat;
+  char *Block;
+  char *Existing;
+  int Size;
+
+  if (Ensemble->Step != Ensemble->NSteps) {
+    sprintf(errorstr, "%s, %d of %d steps", FileName, Ensemble->Step,
+	    Ensemble->NSteps);
+    ReportError(errorstr, 41);
+  }
+
+  MakeHeader(Ensemble, &Block, &Size, &Header);
+
+  if (fstat(Ensemble->fd, &FileStat) == -1)
+    ReportError(FileName, 2);
+  if (FileStat.st_size < (off_t) Size) {
+    if (!WriteAt(Ensemble->fd, Block, Size, 0))
+      ReportError(FileName, 41);
+  }
+  else {
+    if (!(Existing = (char *) malloc(Size)))
+      ReportError((char *) Routine, 1);
+    if (pread(Ensemble->fd, Existing, Size, 0) != Size)
+      ReportError(FileName, 2);
+    if (memcmp(Existing, Block, Size) != 0)
+      ReportError(FileName, 5);
+    free(Existing);
+  }
+  free(Block);
+
+  if (!(Row = (ENSEMBLEROW *) malloc(Header.RowSize)))
+    ReportError((char *) Routine, 1);
+  Row->Status = ENSEMBLE_ROW_DONE;
+  Row->RunNumber = Ensemble->RunNumber;
+  memcpy(Row + 1, Ensemble->Values,
+	 (size_t) Ensemble->NSteps * Ensemble->NSeries * sizeof(float));
+  if (!WriteAt(Ensemble->fd, Row, Header.RowSize, (off_t) Header.DataOffset +
+	       (off_t) Ensemble->RunNumber * Header.RowSize))
+    ReportError(FileName, 41);
+  free(Row);
+}
+
+/*****************************************************************************
+  Function name: FreeEnsembleStore()
+
+  Purpose      : Close the store and release the writer
+
+  Required     :
+    ENSEMBLEWRITER **Ensemble - Writer, may be NULL
+
+  Returns      : void
+
+  Modifies     : Ensemble is set to NULL
+*****************************************************************************/
+void FreeEnsembleStore(ENSEMBLEWRITER **Ensemble)
+{
+  ENSEMBLEWRITER *Ens = *Ensemble;
+
+  if (Ens == NULL)
+    return;
+
+  if (Ens->fd != -1)
+    close(Ens->fd);
+  free(Ens->Dates);
+  free(Ens->Names);
+  free(Ens->Values);
+  free(Ens);
+  *Ensemble = NULL;
+}
+
+/*****************************************************************************
+  MakeHeader()
+
+  Build the header, dates and segment names, padded to the first row
+*****************************************************************************/
+static void MakeHeader(ENSEMBLEWRITER *Ensemble, char **Block, int *Size,
+		       ENSEMBLEHEADER *Header)
+{
+  const char *Routine = "MakeHeader";
+  int Offset;
+
+  memset(Header, 0, sizeof(ENSEMBLEHEADER));
+  memcpy(Header->Magic, ENSEMBLE_MAGIC, sizeof(Header->Magic));
+  Header->Version = ENSEMBLE_VERSION;
+  Header->NSteps = Ensemble->NSteps;
+  Header->NSeries = Ensemble->NSeries;
+  Header->Dt = Ensemble->Dt;
+  Header->DataOffset = sizeof(ENSEMBLEHEADER) +
+    Ensemble->NSteps * ENSEMBLE_DATELEN + Ensemble->NSeries * ENSEMBLE_NAMELEN;
+  Header->DataOffset = (Header->DataOffset + 7) / 8 * 8;
+  Header->RowSize = sizeof(ENSEMBLEROW) +
+    Ensemble->NSteps * Ensemble->NSeries * sizeof(float);
+
+  if (!(*Block = (char *) calloc(Header->DataOffset, 1)))
+    ReportError((char *) Routine, 1);
+  memcpy(*Block, Header, sizeof(ENSEMBLEHEADER));
+  Offset = sizeof(ENSEMBLEHEADER);
+  memcpy(*Block + Offset, Ensemble->Dates, Ensemble->NSteps * ENSEMBLE_DATELEN);
+  Offset += Ensemble->NSteps * ENSEMBLE_DATELEN;
+  memcpy(*Block + Offset, Ensemble->Names, Ensemble->NSeries * ENSEMBLE_NAMELEN);
+  *Size = Header->DataOffset;
+}
+
+/*****************************************************************************
+  WriteAt()
+
+  pwrite() the whole buffer.  Returns FALSE on failure.
+*****************************************************************************/
+static int WriteAt(int fd, void *Buffer, size_t Size, off_t Offset)
+{
+  char *Ptr = (char *) Buffer;
+  ssize_t Written;
+
+  while (Size > 0) {
+    if ((Written = pwrite(fd, Ptr, Size, Offset)) <= 0)
+      return FALSE;
+    Ptr += Written;
+    Offset += Written;
+    Size -= Written;
+  }
+  return TRUE;
+}
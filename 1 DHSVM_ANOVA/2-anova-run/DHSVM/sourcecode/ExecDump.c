@@ -11,6 +11,7 @@
 * FUNCTIONS:    ExecDump()
 *               DumpMap()
 *               DumpPix()
+*               BasinCellValue()
 * COMMENTS:
 * $Id: ExecDump.c, v 4.0  2018/1/25   Ning Exp $
 */
@@ -27,6 +28,8 @@
 #include "constants.h"
 #include "varid.h"
 
+static float BasinCellValue(MAPSIZE *Map, int y, int x, float *Values);
+
 /*****************************************************************************
 ExecDump()
 *****************************************************************************/
@@ -34,10 +37,11 @@ void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
   DUMPSTRUCT *Dump, TOPOPIX **TopoMap, EVAPPIX **EvapMap,
   PIXRAD **RadMap, PRECIPPIX **PrecipMap, SNOWPIX **SnowMap,
   MET_MAP_PIX **MetMap, VEGPIX **VegMap, LAYER *Veg, SOILPIX **SoilMap,
-  ROADSTRUCT **Network, CHANNEL *ChannelData, LAYER *Soil,
-  AGGREGATED *Total, UNITHYDRINFO *HydrographInfo,
+  SOILCELLS *SoilCells, ROADSTRUCT **Network, CHANNEL *ChannelData,
+  LAYER *Soil, AGGREGATED *Total, UNITHYDRINFO *HydrographInfo,
   float *Hydrograph)
 {
+  int c;			/* basin cell */
   int i;			/* counter */
   int j;			/* counter */
   int x;
@@ -49,8 +53,8 @@ void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
   flag = 1;
   DumpPix(Current, IsEqualTime(Current, Start), &(Dump->Aggregate),
     &(Total->Evap), &(Total->Precip), &(Total->Rad), &(Total->Snow),
-    &(Total->Soil), &(Total->Veg), Soil->MaxLayers, Veg->MaxLayers,
-    Options, flag);
+    &(Total->Soil), Total->TableDepth, Total->SatFlow, &(Total->Veg),
+    Soil->MaxLayers, Veg->MaxLayers, Options, flag);
 
   fprintf(Dump->Aggregate.FilePtr, "\n");
 
@@ -81,6 +85,7 @@ void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
     for (i = 0; i < Dump->NPix; i++) {
       y = Dump->Pix[i].Loc.N;
       x = Dump->Pix[i].Loc.E;
+      c = Map->BasinIndex[y * Map->NX + x];
 
 
 
@@ -91,7 +96,8 @@ void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
       flag = 2;
       DumpPix(Current, IsEqualTime(Current, Start), &(Dump->Pix[i].OutFile),
         &(EvapMap[y][x]), &(PrecipMap[y][x]), &(RadMap[y][x]), &(SnowMap[y][x]),
-        &(SoilMap[y][x]), &(VegMap[y][x]), Soil->NLayers[(SoilMap[y][x].Soil - 1)],
+        &(SoilMap[y][x]), SoilCells->TableDepth[c], SoilCells->SatFlow[c],
+        &(VegMap[y][x]), Soil->NLayers[(SoilMap[y][x].Soil - 1)],
         Veg->NLayers[(VegMap[y][x].Veg - 1)], Options, flag);
       fprintf(Dump->Pix[i].OutFile.FilePtr, "\n");
     }
@@ -104,7 +110,7 @@ void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
           PrintDate(Current, stdout);
           fprintf(stdout, "\n");
           DumpMap(Map, Current, &(Dump->DMap[i]), TopoMap, EvapMap,
-            PrecipMap, RadMap, SnowMap, SoilMap, Soil, VegMap,
+            PrecipMap, RadMap, SnowMap, SoilMap, SoilCells, Soil, VegMap,
             Veg, Network, Options);
         }
       }
@@ -117,7 +123,7 @@ DumpMap()
 *****************************************************************************/
 void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
   EVAPPIX **EvapMap, PRECIPPIX **PrecipMap, PIXRAD **RadMap,
-  SNOWPIX **SnowMap, SOILPIX **SoilMap, LAYER *Soil,
+  SNOWPIX **SnowMap, SOILPIX **SoilMap, SOILCELLS *SoilCells, LAYER *Soil,
   VEGPIX **VegMap, LAYER *Veg, ROADSTRUCT **Network,
   OPTIONSTRUCT *Options)
 {
@@ -962,7 +968,8 @@ void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
     if (DMap->Resolution == MAP_OUTPUT) {
       for (y = 0; y < Map->NY; y++)
         for (x = 0; x < Map->NX; x++)
-          ((float *)Array)[y * Map->NX + x] = SoilMap[y][x].TableDepth;
+          ((float *)Array)[y * Map->NX + x] =
+            BasinCellValue(Map, y, x, SoilCells->TableDepth);
       Write2DMatrix(DMap->FileName, Array, DMap->NumberType, Map, DMap, Index);
 
     }
@@ -970,8 +977,8 @@ void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
       for (y = 0; y < Map->NY; y++)
         for (x = 0; x < Map->NX; x++)
           ((unsigned char *)Array)[y * Map->NX + x] =
-          (unsigned char)((SoilMap[y][x].TableDepth - Offset) /
-            Range * MAXUCHAR);
+          (unsigned char)((BasinCellValue(Map, y, x, SoilCells->TableDepth) -
+            Offset) / Range * MAXUCHAR);
       Write2DMatrix(DMap->FileName, Array, NC_BYTE, Map, DMap, Index);
 
     }
@@ -983,7 +990,8 @@ void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
     if (DMap->Resolution == MAP_OUTPUT) {
       for (y = 0; y < Map->NY; y++)
         for (x = 0; x < Map->NX; x++)
-          ((float *)Array)[y * Map->NX + x] = SoilMap[y][x].SatFlow;
+          ((float *)Array)[y * Map->NX + x] =
+            BasinCellValue(Map, y, x, SoilCells->SatFlow);
       Write2DMatrix(DMap->FileName, Array, DMap->NumberType, Map, DMap, Index);
 
     }
@@ -991,8 +999,8 @@ void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
       for (y = 0; y < Map->NY; y++)
         for (x = 0; x < Map->NX; x++)
           ((unsigned char *)Array)[y * Map->NX + x] =
-          (unsigned char)((SoilMap[y][x].SatFlow - Offset) /
-            Range * MAXUCHAR);
+          (unsigned char)((BasinCellValue(Map, y, x, SoilCells->SatFlow) -
+            Offset) / Range * MAXUCHAR);
       Write2DMatrix(DMap->FileName, Array, NC_BYTE, Map, DMap, Index);
 
     }
@@ -1170,7 +1178,8 @@ DumpPix()
 *****************************************************************************/
 void DumpPix(DATE *Current, int first, FILES *OutFile, EVAPPIX *Evap,
   PRECIPPIX *Precip, PIXRAD *Rad, SNOWPIX *Snow, SOILPIX *Soil,
-  VEGPIX *Veg, int NSoil, int NCanopyStory, OPTIONSTRUCT *Options, int flag)
+  float TableDepth, float SatFlow, VEGPIX *Veg, int NSoil, int NCanopyStory,
+  OPTIONSTRUCT *Options, int flag)
 {
   int i, j;			/* counter */
   float W;      /* available water for runoff - used in NG-IDF */
@@ -1289,8 +1298,8 @@ void DumpPix(DATE *Current, int first, FILES *OutFile, EVAPPIX *Evap,
   for (i = 0; i < NSoil; i++)
     fprintf(OutFile->FilePtr, " %g ", Soil->Perc[i]);
 
-  fprintf(OutFile->FilePtr, " %g %g %g ", Soil->TableDepth,
-    Soil->SatFlow, Soil->DetentionStorage);
+  fprintf(OutFile->FilePtr, " %g %g %g ", TableDepth,
+    SatFlow, Soil->DetentionStorage);
 
   for (i = 0; i <= NCanopyStory; i++) {
     fprintf(OutFile->FilePtr, " %g ", Rad->NetShort[i]);
@@ -1331,6 +1340,18 @@ void DumpPix(DATE *Current, int first, FILES *OutFile, EVAPPIX *Evap,
 
 }
 
+/*****************************************************************************
+BasinCellValue()
+
+Value of a SOILCELLS variable at grid cell (y, x), zero outside the basin
+*****************************************************************************/
+static float BasinCellValue(MAPSIZE *Map, int y, int x, float *Values)
+{
+  int c = Map->BasinIndex[y * Map->NX + x];
+
+  return (c >= 0) ? Values[c] : 0.0;
+}
+
 
 #ifdef TOPO_DUMP
 /******************************************************************************/
@@ -45,7 +45,7 @@ void FinalMassBalance(FILES *Out, AGGREGATED *Total, WATERBALANCE *Mass)
 
   NewWaterStorage = Total->Soil.IExcess + Total->Road.IExcess + 
     Total->CanopyWater + Total->SoilWater +
-    Total->Snow.Swq + Total->Soil.SatFlow + Total->Soil.DetentionStorage;
+    Total->Snow.Swq + Total->SatFlow + Total->Soil.DetentionStorage;
 
   Output = Mass->CumChannelInt + ( Mass->CumRoadInt  -
     Mass->CumCulvertReturnFlow ) + Mass->CumET;
@@ -72,7 +72,7 @@ void FinalMassBalance(FILES *Out, AGGREGATED *Total, WATERBALANCE *Mass)
   fprintf(stderr, "\n      Initial Storage ............        %.3f", Mass->StartWaterStorage*1000);
   fprintf(stderr, "\n      Final Storage ..............        %.3f", NewWaterStorage*1000);
   fprintf(stderr, "\n          Final SWQ ..............        %.3f", Total->Snow.Swq*1000);
-  fprintf(stderr, "\n          Final Soil Moisture ....        %.3f", (Total->SoilWater + Total->Soil.SatFlow)*1000);
+  fprintf(stderr, "\n          Final Soil Moisture ....        %.3f", (Total->SoilWater + Total->SatFlow)*1000);
   fprintf(stderr, "\n          Final Surface ..........        %.3f", (Total->Soil.IExcess  + 
 						                               Total->CanopyWater + Total->Soil.DetentionStorage)*1000);
   fprintf(stderr, "\n          Final Road Surface .....        %.3f\n", Total->Road.IExcess*1000);
@@ -96,7 +96,7 @@ void FinalMassBalance(FILES *Out, AGGREGATED *Total, WATERBALANCE *Mass)
   fprintf(Out->FilePtr, "\n      Initial Storage ............        %.3f", Mass->StartWaterStorage*1000);
   fprintf(Out->FilePtr, "\n      Final Storage ..............        %.3f", NewWaterStorage*1000);
   fprintf(Out->FilePtr, "\n          Final SWQ ..............        %.3f", Total->Snow.Swq*1000);
-  fprintf(Out->FilePtr, "\n          Final Soil Moisture ....        %.3f", (Total->SoilWater + Total->Soil.SatFlow)*1000);
+  fprintf(Out->FilePtr, "\n          Final Soil Moisture ....        %.3f", (Total->SoilWater + Total->SatFlow)*1000);
   fprintf(Out->FilePtr, "\n          Final Surface ..........        %.3f", (Total->Soil.IExcess  + 
 						                               Total->CanopyWater + Total->Soil.DetentionStorage)*1000);
   fprintf(Out->FilePtr, "\n          Final Road Surface .....        %.3f\n", Total->Road.IExcess*1000);
@@ -105,11 +105,11 @@ void FinalMassBalance(FILES *Out, AGGREGATED *Total, WATERBALANCE *Mass)
   fprintf(Out->FilePtr, "\n  Mass Error (mm).................        %.3f\n", MassError*1000);
   
      /* error check: negative soil moisture and surface ponding */
-  if (Total->SoilWater + Total->Soil.SatFlow < 0) {
+  if (Total->SoilWater + Total->SatFlow < 0) {
     fprintf(stderr,
-      "FINAL MASS BALANCE ERROR:  Negative soil moisture %.3f\n", (Total->SoilWater + Total->Soil.SatFlow) * 1000);
+      "FINAL MASS BALANCE ERROR:  Negative soil moisture %.3f\n", (Total->SoilWater + Total->SatFlow) * 1000);
     fprintf(Out->FilePtr,
-      "FINAL MASS BALANCE ERROR:  Negative soil moisture %.3f\n", (Total->SoilWater + Total->Soil.SatFlow) * 1000);
+      "FINAL MASS BALANCE ERROR:  Negative soil moisture %.3f\n", (Total->SoilWater + Total->SatFlow) * 1000);
   }
   if ((Total->Soil.IExcess + Total->CanopyWater + Total->Soil.DetentionStorage)/ Input > 0.1) {
     fprintf(stderr, "FINAL MASS BALANCE ERROR:  TOO MUCH SURFACE WATER PONDING %.3f\n", 
@@ -0,0 +1,403 @@
+/*
+ * SUMMARY:      FreeModelState.c - Release the state of a single model run
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Close the output files and free the memory that was allocated
+ *               by RunModel() for one parameter vector, so that the next
+ *               vector can be run in the same process
+ * DESCRIP-END.
+ * FUNCTIONS:    FreeModelState()
+ * COMMENTS:     All routines accept partially initialized structures, since
+ *               a run can be ended by ReportError() at any point.  Pointers
+ *               that were never allocated are NULL because the MODELSTATE is
+ *               created with calloc().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "settings.h"
+#include "data.h"
+#include "functions.h"
+#include "DHSVMChannel.h"
+#include "channel.h"
+#include "channel_grid.h"
+#include "rundhsvm.h"
+
+static int CloseFile(FILE **FilePtr);
+static int CloseOutputFiles(DUMPSTRUCT *Dump, CHANNEL *ChannelData);
+static void FreeSoilTable(int NTypes, SOILTABLE *SType);
+static void FreeVegTable(int NTypes, VEGTABLE *VType);
+static void FreeCanopyGapStruct(int NVeg, CanopyGapStruct *Type);
+static void FreeDump(DUMPSTRUCT *Dump);
+static void FreeChannelData(CHANNEL *ChannelData);
+
+/*****************************************************************************
+  Function name: FreeModelState()
+
+  Purpose      : Release all resources held by a MODELSTATE
+
+  Required     :
+    STATICINPUT *Static - inputs shared between runs (map size and mask)
+    MODELSTATE *State   - state to release
+
+  Returns      : int - FALSE if an output file could not be written
+
+  Modifies     : State
+
+  Comments     : The structure itself is not freed
+*****************************************************************************/
+int FreeModelState(STATICINPUT *Static, MODELSTATE *State)
+{
+  int NY = Static->Map.NY;
+  int Written;
+  int i;
+  int j;
+  int x;
+  int y;
+
+  Written = CloseOutputFiles(&(State->Dump), &(State->ChannelData));
+
+  if (State->EvapMap != NULL) {
+    for (y = 0; y < NY; y++) {
+      if (State->EvapMap[y] == NULL)
+	continue;
+      for (x = 0; x < Static->Map.NX; x++) {
+	EVAPPIX *Evap = &(State->EvapMap[y][x]);
+	if (Evap->ESoil != NULL) {
+	  for (i = 0; i < State->Veg.NLayers[State->VegMap[y][x].Veg - 1]; i++)
+	    free(Evap->ESoil[i]);
+	  free(Evap->ESoil);
+	}
+	free(Evap->EPot);
+	free(Evap->EAct);
+	free(Evap->EInt);
+      }
+      free(State->EvapMap[y]);
+    }
+    free(State->EvapMap);
+  }
+
+  if (State->PrecipMap != NULL) {
+    for (y = 0; y < NY; y++) {
+      if (State->PrecipMap[y] == NULL)
+	continue;
+      for (x = 0; x < Static->Map.NX; x++) {
+	free(State->PrecipMap[y][x].IntRain);
+	free(State->PrecipMap[y][x].IntSnow);
+      }
+      free(State->PrecipMap[y]);
+    }
+    free(State->PrecipMap);
+  }
+
+  if (State->RadiationMap != NULL) {
+    for (y = 0; y < NY; y++)
+      free(State->RadiationMap[y]);
+    free(State->RadiationMap);
+  }
+
+  if (State->StepMap != NULL) {
+    for (y = 0; y < NY; y++)
+      free(State->StepMap[y]);
+    free(State->StepMap);
+  }
+
+  free(State->RouteWork.FlowGrad);
+  free(State->RouteWork.TotalDir);
+  free(State->RouteWork.Dir);
+
+  if (State->Network != NULL) {
+    for (y = 0; y < NY; y++) {
+      if (State->Network[y] == NULL)
+	continue;
+      for (x = 0; x < Static->Map.NX; x++) {
+	free(State->Network[y][x].Adjust);
+	free(State->Network[y][x].PercArea);
+      }
+      free(State->Network[y]);
+    }
+    free(State->Network);
+  }
+
+  if (State->SnowMap != NULL) {
+    free(State->SnowMap[0]);
+    free(State->SnowMap);
+  }
+
+  /* The rows of SoilMap share one block, and each layered variable is one
+     block that starts at the first grid cell (FCap, Porosity) or at the
+     first basin cell (Perc, Temp, and Moist, which SoilCells owns) */
+  if (State->SoilMap != NULL && State->SoilMap[0] != NULL) {
+    SOILPIX *First = State->SoilMap[0];
+    if (Static->Map.NumCells > 0)
+      First += Static->Map.BasinCell[0];
+    free(First->Perc);
+    free(First->Temp);
+    free(State->SoilMap[0][0].Porosity);
+    free(State->SoilMap[0][0].FCap);
+    free(State->SoilMap[0]);
+  }
+  free(State->SoilMap);
+  free(State->SoilCells.Depth);
+  free(State->SoilCells.TableDepth);
+  free(State->SoilCells.KsLat);
+  free(State->SoilCells.SatFlow);
+  free(State->SoilCells.Moist);
+
+  if (State->VegMap != NULL) {
+    for (y = 0; y < NY; y++) {
+      if (State->VegMap[y] == NULL)
+	continue;
+      for (x = 0; x < Static->Map.NX; x++) {
+	VEGPIX *VegPix = &(State->VegMap[y][x]);
+	if (VegPix->LAIMonthly != NULL) {
+	  for (j = 0; j < State->VType[VegPix->Veg - 1].NVegLayers; j++)
+	    free(VegPix->LAIMonthly[j]);
+	  free(VegPix->LAIMonthly);
+	}
+	if (VegPix->Type != NULL) {
+	  for (i = 0; i < 2; i++)
+	    FreeCanopyGapStruct(State->Veg.MaxLayers, &(VegPix->Type[i]));
+	  free(VegPix->Type);
+	}
+	free(VegPix->Fract);
+	free(VegPix->LAI);
+	free(VegPix->MaxInt);
+      }
+      free(State->VegMap[y]);
+    }
+    free(State->VegMap);
+  }
+
+  if (State->UnitHydrograph != NULL) {
+    for (i = 0; i < State->HydrographInfo.MaxTravelTime; i++)
+      free(State->UnitHydrograph[i]);
+    free(State->UnitHydrograph);
+  }
+  if (State->HydrographInfo.ClassBins != NULL) {
+    for (i = 0; i < State->HydrographInfo.MaxTravelTime; i++)
+      free(State->HydrographInfo.ClassBins[i]);
+    free(State->HydrographInfo.ClassBins);
+  }
+  free(State->HydrographInfo.NClassBins);
+  free(State->HydrographInfo.ClassRunoff);
+  free(State->HydrographInfo.WaveLength);
+  free(State->Hydrograph);
+
+  if (State->Total.Evap.ESoil != NULL) {
+    for (i = 0; i < State->Veg.MaxLayers; i++)
+      free(State->Total.Evap.ESoil[i]);
+    free(State->Total.Evap.ESoil);
+  }
+  free(State->Total.Evap.EPot);
+  free(State->Total.Evap.EAct);
+  free(State->Total.Evap.EInt);
+  free(State->Total.Precip.IntRain);
+  free(State->Total.Precip.IntSnow);
+  free(State->Total.Soil.Moist);
+  free(State->Total.Soil.Perc);
+  free(State->Total.Soil.Temp);
+  if (State->Total.Veg.Type != NULL) {
+    for (i = 0; i < 2; i++)
+      FreeCanopyGapStruct(State->Veg.MaxLayers, &(State->Total.Veg.Type[i]));
+    free(State->Total.Veg.Type);
+  }
+
+  FreeDump(&(State->Dump));
+  FreeChannelData(&(State->ChannelData));
+  free(State->which_graphics);
+
+  FreeSoilTable(State->Soil.NTypes, State->SType);
+  FreeVegTable(State->Veg.NTypes, State->VType);
+  free(State->Soil.NLayers);
+  free(State->Veg.NLayers);
+
+  return Written;
+}
+
+/*****************************************************************************
+  CloseFile()
+
+  Close a file and return FALSE if any of the output written to it or its
+  close failed
+*****************************************************************************/
+static int CloseFile(FILE **FilePtr)
+{
+  int Written = TRUE;
+
+  if (*FilePtr != NULL) {
+    if (ferror(*FilePtr))
+      Written = FALSE;
+    if (fclose(*FilePtr) != 0)
+      Written = FALSE;
+    *FilePtr = NULL;
+  }
+  return Written;
+}
+
+/*****************************************************************************
+  CloseOutputFiles()
+
+  Close the output files opened by InitDump() and InitChannelDump().  All
+  files are closed, and FALSE is returned if any of them failed.
+*****************************************************************************/
+static int CloseOutputFiles(DUMPSTRUCT *Dump, CHANNEL *ChannelData)
+{
+  int Written = TRUE;
+  int i;
+
+  Written &= CloseFile(&(Dump->Aggregate.FilePtr));
+  Written &= CloseFile(&(Dump->Balance.FilePtr));
+  Written &= CloseFile(&(Dump->FinalBalance.FilePtr));
+  Written &= CloseFile(&(Dump->Stream.FilePtr));
+  Written &= CloseFile(&(Dump->SatExtent.FilePtr));
+  if (Dump->Pix != NULL) {
+    for (i = 0; i < Dump->NPix; i++)
+      Written &= CloseFile(&(Dump->Pix[i].OutFile.FilePtr));
+  }
+
+  Written &= CloseFile(&(ChannelData->streamflowout));
+  Written &= CloseFile(&(ChannelData->streamout));
+  Written &= CloseFile(&(ChannelData->roadflowout));
+  Written &= CloseFile(&(ChannelData->roadout));
+  Written &= CloseFile(&(ChannelData->streaminflow));
+  Written &= CloseFile(&(ChannelData->streamoutflow));
+  Written &= CloseFile(&(ChannelData->streamMelt));
+  Written &= CloseFile(&(ChannelData->streamNSW));
+  Written &= CloseFile(&(ChannelData->streamNLW));
+  Written &= CloseFile(&(ChannelData->streamVP));
+  Written &= CloseFile(&(ChannelData->streamWND));
+  Written &= CloseFile(&(ChannelData->streamATP));
+  FreeEnsembleStore(&(ChannelData->ensemble));
+
+  return Written;
+}
+
+/*****************************************************************************
+  FreeSoilTable()
+*****************************************************************************/
+static void FreeSoilTable(int NTypes, SOILTABLE *SType)
+{
+  int i;
+
+  if (SType == NULL)
+    return;
+
+  for (i = 0; i < NTypes; i++) {
+    free(SType[i].Porosity);
+    free(SType[i].PoreDist);
+    free(SType[i].Press);
+    free(SType[i].FCap);
+    free(SType[i].WP);
+    free(SType[i].Dens);
+    free(SType[i].Ks);
+    free(SType[i].KhDry);
+    free(SType[i].KhSol);
+    free(SType[i].Ch);
+  }
+  free(SType);
+}
+
+/*****************************************************************************
+  FreeVegTable()
+*****************************************************************************/
+static void FreeVegTable(int NTypes, VEGTABLE *VType)
+{
+  int i;
+  int j;
+
+  if (VType == NULL)
+    return;
+
+  for (i = 0; i < NTypes; i++) {
+    for (j = 0; j < VType[i].NVegLayers; j++) {
+      if (VType[i].RootFract != NULL)
+	free(VType[i].RootFract[j]);
+      if (VType[i].LAIMonthly != NULL)
+	free(VType[i].LAIMonthly[j]);
+      if (VType[i].AlbedoMonthly != NULL)
+	free(VType[i].AlbedoMonthly[j]);
+    }
+    free(VType[i].RootFract);
+    free(VType[i].LAIMonthly);
+    free(VType[i].AlbedoMonthly);
+    free(VType[i].Fract);
+    free(VType[i].HemiFract);
+    free(VType[i].Height);
+    free(VType[i].RsMax);
+    free(VType[i].RsMin);
+    free(VType[i].MoistThres);
+    free(VType[i].VpdThres);
+    free(VType[i].Rpc);
+    free(VType[i].Albedo);
+    free(VType[i].MaxInt);
+    free(VType[i].LAI);
+    free(VType[i].RootDepth);
+  }
+  free(VType);
+}
+
+/*****************************************************************************
+  FreeCanopyGapStruct()
+*****************************************************************************/
+static void FreeCanopyGapStruct(int NVeg, CanopyGapStruct *Type)
+{
+  int j;
+
+  if (Type->ESoil != NULL) {
+    for (j = 0; j < NVeg; j++)
+      free(Type->ESoil[j]);
+    free(Type->ESoil);
+  }
+  free(Type->IntRain);
+  free(Type->IntSnow);
+  free(Type->Moist);
+  free(Type->EPot);
+  free(Type->EAct);
+  free(Type->EInt);
+}
+
+/*****************************************************************************
+  FreeDump()
+*****************************************************************************/
+static void FreeDump(DUMPSTRUCT *Dump)
+{
+  int i;
+
+  if (Dump->DMap != NULL) {
+    for (i = 0; i < Dump->NMaps; i++)
+      free(Dump->DMap[i].DumpDate);
+    free(Dump->DMap);
+  }
+  free(Dump->DState);
+  free(Dump->Pix);
+}
+
+/*****************************************************************************
+  FreeChannelData()
+*****************************************************************************/
+static void FreeChannelData(CHANNEL *ChannelData)
+{
+  if (ChannelData->stream_lookup != NULL)
+    channel_lookup_free(ChannelData->stream_lookup);
+  if (ChannelData->road_lookup != NULL)
+    channel_lookup_free(ChannelData->road_lookup);
+  if (ChannelData->stream_map != NULL)
+    channel_grid_free_map(ChannelData->stream_map);
+  if (ChannelData->road_map != NULL)
+    channel_grid_free_map(ChannelData->road_map);
+  if (ChannelData->stream_route != NULL)
+    channel_free_order(ChannelData->stream_route);
+  if (ChannelData->road_route != NULL)
+    channel_free_order(ChannelData->road_route);
+  if (ChannelData->streams != NULL)
+    channel_free_network(ChannelData->streams);
+  if (ChannelData->roads != NULL)
+    channel_free_network(ChannelData->roads);
+  if (ChannelData->stream_class != NULL)
+    channel_free_classes(ChannelData->stream_class);
+  if (ChannelData->road_class != NULL)
+    channel_free_classes(ChannelData->road_class);
+}
@@ -22,6 +22,7 @@
 #include "functions.h"
 #include "constants.h"
 #include "rad.h"
+#include "metcache.h"
 
  /*****************************************************************************
    GetMetData()
@@ -35,9 +36,14 @@ void GetMetData(OPTIONSTRUCT *Options, TIMESTRUCT *Time, int NSoilLayers,
   if (DEBUG)
     printf("Reading all met data for current timestep\n");
 
-  for (i = 0; i < NStats; i++)
-    ReadMetRecord(Options, &(Time->Current), NSoilLayers, &(Stat[i].MetFile),
-      Stat[i].IsWindModelLocation, &(Stat[i].Data));
+  /* the met cache holds all stations, or none */
+  if (Stat[0].MetCache != NULL)
+    ReadMetCache(Options, Time->Step, NSoilLayers, NStats, Stat);
+  else {
+    for (i = 0; i < NStats; i++)
+      ReadMetRecord(Options, &(Time->Current), NSoilLayers, &(Stat[i].MetFile),
+        Stat[i].IsWindModelLocation, &(Stat[i].Data));
+  }
 
   if (Options->PrecipType == RADAR)
     ReadRadarMap(&(Time->Current), &(Time->StartRadar), Time->Dt, Radar,
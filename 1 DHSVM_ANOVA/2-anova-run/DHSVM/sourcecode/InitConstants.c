@@ -27,7 +27,6 @@
 #include "getinit.h"
 #include "constants.h"
 #include "rad.h"
-#define NPARAM 105 //nparam+runnumber = 104+1 =105
 
 /*****************************************************************************
   Function name: InitConstants()
@@ -53,7 +52,7 @@
   Comments     :
 *****************************************************************************/
 void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
-		   SOLARGEOMETRY *SolarGeo, TIMESTRUCT *Time, double Anovapara[NPARAM])
+		   SOLARGEOMETRY *SolarGeo, TIMESTRUCT *Time, double *Anovapara)
 {
   int i;			/* counter */
   double PointModelX;		/* X-coordinate for POINT model mode */
@@ -101,6 +100,7 @@ void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
     {"OPTIONS", "PRECIPITATION SEPARATION", "", "FALSE" },
     {"OPTIONS", "SNOW STATISTICS", "", "FALSE" },
     {"OPTIONS", "ROUTING NEIGHBORS", "", "4"},
+    {"OPTIONS", "THREADS", "", "1"},
     {"AREA", "COORDINATE SYSTEM", "", ""},
     {"AREA", "EXTREME NORTH", "", ""},
     {"AREA", "EXTREME WEST", "", ""},
@@ -178,6 +178,17 @@ void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
   }
   printf("Using %d neighbors for surface/subsurface routing\n", NDIRS);
 
+  /* Determine how many threads share the pixel loop of each time step */
+  if (!CopyInt(&(Options->Threads), StrEnv[threads].VarStr, 1) ||
+      Options->Threads < 1)
+    ReportError(StrEnv[threads].KeyName, 51);
+#ifndef _OPENMP
+  if (Options->Threads > 1) {
+    printf("Warning: DHSVM was built without OpenMP, using 1 thread\n");
+    Options->Threads = 1;
+  }
+#endif
+
   /* Determine how the flow gradient should be calculated */
   if (Options->Extent != POINT) {
     if (strncmp(StrEnv[gradient].VarStr, "TOPO", 4) == 0)
@@ -198,6 +209,10 @@ void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
     Options->Interpolation = NEAREST;
   else if (strncmp(StrEnv[interpolation].VarStr, "VARCRESS", 8) == 0)
     Options->Interpolation = VARCRESS;
+  else if (strncmp(StrEnv[interpolation].VarStr, "GRIDCELL", 8) == 0)
+    Options->Interpolation = GRIDCELL;
+  else if (strncmp(StrEnv[interpolation].VarStr, "BILINEAR", 8) == 0)
+    Options->Interpolation = BILINEAR;
   else
     ReportError(StrEnv[interpolation].KeyName, 51);
 
@@ -602,7 +617,7 @@ void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
  ******************************************************************************/
 void
 InitMappedConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
-                    SNOWPIX ***SnowMap, double Anovapara[NPARAM])
+                    SNOWPIX ***SnowMap, double *Anovapara)
 {
   STRINIENTRY StrEnv[] =
     {
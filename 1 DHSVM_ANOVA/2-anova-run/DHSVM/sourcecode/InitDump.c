@@ -78,6 +78,7 @@ void InitDump(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map, int MaxSoilLay
     {"OUTPUT", "NUMBER OF MAP VARIABLES", "", ""},
     {"OUTPUT", "NUMBER OF IMAGE VARIABLES", "", ""},
     {"OUTPUT", "NUMBER OF GRAPHICS", "", ""},
+    {"OUTPUT", "ENSEMBLE STORE", "", "none"},
     {NULL, NULL, "", NULL},
   };
 
@@ -102,6 +103,11 @@ void InitDump(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map, int MaxSoilLay
     strcpy(Dump->InitStatePath, Dump->Path);
   strcpy(Dump->InitStatePath, StrEnv[initial_state_path].VarStr);
 
+  if (IsEmptyStr(StrEnv[ensemble_store].VarStr))
+    strcpy(Dump->EnsembleStore, "none");
+  else
+    strcpy(Dump->EnsembleStore, StrEnv[ensemble_store].VarStr);
+
   if (IsEmptyStr(StrEnv[npixels].VarStr))
     Dump->NPix = 0;
   else if (!CopyInt(&(Dump->NPix), StrEnv[npixels].VarStr, 1) || Dump->NPix < 0)
@@ -135,15 +141,23 @@ void InitDump(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map, int MaxSoilLay
 
   // Open file for recording aggregated values for entire basin
   sprintf(Dump->Aggregate.FileName, "%sAggregated.Values.[%d]", Dump->Path, RunNumber);
-  OpenFile(&(Dump->Aggregate.FilePtr), Dump->Aggregate.FileName, "w", TRUE);
+  OpenOutputFile(&(Dump->Aggregate.FilePtr), Dump->Aggregate.FileName, "w");
 
   // Open file for recording mass balance for entire basin
   sprintf(Dump->Balance.FileName, "%sMass.Balance.[%d]", Dump->Path, RunNumber);
-  OpenFile(&(Dump->Balance.FilePtr), Dump->Balance.FileName, "w", TRUE);
+  OpenOutputFile(&(Dump->Balance.FilePtr), Dump->Balance.FileName, "w");
 
 #ifndef SNOW_ONLY
   sprintf(Dump->FinalBalance.FileName, "%sMass.Final.Balance.[%d]", Dump->Path, RunNumber);
-  OpenFile(&(Dump->FinalBalance.FilePtr), Dump->FinalBalance.FileName, "w", TRUE);
+  OpenOutputFile(&(Dump->FinalBalance.FilePtr), Dump->FinalBalance.FileName, "w");
+
+  /* one file per run, so that the runs of a worker do not append to the
+     same file */
+  if (Options->Extent != POINT) {
+    sprintf(Dump->SatExtent.FileName, "%ssaturation_extent.[%d]", Dump->Path,
+	    RunNumber);
+    OpenOutputFile(&(Dump->SatExtent.FilePtr), Dump->SatExtent.FileName, "w");
+  }
 #endif
 
   if (Options->Extent != POINT) {
@@ -193,7 +207,7 @@ void InitDump(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map, int MaxSoilLay
     /* if no network open unit hydrograph file */
     if (!(Options->HasNetwork)) {
       sprintf(Dump->Stream.FileName, "%sStream.Flow", Dump->Path);
-      OpenFile(&(Dump->Stream.FilePtr), Dump->Stream.FileName, "w", TRUE);
+      OpenOutputFile(&(Dump->Stream.FilePtr), Dump->Stream.FileName, "w");
     }
   }
 }
@@ -572,7 +586,7 @@ int InitPixDump(LISTPTR Input, MAPSIZE *Map, uchar **BasinMask, char *Path,
       sprintf((*Pix)[ok].OutFile.FileName, "%sPixel.%s", Path, Str);
       (*Pix)[ok].Loc.N = (*Pix)[i].Loc.N;
       (*Pix)[ok].Loc.E = (*Pix)[i].Loc.E;
-      OpenFile(&((*Pix)[ok].OutFile.FilePtr), (*Pix)[ok].OutFile.FileName, "w", TRUE);
+      OpenOutputFile(&((*Pix)[ok].OutFile.FilePtr), (*Pix)[ok].OutFile.FileName, "w");
       ok++;
     }
   }
@@ -25,7 +25,8 @@
    InitInterpolationWeights()
  *****************************************************************************/
 void InitInterpolationWeights(MAPSIZE *Map, OPTIONSTRUCT *Options,
-  TOPOPIX **TopoMap, uchar ****MetWeights, METLOCATION *Stats, int NStats)
+  TOPOPIX **TopoMap, METWEIGHTS *MetWeights, METLOCATION *Stats, int NStats,
+  GRID *Grid)
 {
   const char *Routine = "InitInterpolationWeights";
   uchar **BasinMask;
@@ -38,16 +39,11 @@ void InitInterpolationWeights(MAPSIZE *Map, OPTIONSTRUCT *Options,
       Stats[i].Elev = TopoMap[Stats[i].Loc.N][Stats[i].Loc.E].Dem;
 
   if (Options->MM5 == TRUE && Options->QPF == FALSE) {
-    if (!((*MetWeights) = (uchar ***)calloc(Map->NY, sizeof(uchar **))))
-      ReportError("CalcWeights()", 1);
-
-    for (y = 0; y < Map->NY; y++)
-      if (!((*MetWeights)[y] = (uchar **)calloc(Map->NX, sizeof(uchar *))))
-        ReportError("CalcWeights()", 1);
-
-    for (y = 0; y < Map->NY; y++)
-      for (x = 0; x < Map->NX; x++)
-        (*MetWeights)[y][x] = NULL;
+    MetWeights->NY = Map->NY;
+    MetWeights->NX = Map->NX;
+    MetWeights->NWeights = 0;
+    MetWeights->Start = NULL;
+    MetWeights->Weight = NULL;
   }
   else {
     if (!(BasinMask = (uchar **)calloc(Map->NY, sizeof(uchar *))))
@@ -62,7 +58,7 @@ void InitInterpolationWeights(MAPSIZE *Map, OPTIONSTRUCT *Options,
         BasinMask[y][x] = TopoMap[y][x].Mask;
 
     CalcWeights(Stats, NStats, Map->NX, Map->NY, BasinMask, MetWeights,
-      Options);
+      Grid, Options);
 
     printf("\nSummary info on met stations used for current model run \n");
     printf("        Name\t\tY\tX\tIn Mask\tDefined Elev\tActual Elev\n");
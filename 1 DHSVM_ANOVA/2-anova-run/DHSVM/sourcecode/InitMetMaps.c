@@ -34,27 +34,28 @@
 
  /*****************************************************************************
    InitMetMaps()
+
+   Allocate and read the meteorological forcing maps.  These depend only on
+   the terrain and the met sources, so they are read once and shared by all
+   model runs.  The per-pixel state maps (evaporation, precipitation and
+   radiation) are set up separately by InitEvapMap(), InitPrecipMap() and
+   InitRadMap().
  *****************************************************************************/
 void InitMetMaps(LISTPTR Input, int NDaySteps, MAPSIZE *Map, MAPSIZE *Radar,
   OPTIONSTRUCT *Options, char *WindPath, char *PrecipLapseFile,
   float ***PrecipLapseMap, float ***PrismMap,
   unsigned char ****ShadowMap, float ***SkyViewMap,
-  EVAPPIX ***EvapMap, PRECIPPIX ***PrecipMap, float ***PptMultiplierMap,
-  RADARPIX ***RadarMap, PIXRAD ***RadMap,
-  SOILPIX **SoilMap, LAYER *Soil, VEGPIX **VegMap,
-  LAYER *Veg, TOPOPIX **TopoMap, float ****MM5Input,
-  float ****WindModel)
+  float ***PptMultiplierMap, RADARPIX ***RadarMap, int NSoilLayers,
+  float ****MM5Input, float ****WindModel)
 {
   int y, x;
 
   printf("Initializing meteorological maps\n");
 
-  InitEvapMap(Map, EvapMap, SoilMap, Soil, VegMap, Veg, TopoMap);
-  InitPrecipMap(Map, PrecipMap, VegMap, Veg, TopoMap);
   InitPptMultiplierMap(Options, Map, PptMultiplierMap);                                                            
 
   if (Options->MM5 == TRUE) {
-    InitMM5Maps(Soil->MaxLayers, Map->NY, Map->NX, MM5Input, RadMap, Options);
+    InitMM5Maps(NSoilLayers, Map->NY, Map->NX, MM5Input, Options);
     /* If called for, use the precip lapse map for MM5 precip
        distribution, avoiding lots of function interfaces changes */
     if (strlen(PrecipLapseFile) > 0) {
@@ -86,8 +87,6 @@ void InitMetMaps(LISTPTR Input, int NDaySteps, MAPSIZE *Map, MAPSIZE *Radar,
     }
     if (Options->WindSource == MODEL)
       InitWindModelMaps(WindPath, Map, WindModel);
-
-    InitRadMap(Map, RadMap);
   }
   if (Options->MM5 == TRUE && Options->QPF == TRUE && Options->Prism == TRUE)
     InitPrismMap(Map->NY, Map->NX, PrismMap);
@@ -207,7 +206,7 @@ void InitPrecipMap(MAPSIZE * Map, PRECIPPIX *** PrecipMap, VEGPIX ** VegMap,
   InitMM5Maps()
 *******************************************************************************/
 void InitMM5Maps(int NSoilLayers, int NY, int NX, float ****MM5Input,
-  PIXRAD ***RadMap, OPTIONSTRUCT *Options)
+  OPTIONSTRUCT *Options)
 {
   char *Routine = "InitMM5Maps";
   int NTotalMaps = NSoilLayers + N_MM5_MAPS;
@@ -228,14 +227,6 @@ void InitMM5Maps(int NSoilLayers, int NY, int NX, float ****MM5Input,
         ReportError(Routine, 1);
     }
   }
-
-  /* Initiate radiation map */
-  if (!(*RadMap = (PIXRAD **)calloc(NY, sizeof(PIXRAD *))))
-    ReportError((char *)Routine, 1);
-  for (y = 0; y < NY; y++) {
-    if (!((*RadMap)[y] = (PIXRAD *)calloc(NX, sizeof(PIXRAD))))
-      ReportError((char *)Routine, 1);
-  }
 }
 
 /*******************************************************************************
@@ -402,6 +393,10 @@ void InitShadeMap(OPTIONSTRUCT * Options, int NDaySteps, MAPSIZE *Map,
     if (!((*ShadowMap)[n] =
       (unsigned char **)calloc(Map->NY, sizeof(unsigned char *))))
       ReportError((char *)Routine, 1);
+    /* binary shadow files are mapped by InitNewMonth(), which points the
+       rows into them */
+    if (Options->FileFormat != NETCDF)
+      continue;
     for (y = 0; y < Map->NY; y++) {
       if (!((*ShadowMap)[n][y] =
         (unsigned char *)calloc(Map->NX, sizeof(unsigned char))))
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <unistd.h>
 #include "settings.h"
 #include "data.h"
 #include "Calendar.h"
@@ -32,6 +33,7 @@
 #include "getinit.h"
 #include "constants.h"
 #include "rad.h"
+#include "metcache.h"
                           
  /*******************************************************************************
    Function name: InitMetSources()
@@ -64,6 +66,8 @@ void InitMetSources(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
   GRID *Grid)
 {
   const char *Routine = "InitMetSources";
+  char MetCacheFile[BUFSIZE + 1];
+  int i;
 
   if (Options->Outside == TRUE && Options->MM5 == FALSE) {
     printf("\nAll met stations in list will be included \n");
@@ -77,6 +81,13 @@ void InitMetSources(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
     InitMM5(Input, NSoilLayers, Time, InFiles, Options, MM5Map, Map);
   }
 
+  /* the GRIDCELL and BILINEAR interpolation work on the grid of the gridded
+     met files */
+  if ((Options->Interpolation == GRIDCELL ||
+       Options->Interpolation == BILINEAR) &&
+      (Options->GRIDMET == FALSE || Options->QPF == TRUE))
+    ReportError((char *)Routine, 42);
+
   /* Use gridded met forcing data */
   if (Options->GRIDMET == TRUE)
     InitGridMet(Options, Input, Map, TopoMap, Grid, Stat, NStats);
@@ -95,6 +106,19 @@ void InitMetSources(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
         ReportError((char *)Routine, 54);
       InitPrecipLapse(Input, InFiles);
     }
+
+    /* binary cache of the station records, optional */
+    GetInitString("METEOROLOGY", "MET CACHE FILE", "", MetCacheFile,
+      (unsigned long)BUFSIZE, Input);
+    if (!IsEmptyStr(MetCacheFile) && strncmp(MetCacheFile, "none", 4))
+      InitMetCache(MetCacheFile, Options, Time, NSoilLayers, *NStats, *Stat);
+
+    /* without the cache the records are read from the files, and the
+       gridded met files are opened for that only now */
+    for (i = 0; i < *NStats; i++)
+      if ((*Stat)[i].MetCache == NULL && (*Stat)[i].MetFile.FilePtr == NULL)
+        OpenFile(&((*Stat)[i].MetFile.FilePtr), (*Stat)[i].MetFile.FileName,
+          "r", FALSE);
   }
 }
 
@@ -226,6 +250,10 @@ Function name: InitGridMet()
 
 Purpose      : Read the gridded met file.  This information
 is in the [METEOROLOGY] section
+
+Comments     : For the GRIDCELL and BILINEAR interpolation the grid of the
+met files is found first, and Grid->Node gets the station of each grid
+point that is used (see MetLattice.c).
 *****************************************************************************/
 void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map,
   TOPOPIX **TopoMap, GRID *Grid, METLOCATION **Stat, int *NStats)
@@ -238,6 +266,10 @@ void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map,
   char tempfilename[BUFSIZE + 1];
   FILE *PrismStatFile;
   char junk[BUFSIZE + 1], infileformat[BUFSIZE + 1];
+  float *Lat = NULL;            /* latitudes of all met files */
+  float *Lon = NULL;            /* longitudes of all met files */
+  int NPoints;                  /* number of met files */
+  int Capacity;                 /* room in Lat and Lon */
   DIR *dir;                   
   struct dirent *ent;
 
@@ -254,10 +286,6 @@ void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map,
     { NULL, NULL, "", NULL },
   };
 
-  /* Allocate memory for the stations */
-  if (!(Grid = (GRID *)calloc(1, sizeof(GRID))))
-    ReportError(Routine, 1);
-
   /* Read the key-entry pairs from the input file */
   for (i = 0; StrEnv[i].SectionName; i++)
     GetInitString(StrEnv[i].SectionName, StrEnv[i].KeyName, StrEnv[i].Default,
@@ -318,6 +346,31 @@ void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map,
   k = 0;
   m = 0;
   if ((dir = opendir(Grid->filepath)) != NULL) {
+    /* the GRIDCELL and BILINEAR interpolation need the grid of all files */
+    if (Options->Interpolation == GRIDCELL ||
+        Options->Interpolation == BILINEAR) {
+      NPoints = 0;
+      Capacity = 0;
+      while ((ent = readdir(dir)) != NULL) {
+        if (sscanf(ent->d_name, junk, &lat, &lon) != 2)
+          continue;
+        if (NPoints == Capacity) {
+          Capacity = (Capacity > 0) ? 2 * Capacity : 1024;
+          if (!(Lat = (float *)realloc(Lat, Capacity * sizeof(float))))
+            ReportError(Routine, 1);
+          if (!(Lon = (float *)realloc(Lon, Capacity * sizeof(float))))
+            ReportError(Routine, 1);
+        }
+        Lat[NPoints] = lat;
+        Lon[NPoints] = lon;
+        NPoints++;
+      }
+      InitMetLattice(Grid, Map, NPoints, Lat, Lon);
+      free(Lat);
+      free(Lon);
+      rewinddir(dir);
+    }
+
     /* print all the files and directories within directory */
     while ((ent = readdir(dir)) != NULL) {                        
       if (!strcmp(ent->d_name, ".") || !strcmp(ent->d_name, "..")) {
@@ -346,24 +399,28 @@ void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map,
           if (Options->Outside == FALSE) {
             if (INBASIN(TopoMap[(*Stat)[k].Loc.N][(*Stat)[k].Loc.E].Mask)) {
                                                                          
-			  /* open met data file */
+			  /* check the met data file, it is opened by InitMetSources() */
               sprintf((*Stat)[k].MetFile.FileName, infileformat, Grid->filepath, Grid->fileprefix, lat, lon);
                                                                   
-              if (!((*Stat)[k].MetFile.FilePtr = fopen((*Stat)[k].MetFile.FileName, "r"))) {
+              if (access((*Stat)[k].MetFile.FileName, R_OK) != 0) {
                 printf("..... %s doesn't exist\n", (*Stat)[k].MetFile.FileName);
                 continue;
               }                                        
               printf("..... Station %d: %s is selected\n", m, (*Stat)[k].Name);            
+              if (Grid->Node != NULL)
+                Grid->Node[MetLatticeNode(Grid, lat, lon)] = k;
               k = k + 1;             
             }
           }
           else {
             if (lat <= Grid->LatNorth && lat >= Grid->LatSouth && lon >= Grid->LonWest && lon <= Grid->LonWest) {
-              if (!((*Stat)[k].MetFile.FilePtr = fopen((*Stat)[k].MetFile.FileName, "r"))) {
+              if (access((*Stat)[k].MetFile.FileName, R_OK) != 0) {
                 //printf("..... %s doesn't exist\n", (*Stat)[k].MetFile.FileName);
                 continue;
               }                                        
               printf("..... Station %d: %s is selected\n", m, (*Stat)[k].Name);               
+              if (Grid->Node != NULL)
+                Grid->Node[MetLatticeNode(Grid, lat, lon)] = k;
               k = k + 1;
             }
           }
@@ -47,8 +47,8 @@
 
  *****************************************************************************/
 void InitModelState(DATE *Start, int StepsPerDay, MAPSIZE *Map, OPTIONSTRUCT *Options, PRECIPPIX **PrecipMap,
-  SNOWPIX **SnowMap, SOILPIX **SoilMap, LAYER Soil, SOILTABLE *SType,
-  VEGPIX **VegMap, LAYER Veg, VEGTABLE *VType, char *Path, 
+  SNOWPIX **SnowMap, SOILPIX **SoilMap, SOILCELLS *SoilCells, LAYER Soil,
+  SOILTABLE *SType, VEGPIX **VegMap, LAYER Veg, VEGTABLE *VType, char *Path, 
   TOPOPIX **TopoMap, ROADSTRUCT **Network, UNITHYDRINFO *HydrographInfo,
   float *Hydrograph)
 {
@@ -58,12 +58,14 @@ void InitModelState(DATE *Start, int StepsPerDay, MAPSIZE *Map, OPTIONSTRUCT *Op
   FILE *HydroStateFile;
   int i, j;		         /* counter */
   int CountGap, Count;
+  int c;				 /* basin cell */
   int x;				 /* counter */
   int y;				 /* counter */
   int NSet;				 /* Number of dataset to be read */
   int NSoil;			 /* Number of soil layers for current pixel */
   int NVeg;				 /* Number of veg layers for current pixel */
   float remove;
+  float Value;			 /* Hydrograph state value */
   void *Array;
   MAPDUMP DMap;			 /* Dump Info */
 
@@ -400,24 +402,19 @@ void InitModelState(DATE *Start, int StepsPerDay, MAPSIZE *Map, OPTIONSTRUCT *Op
   /* Calculate the water table depth at each point based on the soil moisture profile. Give an error message if the water
   ponds on the surface since that should not be allowed at this point */
   remove = 0.0;
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      /* SatFlow needs to be initialized properly in the future.
-      For now it will just be set to zero here */
-      SoilMap[y][x].SatFlow = 0.0;
-      if (INBASIN(TopoMap[y][x].Mask)) {
-        if ((SoilMap[y][x].TableDepth =
-          WaterTableDepth((Soil.NLayers[SoilMap[y][x].Soil - 1]), SoilMap[y][x].Depth,
-            VType[VegMap[y][x].Veg - 1].RootDepth, SoilMap[y][x].Porosity,
-            SoilMap[y][x].FCap, Network[y][x].Adjust, SoilMap[y][x].Moist)) < 0.0)
-          /* ReportError((char *) Routine, 35); */ {
-            remove -= SoilMap[y][x].TableDepth * Map->DX * Map->DY;
-            SoilMap[y][x].TableDepth = 0.0;
-        }
-      }
-      else {
-        SoilMap[y][x].TableDepth = 0;
-      }
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    /* SatFlow needs to be initialized properly in the future.
+    For now it will just be set to zero here */
+    SoilCells->SatFlow[c] = 0.0;
+    if ((SoilCells->TableDepth[c] =
+      WaterTableDepth((Soil.NLayers[SoilMap[y][x].Soil - 1]), SoilCells->Depth[c],
+        VType[VegMap[y][x].Veg - 1].RootDepth, SoilMap[y][x].Porosity,
+        SoilMap[y][x].FCap, Network[y][x].Adjust, SoilMap[y][x].Moist)) < 0.0)
+      /* ReportError((char *) Routine, 35); */ {
+        remove -= SoilCells->TableDepth[c] * Map->DX * Map->DY;
+        SoilCells->TableDepth[c] = 0.0;
     }
   }
   if (remove > 0.0) {
@@ -429,8 +426,12 @@ void InitModelState(DATE *Start, int StepsPerDay, MAPSIZE *Map, OPTIONSTRUCT *Op
   if (Options->Extent == BASIN && Options->HasNetwork == FALSE) {
     sprintf(FileName, "%sHydrograph.State.%s", Path, Str);
     OpenFile(&HydroStateFile, FileName, "r", FALSE);
-    for (i = 0; i < HydrographInfo->TotalWaveLength; i++)
-      fscanf(HydroStateFile, "%f\n", &(Hydrograph[i]));
+    /* one value per second, summed into the bins of the hydrograph */
+    for (i = 0; i < HydrographInfo->TotalWaveLength; i++) {
+      fscanf(HydroStateFile, "%f\n", &Value);
+      Hydrograph[(HydrographInfo->Head + i / HydrographInfo->Dt) %
+		 HydrographInfo->NBins] += Value;
+    }
     fclose(HydroStateFile);
   }
   // Initialize the flood detention storage in each pixel for impervious fraction > 0 situation. 
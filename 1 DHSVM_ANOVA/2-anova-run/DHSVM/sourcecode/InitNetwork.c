@@ -34,7 +34,7 @@
    Comments     :
  *****************************************************************************/
 void InitNetwork(int NY, int NX, float DX, float DY, TOPOPIX **TopoMap,
-  SOILPIX **SoilMap, VEGPIX **VegMap, VEGTABLE *VType,
+  SOILCELLS *SoilCells, int *BasinIndex, VEGPIX **VegMap, VEGTABLE *VType,
   ROADSTRUCT ***Network, CHANNEL *ChannelData,
   LAYER Veg, OPTIONSTRUCT *Options)
 {
@@ -85,7 +85,7 @@ void InitNetwork(int NY, int NX, float DX, float DY, TOPOPIX **TopoMap,
         if (INBASIN(TopoMap[y][x].Mask)) {
           ChannelCut(y, x, ChannelData, &((*Network)[y][x]));
           AdjustStorage(VType[VegMap[y][x].Veg - 1].NSoilLayers,
-            SoilMap[y][x].Depth,
+            SoilCells->Depth[BasinIndex[y * NX + x]],
             VType[VegMap[y][x].Veg - 1].RootDepth,
             (*Network)[y][x].Area, DX, DY,
             (*Network)[y][x].BankHeight,
@@ -89,28 +89,33 @@ void InitNewMonth(TIMESTRUCT *Time, OPTIONSTRUCT *Options, MAPSIZE *Map,
 
   if (Options->Shading == TRUE) {
     printf("reading in new shadow map for month %d \n", Time->Current.Month);
-    sprintf(FileName, "%s.%02d.%s", Options->ShadingDataPath,
-      Time->Current.Month, Options->ShadingDataExt);
-    GetVarName(304, 0, VarName);
-    GetVarNumberType(304, &NumberType);
-    if (!(Array1 = (unsigned char *)calloc(Map->NY * Map->NX, sizeof(unsigned char))))
-      ReportError((char *)Routine, 1);
-    for (i = 0; i < Time->NDaySteps; i++) {
-	  /* if computational time step is finer than hourly, make the shade factor equal within
-	  the hourly interval */
-	  if (Time->NDaySteps > 24) {
-		jj = round(i / (Time->NDaySteps / 24));
-		Read2DMatrix(FileName, Array1, NumberType, Map, jj, VarName, jj);
-	  }
-	  else   
-      Read2DMatrix(FileName, Array1, NumberType, Map, i, VarName, i);
-      for (y = 0; y < Map->NY; y++) {
-        for (x = 0; x < Map->NX; x++) {
-          ShadowMap[i][y][x] = Array1[y * Map->NX + x];
+    if (Options->FileFormat != NETCDF)
+      MapShadowMonth(Options, Map, Time->NDaySteps, Time->Current.Month,
+		     ShadowMap);
+    else {
+      sprintf(FileName, "%s.%02d.%s", Options->ShadingDataPath,
+        Time->Current.Month, Options->ShadingDataExt);
+      GetVarName(304, 0, VarName);
+      GetVarNumberType(304, &NumberType);
+      if (!(Array1 = (unsigned char *)calloc(Map->NY * Map->NX, sizeof(unsigned char))))
+        ReportError((char *)Routine, 1);
+      for (i = 0; i < Time->NDaySteps; i++) {
+        /* if computational time step is finer than hourly, make the shade
+           factor equal within the hourly interval */
+        if (Time->NDaySteps > 24) {
+          jj = round(i / (Time->NDaySteps / 24));
+          Read2DMatrix(FileName, Array1, NumberType, Map, jj, VarName, jj);
+        }
+        else
+          Read2DMatrix(FileName, Array1, NumberType, Map, i, VarName, i);
+        for (y = 0; y < Map->NY; y++) {
+          for (x = 0; x < Map->NX; x++) {
+            ShadowMap[i][y][x] = Array1[y * Map->NX + x];
+          }
         }
       }
+      free(Array1);
     }
-    free(Array1);
   }
 
   printf("changing LAI, albedo and diffuse transmission parameters\n");
@@ -231,6 +236,7 @@ UpdateMM5Field(char *input, int Step, MAPSIZE *Map, MAPSIZE *MM5Map,
     SOLARGEOMETRY *SolarGeo  - structure with information about Earth-Sun
                                geometry
     SOILPIX **SoilMap        - structure with soil information
+    SOILCELLS *SoilCells     - soil routing variables of the basin cells
     float ***MM5Input        - MM5 input maps
     float ***WindModel       - Wind model maps
 
@@ -244,11 +250,12 @@ void InitNewStep(INPUTFILES *InFiles, MAPSIZE *Map, TIMESTRUCT *Time,
                  int NSoilLayers, OPTIONSTRUCT *Options, int NStats,
                  METLOCATION *Stat, char *RadarFileName, MAPSIZE *Radar,
                  RADARPIX **RadarMap, SOLARGEOMETRY *SolarGeo,
-                 TOPOPIX **TopoMap, SOILPIX **SoilMap,
+                 TOPOPIX **TopoMap, SOILPIX **SoilMap, SOILCELLS *SoilCells,
                  float ***MM5Input, float **PrecipLapseMap, 
                  float ***WindModel, MAPSIZE *MM5Map)
 {
   const char *Routine = "InitNewStep";
+  int c;			/* basin cell */
   int i;			/* counter */
   int j;			/* counter */
   int x;			/* counter */
@@ -417,13 +424,10 @@ void InitNewStep(INPUTFILES *InFiles, MAPSIZE *Map, TIMESTRUCT *Time,
   if (Options->FlowGradient == WATERTABLE) {
     /* Calculate the WaterLevel, i.e. the height of the water table above
        some datum */
-    for (y = 0; y < Map->NY; y++) {
-      for (x = 0; x < Map->NX; x++) {
-        if (INBASIN(TopoMap[y][x].Mask)) {
-          SoilMap[y][x].WaterLevel =
-            TopoMap[y][x].Dem - SoilMap[y][x].TableDepth;
-        }
-      }
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      SoilMap[y][x].WaterLevel = TopoMap[y][x].Dem - SoilCells->TableDepth[c];
     }
     /*     HeadSlopeAspect(Map, TopoMap, SoilMap); */
   }
@@ -45,11 +45,12 @@ void InitSnowMap(MAPSIZE *Map, SNOWPIX ***SnowMap, TIMESTRUCT *Time)
 
   printf("Initializing snow map\n");
 
+  /* The rows point into a single NY * NX block */
   if (!(*SnowMap = (SNOWPIX **) calloc(Map->NY, sizeof(SNOWPIX *))))
     ReportError((char *) Routine, 1);
+  if (!((*SnowMap)[0] = (SNOWPIX *) calloc(Map->NY * Map->NX, sizeof(SNOWPIX))))
+    ReportError((char *) Routine, 1);
 
-  for (y = 0; y < Map->NY; y++) {
-    if (!((*SnowMap)[y] = (SNOWPIX *) calloc(Map->NX, sizeof(SNOWPIX))))
-      ReportError((char *) Routine, 1);
-  }
+  for (y = 1; y < Map->NY; y++)
+    (*SnowMap)[y] = (*SnowMap)[0] + y * Map->NX;
 }
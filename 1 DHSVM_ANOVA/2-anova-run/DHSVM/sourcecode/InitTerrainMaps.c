@@ -10,6 +10,7 @@
  * DESCRIP-END.
  * FUNCTIONS:    InitTerrainMaps()
  *               InitTopoMap()
+ *               InitBasinIndex()
  *               InitSoilMap()
  *               InitVegMap()
  * COMMENTS:
@@ -35,13 +36,13 @@
  *****************************************************************************/
 void InitTerrainMaps(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
   LAYER *Soil, LAYER *Veg, TOPOPIX ***TopoMap, SOILTABLE *SType, SOILPIX ***SoilMap, 
-  VEGTABLE *VType, VEGPIX ***VegMap)
+  SOILCELLS *SoilCells, VEGTABLE *VType, VEGPIX ***VegMap)
 
 {
   printf("\nInitializing terrain maps\n");
 
   InitTopoMap(Input, Options, Map, TopoMap);
-  InitSoilMap(Input, Options, Map, Soil, *TopoMap, SoilMap, SType);
+  InitSoilMap(Input, Options, Map, Soil, *TopoMap, SoilMap, SoilCells, SType);
   InitVegMap(Options, Input, Map, VegMap, VType);
   if (Options->CanopyGapping)
     InitCanopyGapMap(Options, Input, Map, Soil, Veg, VType, VegMap, SType, SoilMap);
@@ -69,12 +70,13 @@ void InitTopoMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   };
 
   /* Process the [TERRAIN] section in the input file */
+  /* The rows point into a single NY * NX block */
   if (!(*TopoMap = (TOPOPIX **)calloc(Map->NY, sizeof(TOPOPIX *))))
     ReportError((char *)Routine, 1);
-  for (y = 0; y < Map->NY; y++) {
-    if (!((*TopoMap)[y] = (TOPOPIX *)calloc(Map->NX, sizeof(TOPOPIX))))
-      ReportError((char *)Routine, 1);
-  }
+  if (!((*TopoMap)[0] = (TOPOPIX *)calloc(Map->NY * Map->NX, sizeof(TOPOPIX))))
+    ReportError((char *)Routine, 1);
+  for (y = 1; y < Map->NY; y++)
+    (*TopoMap)[y] = (*TopoMap)[0] + y * Map->NX;
 
   /* Read the key-entry pairs from the input file */
   for (i = 0; StrEnv[i].SectionName; i++) {
@@ -166,16 +168,59 @@ void InitTopoMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
       }
     }
   }
+
+  InitBasinIndex(Map, *TopoMap);
+}
+
+/*****************************************************************************
+  InitBasinIndex()
+
+  Number the cells inside the basin mask in row-major order.  Map->BasinCell
+  lists the grid offset of each basin cell and Map->BasinIndex gives, for
+  every grid cell, its position in that list or -1.  Layered soil variables
+  are stored by basin cell (see InitSoilMap()).
+*****************************************************************************/
+void InitBasinIndex(MAPSIZE *Map, TOPOPIX **TopoMap)
+{
+  const char *Routine = "InitBasinIndex";
+  int i;			/* Counter */
+  int x;			/* Counter */
+  int y;			/* Counter */
+
+  Map->NumCells = 0;
+  for (y = 0; y < Map->NY; y++)
+    for (x = 0; x < Map->NX; x++)
+      if (INBASIN(TopoMap[y][x].Mask))
+        Map->NumCells++;
+
+  if (!(Map->BasinCell = (int *)calloc(Map->NumCells > 0 ? Map->NumCells : 1,
+    sizeof(int))))
+    ReportError((char *)Routine, 1);
+  if (!(Map->BasinIndex = (int *)calloc(Map->NY * Map->NX, sizeof(int))))
+    ReportError((char *)Routine, 1);
+
+  for (y = 0, i = 0; y < Map->NY; y++) {
+    for (x = 0; x < Map->NX; x++) {
+      if (INBASIN(TopoMap[y][x].Mask)) {
+        Map->BasinCell[i] = y * Map->NX + x;
+        Map->BasinIndex[y * Map->NX + x] = i++;
+      }
+      else
+        Map->BasinIndex[y * Map->NX + x] = -1;
+    }
+  }
 }
 
 /*****************************************************************************
   InitSoilMap()
 *****************************************************************************/
 void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
-  LAYER * Soil, TOPOPIX ** TopoMap, SOILPIX *** SoilMap, SOILTABLE * SType)
+  LAYER * Soil, TOPOPIX ** TopoMap, SOILPIX *** SoilMap, SOILCELLS * SoilCells,
+  SOILTABLE * SType)
 {
   const char *Routine = "InitSoilMap";
   char VarName[BUFSIZE + 1];	/* Variable name */
+  int c;			/* basin cell */
   int i;			/* counter */
   int x;			/* counter */
   int y;			/* counter */
@@ -188,6 +233,10 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   int flag;
   int NSet;
   int sidx;
+  float *Layers;		/* Storage for FCap or Porosity of all cells */
+  float *Moist;			/* Storage for Moist of all basin cells */
+  float *Perc;			/* Storage for Perc of all basin cells */
+  float *Temp;			/* Storage for Temp of all basin cells */
   
   STRINIENTRY StrEnv[] = {
     {"SOILS", "SOIL MAP FILE", "", ""},
@@ -200,12 +249,24 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
 
   /* Process the filenames in the [SOILS] section in the input file */
   /* Assign the attributes to the correct map pixel */
+  /* The rows point into a single NY * NX block */
   if (!(*SoilMap = (SOILPIX **)calloc(Map->NY, sizeof(SOILPIX *))))
     ReportError((char *)Routine, 1);
-  for (y = 0; y < Map->NY; y++) {
-    if (!((*SoilMap)[y] = (SOILPIX *)calloc(Map->NX, sizeof(SOILPIX))))
-      ReportError((char *)Routine, 1);
-  }
+  if (!((*SoilMap)[0] = (SOILPIX *)calloc(Map->NY * Map->NX, sizeof(SOILPIX))))
+    ReportError((char *)Routine, 1);
+  for (y = 1; y < Map->NY; y++)
+    (*SoilMap)[y] = (*SoilMap)[0] + y * Map->NX;
+
+  /* The routing variables have one entry per basin cell, in the order of
+     Map->BasinCell */
+  if (!(SoilCells->Depth = (float *)calloc(Map->NumCells, sizeof(float))))
+    ReportError((char *)Routine, 1);
+  if (!(SoilCells->TableDepth = (float *)calloc(Map->NumCells, sizeof(float))))
+    ReportError((char *)Routine, 1);
+  if (!(SoilCells->KsLat = (float *)calloc(Map->NumCells, sizeof(float))))
+    ReportError((char *)Routine, 1);
+  if (!(SoilCells->SatFlow = (float *)calloc(Map->NumCells, sizeof(float))))
+    ReportError((char *)Routine, 1);
 
   /* Read the key-entry pairs from the input file */
   for (i = 0; StrEnv[i].SectionName; i++) {
@@ -261,14 +322,16 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   {
     for (y = 0, i = 0; y < Map->NY; y++) {
       for (x = 0; x < Map->NX; x++, i++) {
-        (*SoilMap)[y][x].Depth = Depth[i];
+        if ((c = Map->BasinIndex[y * Map->NX + x]) >= 0)
+          SoilCells->Depth[c] = Depth[i];
       }
     }
   }
   else if (Options->FileFormat == NETCDF && flag == 1) {
     for (y = Map->NY - 1, i = 0; y >= 0; y--) {
       for (x = 0; x < Map->NX; x++, i++) {
-        (*SoilMap)[y][x].Depth = Depth[i];
+        if ((c = Map->BasinIndex[y * Map->NX + x]) >= 0)
+          SoilCells->Depth[c] = Depth[i];
       }
     }
   }
@@ -292,20 +355,24 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
       {
         for (y = 0, i = 0; y < Map->NY; y++) {
           for (x = 0; x < Map->NX; x++, i++) {
+            if ((c = Map->BasinIndex[y * Map->NX + x]) < 0)
+              continue;
             if (KsLat[i] > 0.0)
-              (*SoilMap)[y][x].KsLat = KsLat[i]/1000.0;
+              SoilCells->KsLat[c] = KsLat[i]/1000.0;
             else
-              (*SoilMap)[y][x].KsLat = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
+              SoilCells->KsLat[c] = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
           }
         }
       }
       else if (Options->FileFormat == NETCDF && flag == 1) {
         for (y = Map->NY - 1, i = 0; y >= 0; y--) {
           for (x = 0; x < Map->NX; x++, i++) {
+            if ((c = Map->BasinIndex[y * Map->NX + x]) < 0)
+              continue;
             if (KsLat[i] > 0.0)
-              (*SoilMap)[y][x].KsLat = KsLat[i]/1000.0;
+              SoilCells->KsLat[c] = KsLat[i]/1000.0;
             else
-              (*SoilMap)[y][x].KsLat = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
+              SoilCells->KsLat[c] = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
           }
         }
       }
@@ -315,10 +382,10 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   }
   else{
     printf("Spatial lateral conductivity map not provided, generating map\n");
-    for (y = 0, i = 0; y < Map->NY; y++) {
-      for (x = 0; x < Map->NX; x++, i++) {
-          (*SoilMap)[y][x].KsLat = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
-      }
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      SoilCells->KsLat[c] = SType[(*SoilMap)[y][x].Soil - 1].KsLat;
     }
   }
 
@@ -326,12 +393,15 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   /* Read the spatial field capacity map */
   GetVarNumberType(014, &NumberType);
 
-  /*Allocate memory*/  
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (!((*SoilMap)[y][x].FCap =
-            (float *)calloc(Soil->MaxLayers, sizeof(float *))))
-        ReportError((char *)Routine, 1);
+  /*Allocate memory for all grid cells in one block.  Each cell has one
+    more entry than MaxLayers, which stays zero: InitModelState() compares
+    the moisture below the deepest root layer with FCap[NLayers]*/  
+  if (!(Layers = (float *)calloc(Map->NY * Map->NX * (Soil->MaxLayers + 1),
+        sizeof(float))))
+    ReportError((char *)Routine, 1);
+  for (y = 0, i = 0; y < Map->NY; y++) {
+    for (x = 0; x < Map->NX; x++, i++) {
+      (*SoilMap)[y][x].FCap = Layers + i * (Soil->MaxLayers + 1);
     }
   }
   /*Creating spatial layered field capacity*/
@@ -406,12 +476,13 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
   //
   /* Read the spatial porosity map */
   GetVarNumberType(013, &NumberType);
-  /*Allocate memory for porosity*/  
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (!((*SoilMap)[y][x].Porosity =
-            (float *)calloc(Soil->MaxLayers, sizeof(float *))))
-        ReportError((char *)Routine, 1);
+  /*Allocate memory for porosity, laid out like FCap*/  
+  if (!(Layers = (float *)calloc(Map->NY * Map->NX * (Soil->MaxLayers + 1),
+        sizeof(float))))
+    ReportError((char *)Routine, 1);
+  for (y = 0, i = 0; y < Map->NY; y++) {
+    for (x = 0; x < Map->NX; x++, i++) {
+      (*SoilMap)[y][x].Porosity = Layers + i * (Soil->MaxLayers + 1);
     }
   }
   /*Creating spatial layered porosity*/
@@ -492,24 +563,31 @@ void InitSoilMap(LISTPTR Input, OPTIONSTRUCT * Options, MAPSIZE * Map,
    /******************************************************************/
    /******************************************************************/
 
+  /* allocate memory for the number of root layers, plus an additional
+     layer below the deepest root layer.  Each variable is one block with
+     room for the deepest soil type in every basin cell, in the order of
+     Map->BasinCell.  Moist is the one of SoilCells */
+  if (!(Moist = (float *)calloc(Map->NumCells * (Soil->MaxLayers + 1),
+        sizeof(float))))
+    ReportError((char *)Routine, 1);
+  SoilCells->NLayers = Soil->MaxLayers + 1;
+  SoilCells->Moist = Moist;
+  if (!(Perc = (float *)calloc(Map->NumCells * Soil->MaxLayers, sizeof(float))))
+    ReportError((char *)Routine, 1);
+  if (!(Temp = (float *)calloc(Map->NumCells * Soil->MaxLayers, sizeof(float))))
+    ReportError((char *)Routine, 1);
+
   for (y = 0, i = 0; y < Map->NY; y++) {
     for (x = 0; x < Map->NX; x++, i++) {
       if (Options->Infiltration == DYNAMIC)
         (*SoilMap)[y][x].InfiltAcc = 0.;
       (*SoilMap)[y][x].MoistInit = 0.;
 
-      /* allocate memory for the number of root layers, plus an additional
-       layer below the deepest root layer */
       if (INBASIN(TopoMap[y][x].Mask)) {
-        if (!((*SoilMap)[y][x].Moist =
-          (float *)calloc((Soil->NLayers[Type[i] - 1] + 1), sizeof(float))))
-          ReportError((char *)Routine, 1);
-        if (!((*SoilMap)[y][x].Perc =
-          (float *)calloc(Soil->NLayers[Type[i] - 1], sizeof(float))))
-          ReportError((char *)Routine, 1);
-        if (!((*SoilMap)[y][x].Temp =
-          (float *)calloc(Soil->NLayers[Type[i] - 1], sizeof(float))))
-          ReportError((char *)Routine, 1);
+        c = Map->BasinIndex[i];
+        (*SoilMap)[y][x].Moist = Moist + c * (Soil->MaxLayers + 1);
+        (*SoilMap)[y][x].Perc = Perc + c * Soil->MaxLayers;
+        (*SoilMap)[y][x].Temp = Temp + c * Soil->MaxLayers;
       }
       else {
         (*SoilMap)[y][x].Moist = NULL;
@@ -32,19 +32,31 @@ enum KEY { travel_file, hydrograph_file };
 /*****************************************************************************
   Function name: InitUnitHydrograph()
 
-  Purpose      :
+  Purpose      : Read the travel times and the unit hydrograph, and set up
+                 the hydrograph
 
   Required     :
+    LISTPTR Input                 - Linked list with input strings
+    MAPSIZE *Map                  - Model area
+    int Dt                        - Model time step (s)
+    TOPOPIX **TopoMap             - Terrain, gets the travel times
+    UNITHYDR ***UnitHydrograph    - Unit hydrograph of each travel time
+    float **Hydrograph            - Hydrograph ring buffer
+    UNITHYDRINFO *HydrographInfo  - Hydrograph dimensions
 
   Returns      : void
 
-  Modifies     :
+  Modifies     : TopoMap, UnitHydrograph, Hydrograph, HydrographInfo
 
-  Comments     :
+  Comments     : The time steps of the unit hydrograph are in seconds.  All
+                 the flow that arrives within the same model time step is
+                 summed into one bin, so the hydrograph is a ring buffer of
+                 NBins bins of Dt seconds, and each travel time class has its
+                 unit hydrograph summed per bin (see RouteSurface()).
 *****************************************************************************/
-void InitUnitHydrograph(LISTPTR Input, MAPSIZE * Map, TOPOPIX ** TopoMap,
-			UNITHYDR *** UnitHydrograph, float **Hydrograph,
-			UNITHYDRINFO * HydrographInfo)
+void InitUnitHydrograph(LISTPTR Input, MAPSIZE * Map, int Dt,
+			TOPOPIX ** TopoMap, UNITHYDR *** UnitHydrograph,
+			float **Hydrograph, UNITHYDRINFO * HydrographInfo)
 {
   const char *Routine = "InitUnitHydrograph()";
   char VarName[BUFSIZE + 1];	/* Variable name */
@@ -53,6 +65,8 @@ void InitUnitHydrograph(LISTPTR Input, MAPSIZE * Map, TOPOPIX ** TopoMap,
   int NumberType;
   int TravelTimeStep;
   int WaveLength;
+  int MaxLag;
+  int Bin;
   int i;
   int j;
   int x;
@@ -122,9 +136,43 @@ void InitUnitHydrograph(LISTPTR Input, MAPSIZE * Map, TOPOPIX ** TopoMap,
   HydrographInfo->TotalWaveLength =
     (*UnitHydrograph)[MaxTravelTime - 1][WaveLength - 1].TimeStep + 1;
 
-  if (!(*Hydrograph = (float *) calloc(HydrographInfo->TotalWaveLength,
-				       sizeof(float))))
+  fclose(HydrographFile);
+
+  /* sum the unit hydrograph of each travel time class per bin */
+  MaxLag = HydrographInfo->TotalWaveLength - 1;
+  for (i = 0; i < MaxTravelTime; i++)
+    for (j = 0; j < HydrographInfo->WaveLength[i]; j++)
+      if ((*UnitHydrograph)[i][j].TimeStep > MaxLag)
+	MaxLag = (*UnitHydrograph)[i][j].TimeStep;
+
+  HydrographInfo->Dt = Dt;
+  HydrographInfo->NBins = MaxLag / Dt + 1;
+  HydrographInfo->Head = 0;
+
+  if (!(HydrographInfo->NClassBins = (int *) calloc(MaxTravelTime,
+						    sizeof(int))))
+    ReportError((char *) Routine, 1);
+  if (!(HydrographInfo->ClassBins = (double **) calloc(MaxTravelTime,
+						       sizeof(double *))))
+    ReportError((char *) Routine, 1);
+  if (!(HydrographInfo->ClassRunoff = (double *) calloc(MaxTravelTime,
+							sizeof(double))))
     ReportError((char *) Routine, 1);
 
-  fclose(HydrographFile);
+  for (i = 0; i < MaxTravelTime; i++) {
+    for (j = 0; j < HydrographInfo->WaveLength[i]; j++) {
+      Bin = (*UnitHydrograph)[i][j].TimeStep / Dt + 1;
+      if (Bin > HydrographInfo->NClassBins[i])
+	HydrographInfo->NClassBins[i] = Bin;
+    }
+    if (!(HydrographInfo->ClassBins[i] =
+	  (double *) calloc(HydrographInfo->NClassBins[i] + 1, sizeof(double))))
+      ReportError((char *) Routine, 1);
+    for (j = 0; j < HydrographInfo->WaveLength[i]; j++)
+      HydrographInfo->ClassBins[i][(*UnitHydrograph)[i][j].TimeStep / Dt] +=
+	(*UnitHydrograph)[i][j].Fraction;
+  }
+
+  if (!(*Hydrograph = (float *) calloc(HydrographInfo->NBins, sizeof(float))))
+    ReportError((char *) Routine, 1);
 }
@@ -38,7 +38,7 @@ int DayStep
 unsigned char PrecipType
 int NStats
 METLOCATION *Stat
-uchar *MetWeights
+METWEIGHTS *MetWeights - Nonzero interpolation weights of all pixels
 float LocalElev
 RADCLASSPIX *RadMap 
 PRECIPPIX *PrecipMap
@@ -56,7 +56,7 @@ Handbook of hydrology,  1993, McGraw-Hill, New York, etc..
 *****************************************************************************/
 PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
                         OPTIONSTRUCT *Options, int NStats,
-                        METLOCATION *Stat, uchar *MetWeights,
+                        METLOCATION *Stat, METWEIGHTS *MetWeights,
                         float LocalElev, PIXRAD *RadMap,
                         PRECIPPIX *PrecipMap, MAPSIZE *Radar,
                         RADARPIX **RadarMap, float **PrismMap,
@@ -72,7 +72,9 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
                             WindSource == MODEL */
   float Temp;			/* Temporary variable */
   float WeightSum;		/* sum of the weights */
-  int i,j;			/* counter */
+  METWEIGHT *Weight;		/* nonzero weights of the pixel */
+  int NWeights;			/* number of nonzero weights */
+  int i,j,k;			/* counter */
   int RadarX;			/* X coordinate of radar map coordinate */
   int RadarY;			/* Y coordinate of radar map coordinate */
   float TempLapseRate;
@@ -88,10 +90,19 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
   LocalMet.Lin = 0.0;
   TempLapseRate = 0.0;
 
+  /* only the stations with a nonzero weight contribute */
+  Weight = NULL;
+  NWeights = 0;
+  if (MetWeights->Start != NULL) {
+    Weight = MetWeights->Weight + MetWeights->Start[y * Map->NX + x];
+    NWeights = (int) (MetWeights->Start[y * Map->NX + x + 1] -
+                      MetWeights->Start[y * Map->NX + x]);
+  }
+
   if (Options->MM5 == TRUE && Options->QPF == TRUE) {
     WeightSum = 0.0;
-    for (i = 0; i < NStats; i++)
-      WeightSum += (float) MetWeights[i];
+    for (k = 0; k < NWeights; k++)
+      WeightSum += (float) Weight[k].Weight;
   }
 
   if (Options->MM5 == TRUE) {
@@ -123,15 +134,19 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
   }
   else {			/* MM5 is false and we need to interpolate the basic met records */
     WeightSum = 0.0;
-    for (i = 0; i < NStats; i++) {
-      WeightSum += (float) MetWeights[i];
-      if (Options->WindSource == MODEL && Stat[i].IsWindModelLocation) {
-        ScaleWind = Stat[i].Data.Wind;
-        WindDirection = Stat[i].Data.WindDirection;
+    for (k = 0; k < NWeights; k++)
+      WeightSum += (float) Weight[k].Weight;
+    if (Options->WindSource == MODEL) {
+      for (i = 0; i < NStats; i++) {
+        if (Stat[i].IsWindModelLocation) {
+          ScaleWind = Stat[i].Data.Wind;
+          WindDirection = Stat[i].Data.WindDirection;
+        }
       }
     }
-    for (i = 0; i < NStats; i++) {
-      CurrentWeight = ((float) MetWeights[i]) / WeightSum;
+    for (k = 0; k < NWeights; k++) {
+      i = Weight[k].Station;
+      CurrentWeight = ((float) Weight[k].Weight) / WeightSum;
       LocalMet.Tair += CurrentWeight *
         LapseT(Stat[i].Data.Tair, Stat[i].Elev, LocalElev,
         Stat[i].Data.TempLapse);
@@ -232,8 +247,9 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
       PrecipMap->Precip = 0.0;
       PrecipMap->SnowFall = 0.0;
 	  PrecipMap->RainFall = 0.0;
-      for (i = 0; i < NStats; i++) {
-        CurrentWeight = ((float) MetWeights[i]) / WeightSum;
+      for (k = 0; k < NWeights; k++) {
+        i = Weight[k].Station;
+        CurrentWeight = ((float) Weight[k].Weight) / WeightSum;
         if (Options->PrecipLapse == MAP)
           PrecipMap->Precip += CurrentWeight *
           LapsePrecip(Stat[i].Data.Precip, 0, 1, PrecipLapseMap[y][x], precipMultiplier);
@@ -252,8 +268,9 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
     }
     else if (Options->PrecipType == STATION && Options->Prism == TRUE) {
       PrecipMap->Precip = 0.0;
-      for (i = 0; i < NStats; i++) {
-        CurrentWeight = ((float) MetWeights[i]) / WeightSum;
+      for (k = 0; k < NWeights; k++) {
+        i = Weight[k].Station;
+        CurrentWeight = ((float) Weight[k].Weight) / WeightSum;
         /* this is the real prism interpolation */
         /* note that X = position from left  boundary, ie # of columns */
         /* note that Y = position from upper boundary, ie # of rows   */
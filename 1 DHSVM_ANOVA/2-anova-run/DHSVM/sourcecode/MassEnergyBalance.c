@@ -41,7 +41,13 @@
 
    Modifies     :
 
-   Comments     :
+   Comments     : Only the state of pixel (y, x) is changed, so that pixels
+                  can be processed in parallel.  The precipitation on the
+                  stream channel is returned in ChannelInflow; it, the
+                  radiation totals and the stream temperature inputs are
+                  added up by the caller (see RunModel()).  SoilDepth,
+                  SatFlow and TableDepth are the SOILCELLS entries of the
+                  pixel.
 
    Reference    :
      Epema, G.F. and H.T. Riezbos, 1983, Fall Velocity of waterdrops at different
@@ -58,9 +64,9 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x,
   int InfiltOption, int MaxSoilLayers, int MaxVegLayers, PIXMET *LocalMet,
   ROADSTRUCT *LocalNetwork, PRECIPPIX *LocalPrecip,
   VEGTABLE *VType, VEGPIX *LocalVeg, SOILTABLE *SType,
-  SOILPIX *LocalSoil, SNOWPIX *LocalSnow, PIXRAD *LocalRad,
-  EVAPPIX *LocalEvap, PIXRAD *TotalRad, CHANNEL *ChannelData,
-  float **skyview)
+  SOILPIX *LocalSoil, float SoilDepth, float SatFlow, float *TableDepth,
+  SNOWPIX *LocalSnow, PIXRAD *LocalRad,
+  EVAPPIX *LocalEvap, CHANNEL *ChannelData, float *ChannelInflow)
 {
   float SurfaceWater;		/* Pixel average depth of water before infiltration is calculated (m) */
   float RoadWater;          /* Average depth of water on the road surface
@@ -100,14 +106,16 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x,
   double Tmp;			    /* Temporary value */
   float Ls;			        /* Latent heat of sublimation (J/kg) */
 
+  *ChannelInflow = 0.;
+
   /* Edited by Zhuoran Duan zhuoran.duan@pnnl.gov 06/21/2006*/
   /*Add a function to modify soil moisture by add/extract SatFlow from previous time step*/
-  DistributeSatflow(Dt, DX, DY, LocalSoil->SatFlow, SType->NLayers,
-    LocalSoil->Depth, LocalNetwork->Area, VType->RootDepth,
+  DistributeSatflow(Dt, DX, DY, SatFlow, SType->NLayers,
+    SoilDepth, LocalNetwork->Area, VType->RootDepth,
     SType->Ks, SType->PoreDist, LocalSoil->Porosity, LocalSoil->FCap,
     LocalSoil->Perc, LocalNetwork->PercArea,
     LocalNetwork->Adjust, LocalNetwork->CutBankZone,
-    LocalNetwork->BankHeight, &(LocalSoil->TableDepth),
+    LocalNetwork->BankHeight, TableDepth,
     &(LocalSoil->IExcess), LocalSoil->Moist, InfiltOption);
 
   /* Calculate the number of vegetation layers above the snow.
@@ -463,13 +471,13 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x,
 
   /* ChannelWater is precipitation falling on the channel */
   /* (if there is no road, LocalNetwork->RoadArea = 0) */
-  if (channel_grid_has_channel(ChannelData->stream_map, x, y)) {
+  if (channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
     PercArea = 1. - (LocalNetwork->Area + LocalNetwork->RoadArea) / (DX*DY);
     ChannelWater = LocalNetwork->Area / (DX*DY) * LocalPrecip->RainFall;
   }
   /* If there is a road and no channel, the PercArea is
      based on the road only */
-  else if (channel_grid_has_channel(ChannelData->road_map, x, y)) {
+  else if (channel_lookup_has_channel(ChannelData->road_lookup, x, y)) {
     PercArea = 1. - (LocalNetwork->RoadArea) / (DX*DY);
     MaxRoadbedInfiltration = (1. - PercArea) *
       LocalNetwork->MaxInfiltrationRate * Dt;
@@ -536,17 +544,17 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x,
 
   /*Add water that hits the channel network to the channel network */
   if (ChannelWater > 0.) {
-    channel_grid_inc_inflow(ChannelData->stream_map, x, y, ChannelWater * DX * DY);
+    *ChannelInflow = ChannelWater * DX * DY;
     LocalSoil->ChannelInt += ChannelWater;
   }
 
   /* Calculate unsaturated soil water movement, and adjust soil water table depth */
   UnsaturatedFlow(Dt, DX, DY, Infiltration, RoadbedInfiltration,
-    LocalSoil->SatFlow, SType->NLayers, LocalSoil->Depth,
+    SatFlow, SType->NLayers, SoilDepth,
     LocalNetwork->Area, VType->RootDepth, SType->Ks,
     SType->PoreDist, LocalSoil->Porosity, LocalSoil->FCap, LocalSoil->Perc,
     LocalNetwork->PercArea, LocalNetwork->Adjust, LocalNetwork->CutBankZone,
-    LocalNetwork->BankHeight, &(LocalSoil->TableDepth), &(LocalSoil->IExcess),
+    LocalNetwork->BankHeight, TableDepth, &(LocalSoil->IExcess),
     LocalSoil->Moist, InfiltOption);
 
   /* Infiltration is updated in UnsaturatedFlow and accumulated
@@ -575,15 +583,4 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x,
   }
   else
     NoSensibleHeatFlux(Dt, LocalMet, LocalVeg->MoistureFlux, LocalSoil);
-
-
-  /* add the components of the radiation balance for the current pixel to
-     the total */
-  AggregateRadiation(MaxVegLayers, VType->NVegLayers, LocalRad, TotalRad);
-
-  /* For RBM model, save the energy fluxes for outputs */
-  if (Options->StreamTemp) {
-    if (channel_grid_has_channel(ChannelData->stream_map, x, y))
-      channel_grid_inc_other(ChannelData->stream_map, x, y, LocalRad, LocalMet, skyview[y][x]);
-  }
 }
@@ -0,0 +1,333 @@
+/*
+ * SUMMARY:      MetCache.c - Binary cache of the station met records
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  The station files are text, and every run parses them again
+ *               record by record.  InitMetCache() reads them once for the
+ *               whole run period with ReadMetRecord(), so the bounds checks
+ *               and their warnings happen once, and writes the records to a
+ *               binary file (see metcache.h).  Later runs and other processes
+ *               with the same stations, period and met options map that file
+ *               into memory, and ReadMetCache() copies the records of all
+ *               stations for a time step from one contiguous slice instead of
+ *               reading the station files.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitMetCache()
+ *               ReadMetCache()
+ * COMMENTS:     The station files are only needed to write the cache.  They
+ *               are opened one at a time for that, and closed once the cache
+ *               is mapped, so thousands of gridded met files do not stay
+ *               open.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "fileio.h"
+#include "functions.h"
+#include "constants.h"
+#include "metcache.h"
+
+static int MapMetCache(char *FileName, METCACHEHEADER *Header,
+		       METCACHESOURCE *Source, METLOCATION *Stat);
+static void WriteMetCache(char *FileName, OPTIONSTRUCT *Options,
+			  TIMESTRUCT *Time, METCACHEHEADER *Header,
+			  METCACHESOURCE *Source, METLOCATION *Stat);
+
+static int MetCacheSteps = 0;	/* Number of time steps */
+static char MetCacheName[BUFSIZE + 1];	/* Met cache file */
+
+/*****************************************************************************
+  Function name: InitMetCache()
+
+  Purpose      : Point the stations to their records in the met cache,
+                 writing the cache first if it is missing or out of date
+
+  Required     :
+    char *FileName        - Met cache file
+    OPTIONSTRUCT *Options - Met options
+    TIMESTRUCT *Time      - Run period, Current must be the start
+    int NSoilLayers       - Number of soil layers
+    int NStats            - Number of stations
+    METLOCATION *Stat     - Stations
+
+  Returns      : void
+
+  Modifies     : Stat[i].MetCache, and Stat[i].MetFile.FilePtr, which is
+                 closed
+
+  Comments     : The cache is out of date if the period, the met options or
+                 the size or modification time of a station file differ.  A
+                 new cache is written under a temporary name and renamed, so
+                 processes that start at the same time never see a partial
+                 file.
+*****************************************************************************/
+void InitMetCache(char *FileName, OPTIONSTRUCT *Options, TIMESTRUCT *Time,
+		  int NSoilLayers, int NStats, METLOCATION *Stat)
+{
+  const char *Routine = "InitMetCache";
+  METCACHEHEADER Header;
+  METCACHESOURCE *Source;
+  TIMESTRUCT Step;
+  struct stat FileStat;
+  int i;
+
+  strcpy(MetCacheName, FileName);
+
+  /* the steps of the run, counted the way RunModel() loops over them */
+  Step = *Time;
+  MetCacheSteps = 0;
+  while (Before(&(Step.Current), &(Step.End)) ||
+	 IsEqualTime(&(Step.Current), &(Step.End))) {
+    MetCacheSteps++;
+    IncreaseTime(&Step);
+  }
+
+  memset(&Header, 0, sizeof(METCACHEHEADER));
+  memcpy(Header.Magic, METCACHE_MAGIC, sizeof(Header.Magic));
+  Header.StartJulian = Time->Current.Julian;
+  Header.Dt = Time->Dt;
+  Header.NSteps = MetCacheSteps;
+  Header.NStats = NStats;
+  Header.NVars = METCACHE_NVARS;
+  Header.NSoilLayers = NSoilLayers;
+  Header.Options = (Options->HeatFlux == TRUE) |
+    (Options->PrecipType == STATION) << 1 | (Options->PrecipSepr != 0) << 2 |
+    (Options->PrecipLapse == VARIABLE) << 3 |
+    (Options->TempLapse == VARIABLE) << 4;
+
+  if (!(Source = (METCACHESOURCE *) calloc(NStats, sizeof(METCACHESOURCE))))
+    ReportError((char *) Routine, 1);
+  for (i = 0; i < NStats; i++) {
+    if (stat(Stat[i].MetFile.FileName, &FileStat) == -1)
+      ReportError(Stat[i].MetFile.FileName, 3);
+    Source[i].Size = (long long) FileStat.st_size;
+    Source[i].MTime = (long long) FileStat.st_mtime;
+    Source[i].IsWindModelLocation = Stat[i].IsWindModelLocation;
+  }
+
+  if (MapMetCache(FileName, &Header, Source, Stat))
+    printf("Reading met records from cache %s\n", FileName);
+  else {
+    printf("Writing met cache %s\n", FileName);
+    WriteMetCache(FileName, Options, Time, &Header, Source, Stat);
+    if (!MapMetCache(FileName, &Header, Source, Stat))
+      ReportError(FileName, 5);
+  }
+
+  for (i = 0; i < NStats; i++) {
+    if (Stat[i].MetFile.FilePtr != NULL) {
+      fclose(Stat[i].MetFile.FilePtr);
+      Stat[i].MetFile.FilePtr = NULL;
+    }
+  }
+
+  free(Source);
+}
+
+/*****************************************************************************
+  Function name: ReadMetCache()
+
+  Purpose      : Copy the met records of a time step from the cache, the
+                 same fields that ReadMetRecord() fills
+
+  Required     :
+    OPTIONSTRUCT *Options - Met options
+    int Step              - Time step since the start of the run
+    int NSoilLayers       - Number of soil layers
+    int NStats            - Number of stations
+    METLOCATION *Stat     - Stations
+
+  Returns      : void
+
+  Modifies     : Stat[i].Data
+
+  Comments     : The records of the time step follow each other, starting at
+                 the record of the first station.
+*****************************************************************************/
+void ReadMetCache(OPTIONSTRUCT *Options, int Step, int NSoilLayers,
+		  int NStats, METLOCATION *Stat)
+{
+  MET *MetRecord;
+  float *Record;
+  int i;
+  int j;
+
+  if (Step < 0 || Step >= MetCacheSteps)
+    ReportError(MetCacheName, 28);
+  Record = Stat[0].MetCache + (size_t) Step * NStats * METCACHE_NVARS;
+
+  for (j = 0; j < NStats; j++, Record += METCACHE_NVARS) {
+    MetRecord = &(Stat[j].Data);
+
+    MetRecord->Tair = Record[mc_tair];
+    MetRecord->Wind = Record[mc_wind];
+    MetRecord->Rh = Record[mc_rh];
+    MetRecord->Sin = Record[mc_sin];
+    MetRecord->Lin = Record[mc_lin];
+
+    if (Options->HeatFlux == TRUE)
+      for (i = 0; i < NSoilLayers && i < 3; i++)
+	MetRecord->Tsoil[i] = Record[mc_tsoil + i];
+
+    MetRecord->Precip = Record[mc_precip];
+    if (Options->PrecipType == STATION && Options->PrecipSepr) {
+      MetRecord->Rain = Record[mc_rain];
+      MetRecord->Snow = Record[mc_snow];
+    }
+    MetRecord->PrecipLapse = Record[mc_preciplapse];
+    MetRecord->TempLapse = Record[mc_templapse];
+    MetRecord->WindDirection = (int) Record[mc_winddirection];
+  }
+}
+
+/*****************************************************************************
+  MapMetCache()
+
+  Map the cache if it exists and matches Header and Source.  Returns FALSE
+  otherwise.
+*****************************************************************************/
+static int MapMetCache(char *FileName, METCACHEHEADER *Header,
+		       METCACHESOURCE *Source, METLOCATION *Stat)
+{
+  struct stat FileStat;
+  size_t Offset;
+  size_t Size;
+  char *Map;
+  float *Data;
+  int fd;
+  int i;
+
+  Offset = sizeof(METCACHEHEADER) + Header->NStats * sizeof(METCACHESOURCE);
+  Size = Offset +
+    (size_t) Header->NStats * Header->NSteps * METCACHE_NVARS * sizeof(float);
+
+  if ((fd = open(FileName, O_RDONLY)) == -1)
+    return FALSE;
+  if (fstat(fd, &FileStat) == -1 || FileStat.st_size != (off_t) Size) {
+    close(fd);
+    return FALSE;
+  }
+
+  Map = (char *) mmap(NULL, Size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (Map == (char *) MAP_FAILED)
+    return FALSE;
+
+  if (memcmp(Map, Header, sizeof(METCACHEHEADER)) != 0 ||
+      memcmp(Map + sizeof(METCACHEHEADER), Source,
+	     Header->NStats * sizeof(METCACHESOURCE)) != 0) {
+    munmap(Map, Size);
+    return FALSE;
+  }
+
+  /* the mapping is kept for the life of the process, and read step by
+     step */
+  madvise(Map, Size, MADV_SEQUENTIAL);
+  Data = (float *) (Map + Offset);
+  for (i = 0; i < Header->NStats; i++)
+    Stat[i].MetCache = Data + (size_t) i * METCACHE_NVARS;
+
+  return TRUE;
+}
+
+/*****************************************************************************
+  WriteMetCache()
+
+  Read all the records of the run period from the station files and write
+  the cache.  The file is mapped writable and filled station by station, so
+  only one station file is open at a time.
+*****************************************************************************/
+static void WriteMetCache(char *FileName, OPTIONSTRUCT *Options,
+			  TIMESTRUCT *Time, METCACHEHEADER *Header,
+			  METCACHESOURCE *Source, METLOCATION *Stat)
+{
+  char TempName[BUFSIZE + 1];
+  float *Record;
+  TIMESTRUCT Step;
+  MET Met;
+  size_t Offset;
+  size_t Size;
+  char *Map;
+  float *Data;
+  int Opened;			/* Station file opened here */
+  int fd;
+  int i;
+  int j;
+  int t;
+
+  Offset = sizeof(METCACHEHEADER) + Header->NStats * sizeof(METCACHESOURCE);
+  Size = Offset +
+    (size_t) Header->NStats * Header->NSteps * METCACHE_NVARS * sizeof(float);
+
+  if (snprintf(TempName, sizeof(TempName), "%s.%d", FileName,
+	       (int) getpid()) >= (int) sizeof(TempName))
+    ReportError(FileName, 3);
+  if ((fd = open(TempName, O_RDWR | O_CREAT | O_TRUNC, 0666)) == -1)
+    ReportError(TempName, 3);
+  /* the space is reserved up front, so that a full disk is an error here
+     and not a fault while the mapping is filled */
+  if (posix_fallocate(fd, 0, (off_t) Size) != 0)
+    ReportError(TempName, 41);
+  Map = (char *) mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (Map == (char *) MAP_FAILED)
+    ReportError(TempName, 41);
+  close(fd);
+
+  memcpy(Map, Header, sizeof(METCACHEHEADER));
+  memcpy(Map + sizeof(METCACHEHEADER), Source,
+	 Header->NStats * sizeof(METCACHESOURCE));
+  Data = (float *) (Map + Offset);
+
+  for (i = 0; i < Header->NStats; i++) {
+    Opened = (Stat[i].MetFile.FilePtr == NULL);
+    if (Opened)
+      OpenFile(&(Stat[i].MetFile.FilePtr), Stat[i].MetFile.FileName, "r",
+	       FALSE);
+    rewind(Stat[i].MetFile.FilePtr);
+    Step = *Time;
+    for (t = 0; t < Header->NSteps; t++) {
+      memset(&Met, 0, sizeof(MET));
+      ReadMetRecord(Options, &(Step.Current), Header->NSoilLayers,
+		    &(Stat[i].MetFile), Stat[i].IsWindModelLocation, &Met);
+
+      Record = Data + ((size_t) t * Header->NStats + i) * METCACHE_NVARS;
+      Record[mc_tair] = Met.Tair;
+      Record[mc_wind] = Met.Wind;
+      Record[mc_rh] = Met.Rh;
+      Record[mc_sin] = Met.Sin;
+      Record[mc_lin] = Met.Lin;
+      Record[mc_precip] = Met.Precip;
+      Record[mc_rain] = Met.Rain;
+      Record[mc_snow] = Met.Snow;
+      Record[mc_preciplapse] = Met.PrecipLapse;
+      Record[mc_templapse] = Met.TempLapse;
+      Record[mc_winddirection] = (float) Met.WindDirection;
+      for (j = 0; j < 3; j++)
+	Record[mc_tsoil + j] = Met.Tsoil[j];
+
+      IncreaseTime(&Step);
+    }
+    if (Opened) {
+      fclose(Stat[i].MetFile.FilePtr);
+      Stat[i].MetFile.FilePtr = NULL;
+    }
+    else
+      rewind(Stat[i].MetFile.FilePtr);
+  }
+
+  if (munmap(Map, Size) != 0)
+    ReportError(TempName, 41);
+  if (rename(TempName, FileName) != 0)
+    ReportError(FileName, 41);
+}
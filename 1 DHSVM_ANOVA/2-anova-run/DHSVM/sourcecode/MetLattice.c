@@ -0,0 +1,304 @@
+/*
+ * SUMMARY:      MetLattice.c - Regular grid of the gridded met forcing
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Gridded met forcing comes as one file per point of a regular
+ *               latitude / longitude grid.  InitMetLattice() finds that grid
+ *               from the coordinates in the file names, so that the GRIDCELL
+ *               and BILINEAR interpolation can find the grid points around a
+ *               pixel by index arithmetic instead of by distance.
+ *               MetLatticePosition() gives the position of a pixel in grid
+ *               units, inverting the projection of the grid onto the model
+ *               area cell by cell.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitMetLattice()
+ *               MetLatticeNode()
+ *               MetLatticePosition()
+ * COMMENTS:     Grid point (r, c) is at latitude Lat0 + r * DLat and
+ *               longitude Lon0 + c * DLon.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+
+#define MAXLATTICEITER 20	/* Newton iterations in MetLatticePosition() */
+
+static int LatticeAxis(int NPoints, float *Value, double Tiny, float *First,
+		       float *Step, int *NSteps);
+static int CompareFloat(const void *A, const void *B);
+
+/*****************************************************************************
+  Function name: InitMetLattice()
+
+  Purpose      : Find the regular grid that the gridded met files are on
+
+  Required     :
+    GRID *Grid     - Gridded met information
+    MAPSIZE *Map   - Model area
+    int NPoints    - Number of met files
+    float *Lat     - Latitude of each met file
+    float *Lon     - Longitude of each met file
+
+  Returns      : void
+
+  Modifies     : The grid members of Grid.  Node is set to -1 for all grid
+                 points, InitGridMet() fills in the stations it uses.
+
+  Comments     : All files in the met file path count, also the ones outside
+                 the model area, so that the grid is the same for every
+                 basin.  The grid may have points without a file.
+*****************************************************************************/
+void InitMetLattice(GRID *Grid, MAPSIZE *Map, int NPoints, float *Lat,
+		    float *Lon)
+{
+  const char *Routine = "InitMetLattice";
+  double Tiny;			/* Coordinates closer than this are equal */
+  float North;
+  float East;
+  int NNodes;
+  int c;
+  int n;
+  int r;
+
+  /* the coordinates in the file names have Decimal digits */
+  Tiny = 0.5 * pow(10.0, (double) -Grid->Decimal);
+
+  if (!LatticeAxis(NPoints, Lat, Tiny, &(Grid->Lat0), &(Grid->DLat),
+		   &(Grid->NLat)) ||
+      !LatticeAxis(NPoints, Lon, Tiny, &(Grid->Lon0), &(Grid->DLon),
+		   &(Grid->NLon)) ||
+      (double) Grid->NLat * Grid->NLon > 100.0 * NPoints)
+    ReportError(Grid->filepath, 72);
+
+  NNodes = Grid->NLat * Grid->NLon;
+  if (!(Grid->Node = (int *) calloc(NNodes, sizeof(int))))
+    ReportError((char *) Routine, 1);
+  if (!(Grid->NodeN = (float *) calloc(NNodes, sizeof(float))))
+    ReportError((char *) Routine, 1);
+  if (!(Grid->NodeE = (float *) calloc(NNodes, sizeof(float))))
+    ReportError((char *) Routine, 1);
+
+  /* the pixel coordinates of the grid points, as for the stations in
+     InitGridMet() but without rounding */
+  for (r = 0; r < Grid->NLat; r++) {
+    for (c = 0; c < Grid->NLon; c++) {
+      n = r * Grid->NLon + c;
+      deg2utm(Grid->Lat0 + r * Grid->DLat, Grid->Lon0 + c * Grid->DLon,
+	      &East, &North, Grid->utmzone);
+      Grid->Node[n] = -1;
+      Grid->NodeN[n] = ((Map->Yorig - 0.5 * Map->DY) - North) / Map->DY;
+      Grid->NodeE[n] = (East - (Map->Xorig + 0.5 * Map->DX)) / Map->DX;
+    }
+  }
+
+  printf("Met grid of %d latitudes from %f by %f and %d longitudes from %f by %f\n",
+	 Grid->NLat, Grid->Lat0, Grid->DLat, Grid->NLon, Grid->Lon0,
+	 Grid->DLon);
+}
+
+/*****************************************************************************
+  Function name: MetLatticeNode()
+
+  Purpose      : Find the grid point of a met file
+
+  Required     :
+    GRID *Grid - Gridded met information, after InitMetLattice()
+    float Lat  - Latitude of the met file
+    float Lon  - Longitude of the met file
+
+  Returns      : int - Index of the grid point in Grid->Node
+*****************************************************************************/
+int MetLatticeNode(GRID *Grid, float Lat, float Lon)
+{
+  int r;
+  int c;
+
+  r = Round((Lat - Grid->Lat0) / Grid->DLat);
+  c = Round((Lon - Grid->Lon0) / Grid->DLon);
+  if (r < 0 || r >= Grid->NLat || c < 0 || c >= Grid->NLon)
+    ReportError(Grid->filepath, 72);
+
+  return r * Grid->NLon + c;
+}
+
+/*****************************************************************************
+  Function name: MetLatticePosition()
+
+  Purpose      : Find the position of a pixel in the met grid
+
+  Required     :
+    GRID *Grid  - Gridded met information, after InitMetLattice()
+    double N    - Model row of the pixel
+    double E    - Model column of the pixel
+    double *Row - Start value of the latitude index
+    double *Col - Start value of the longitude index
+
+  Returns      : void
+
+  Modifies     : *Row and *Col, the fractional latitude and longitude index
+                 of the pixel
+
+  Comments     : Within a cell of the grid, the projected position is taken
+                 bilinear between the four grid points, and Newton's method
+                 finds the indices that project onto the pixel.  Outside the
+                 grid the edge cells are extended.  The projection is close
+                 to linear, so starting from the position of the previous
+                 pixel, a step or two is enough.
+*****************************************************************************/
+void MetLatticePosition(GRID *Grid, double N, double E, double *Row,
+			double *Col)
+{
+  double u;			/* Position within the cell, latitude */
+  double v;			/* Position within the cell, longitude */
+  double PN;			/* Projected row at (u, v) */
+  double PE;			/* Projected column at (u, v) */
+  double dNdu, dNdv, dEdu, dEdv;
+  double Det;
+  double du;
+  double dv;
+  float *n;
+  float *e;
+  int Iter;
+  int r;
+  int c;
+  int k;
+
+  for (Iter = 0; Iter < MAXLATTICEITER; Iter++) {
+    r = (int) floor(*Row);
+    if (r > Grid->NLat - 2)
+      r = Grid->NLat - 2;
+    if (r < 0)
+      r = 0;
+    c = (int) floor(*Col);
+    if (c > Grid->NLon - 2)
+      c = Grid->NLon - 2;
+    if (c < 0)
+      c = 0;
+    u = *Row - r;
+    v = *Col - c;
+
+    /* corners (r, c), (r, c + 1), (r + 1, c) and (r + 1, c + 1) */
+    k = r * Grid->NLon + c;
+    n = Grid->NodeN;
+    e = Grid->NodeE;
+    PN = (1 - u) * ((1 - v) * n[k] + v * n[k + 1]) +
+      u * ((1 - v) * n[k + Grid->NLon] + v * n[k + Grid->NLon + 1]);
+    PE = (1 - u) * ((1 - v) * e[k] + v * e[k + 1]) +
+      u * ((1 - v) * e[k + Grid->NLon] + v * e[k + Grid->NLon + 1]);
+    dNdu = (1 - v) * (n[k + Grid->NLon] - n[k]) +
+      v * (n[k + Grid->NLon + 1] - n[k + 1]);
+    dNdv = (1 - u) * (n[k + 1] - n[k]) +
+      u * (n[k + Grid->NLon + 1] - n[k + Grid->NLon]);
+    dEdu = (1 - v) * (e[k + Grid->NLon] - e[k]) +
+      v * (e[k + Grid->NLon + 1] - e[k + 1]);
+    dEdv = (1 - u) * (e[k + 1] - e[k]) +
+      u * (e[k + Grid->NLon + 1] - e[k + Grid->NLon]);
+
+    Det = dNdu * dEdv - dNdv * dEdu;
+    if (Det == 0.0)
+      break;
+    du = ((N - PN) * dEdv - (E - PE) * dNdv) / Det;
+    dv = ((E - PE) * dNdu - (N - PN) * dEdu) / Det;
+    *Row += du;
+    *Col += dv;
+    if (fabs(du) + fabs(dv) < 1e-9)
+      break;
+  }
+}
+
+/*****************************************************************************
+  LatticeAxis()
+
+  Find the first value, the step and the number of steps of a regular axis
+  that holds all the values.  Returns FALSE if there is no such axis with at
+  least two steps.  The step is first taken as the median gap between the
+  values, so that a stray value does not halve it, then refitted over the
+  whole axis, so that rounding of the coordinates in the file names does not
+  add up.
+*****************************************************************************/
+static int LatticeAxis(int NPoints, float *Value, double Tiny, float *First,
+		       float *Step, int *NSteps)
+{
+  const char *Routine = "LatticeAxis";
+  float *Sorted;
+  float *Gap;			/* Gaps between the values, sorted */
+  int *Index;
+  int NUnique;
+  int i;
+
+  if (!(Sorted = (float *) calloc(NPoints, sizeof(float))))
+    ReportError((char *) Routine, 1);
+  if (!(Gap = (float *) calloc(NPoints, sizeof(float))))
+    ReportError((char *) Routine, 1);
+  if (!(Index = (int *) calloc(NPoints, sizeof(int))))
+    ReportError((char *) Routine, 1);
+
+  for (i = 0; i < NPoints; i++)
+    Sorted[i] = Value[i];
+  qsort(Sorted, NPoints, sizeof(float), CompareFloat);
+
+  NUnique = (NPoints > 0) ? 1 : 0;
+  for (i = 1; i < NPoints; i++) {
+    if ((double) Sorted[i] - Sorted[NUnique - 1] > Tiny) {
+      Gap[NUnique - 1] = Sorted[i] - Sorted[NUnique - 1];
+      Sorted[NUnique++] = Sorted[i];
+    }
+  }
+
+  if (NUnique < 2) {
+    free(Sorted);
+    free(Gap);
+    free(Index);
+    return FALSE;
+  }
+  qsort(Gap, NUnique - 1, sizeof(float), CompareFloat);
+  *Step = Gap[(NUnique - 2) / 2];
+
+  /* index of each value, step by step */
+  Index[0] = 0;
+  for (i = 1; i < NUnique; i++)
+    Index[i] = Index[i - 1] + Round(((double) Sorted[i] - Sorted[i - 1]) /
+				    *Step);
+
+  *First = Sorted[0];
+  *Step = ((double) Sorted[NUnique - 1] - Sorted[0]) / Index[NUnique - 1];
+  *NSteps = Index[NUnique - 1] + 1;
+
+  for (i = 0; i < NUnique; i++)
+    if (fabs((double) Sorted[i] - *First - Index[i] * (double) *Step) >
+	0.1 * *Step) {
+      free(Sorted);
+      free(Gap);
+      free(Index);
+      return FALSE;
+    }
+
+  free(Sorted);
+  free(Gap);
+  free(Index);
+  return TRUE;
+}
+
+/*****************************************************************************
+  CompareFloat()
+
+  Compare two floats for qsort
+*****************************************************************************/
+static int CompareFloat(const void *A, const void *B)
+{
+  float a = *((const float *) A);
+  float b = *((const float *) B);
+
+  if (a < b)
+    return -1;
+  if (a > b)
+    return 1;
+  return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * SUMMARY:      OutputSink.c - Buffered time series output
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  The time series files (aggregated values, mass balance, pixel
+ *               dumps, stream flow and saturation extent) get a few lines
+ *               every time step.  OpenOutputFile() opens them as streams
+ *               that collect the output in memory and hand it in blocks of
+ *               SINK_BLOCKSIZE bytes to a writer thread, so the model does
+ *               not wait for the file system while it runs.  The callers
+ *               keep using fprintf() and fclose().  A write error is
+ *               returned by the stream and left to the caller.
+ * DESCRIP-END.
+ * FUNCTIONS:    OpenOutputFile()
+ * COMMENTS:     Needs fopencookie() from the GNU C library.  Elsewhere the
+ *               files are opened with OpenFile().  The data of a file is
+ *               only complete once it is closed, or when the process exits.
+ *               The files stay text, as read by the ANOVA scripts; binary
+ *               stream flow goes to the ensemble store (EnsembleStore.c).
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE		/* fopencookie() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "settings.h"
+#include "DHSVMerror.h"
+#include "fileio.h"
+
+#ifdef __GLIBC__
+
+#include <pthread.h>
+
+#define SINK_BLOCKSIZE (1 << 20)	/* Bytes per block for the writer */
+#define SINK_MAXBLOCKS 16		/* Blocks queued before the model waits */
+
+typedef struct _OUTPUTSINK_ {
+  FILE *File;			/* Stream the model writes to */
+  int fd;			/* File the writer writes to */
+  char *Data;			/* Block being filled */
+  size_t Size;			/* Bytes in Data */
+  int Pending;			/* Blocks queued or being written */
+  int Error;			/* errno of a failed write, or 0 */
+  struct _OUTPUTSINK_ *Next;	/* Next open sink */
+} OUTPUTSINK;
+
+typedef struct _SINKBLOCK_ {
+  OUTPUTSINK *Sink;
+  char *Data;
+  size_t Size;
+  struct _SINKBLOCK_ *Next;
+} SINKBLOCK;
+
+static pthread_mutex_t SinkLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BlockQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t BlockWritten = PTHREAD_COND_INITIALIZER;
+static SINKBLOCK *QueueHead = NULL;
+static SINKBLOCK *QueueTail = NULL;
+static int NQueued = 0;
+static OUTPUTSINK *OpenSinks = NULL;
+static int WriterRunning = FALSE;
+static int WriterStarted = FALSE;
+
+static ssize_t SinkWrite(void *Cookie, const char *Buffer, size_t Size);
+static int SinkClose(void *Cookie);
+static int QueueBlock(OUTPUTSINK *Sink);
+static void WriteBlock(SINKBLOCK *Block);
+static void *SinkWriter(void *Arg);
+static void DrainOutputSinks(void);
+
+/*****************************************************************************
+  Function name: OpenOutputFile()
+
+  Purpose      : Open a time series output file
+
+  Required     :
+    FILE **FilePtr - Stream to open
+    char *FileName - Name of the file
+    char *Mode     - "w" to overwrite or "a" to append
+
+  Returns      : void
+
+  Modifies     : *FilePtr
+
+  Comments     : The writer thread is started with the first file.  Close
+                 the stream with fclose(), which waits until the writer has
+                 written all of it, and fails if any of it could not be
+                 written.
+*****************************************************************************/
+void OpenOutputFile(FILE **FilePtr, char *FileName, char *Mode)
+{
+  const char *Routine = "OpenOutputFile";
+  cookie_io_functions_t Io = { NULL, SinkWrite, NULL, SinkClose };
+  OUTPUTSINK *Sink;
+  pthread_t Writer;
+  int Flags;
+
+  Flags = O_WRONLY | O_CREAT | (strstr(Mode, "a") ? O_APPEND : O_TRUNC);
+
+  if (!(Sink = (OUTPUTSINK *) calloc(1, sizeof(OUTPUTSINK))))
+    ReportError((char *) Routine, 1);
+  if (!(Sink->Data = (char *) malloc(SINK_BLOCKSIZE)))
+    ReportError((char *) Routine, 1);
+  if ((Sink->fd = open(FileName, Flags, 0666)) == -1)
+    ReportError(FileName, 3);
+  if (!(Sink->File = fopencookie(Sink, "w", Io)))
+    ReportError(FileName, 3);
+
+  pthread_mutex_lock(&SinkLock);
+  if (!WriterStarted) {
+    /* without the thread the blocks are written when they are queued */
+    WriterStarted = TRUE;
+    if (pthread_create(&Writer, NULL, SinkWriter, NULL) == 0) {
+      pthread_detach(Writer);
+      WriterRunning = TRUE;
+    }
+    atexit(DrainOutputSinks);
+  }
+  Sink->Next = OpenSinks;
+  OpenSinks = Sink;
+  pthread_mutex_unlock(&SinkLock);
+
+  *FilePtr = Sink->File;
+}
+
+/*****************************************************************************
+  SinkWrite()
+
+  Write function of the stream: copy into the current block and queue it
+  when it is full.  This runs inside stdio, so errors are returned with
+  errno set instead of reported.
+*****************************************************************************/
+static ssize_t SinkWrite(void *Cookie, const char *Buffer, size_t Size)
+{
+  OUTPUTSINK *Sink = (OUTPUTSINK *) Cookie;
+  size_t Copy;
+  size_t Done;
+
+  for (Done = 0; Done < Size; Done += Copy) {
+    if (Sink->Data == NULL &&
+	!(Sink->Data = (char *) malloc(SINK_BLOCKSIZE))) {
+      errno = ENOMEM;
+      return -1;
+    }
+    Copy = SINK_BLOCKSIZE - Sink->Size;
+    if (Copy > Size - Done)
+      Copy = Size - Done;
+    memcpy(Sink->Data + Sink->Size, Buffer + Done, Copy);
+    Sink->Size += Copy;
+    if (Sink->Size == SINK_BLOCKSIZE && !QueueBlock(Sink)) {
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+
+  return Size;
+}
+
+/*****************************************************************************
+  SinkClose()
+
+  Close function of the stream: queue the last block, wait until the writer
+  is done with the file and close it.  Returns -1 with errno set if any
+  block could not be written.
+*****************************************************************************/
+static int SinkClose(void *Cookie)
+{
+  OUTPUTSINK *Sink = (OUTPUTSINK *) Cookie;
+  OUTPUTSINK **Open;
+  int Error;
+
+  if (Sink->Size > 0)
+    QueueBlock(Sink);
+  free(Sink->Data);
+  Sink->Data = NULL;
+
+  pthread_mutex_lock(&SinkLock);
+  while (Sink->Pending > 0)
+    pthread_cond_wait(&BlockWritten, &SinkLock);
+  for (Open = &OpenSinks; *Open != Sink; Open = &((*Open)->Next))
+    ;
+  *Open = Sink->Next;
+  pthread_mutex_unlock(&SinkLock);
+
+  Error = Sink->Error;
+  if (close(Sink->fd) != 0 && Error == 0)
+    Error = errno;
+  free(Sink);
+
+  if (Error != 0) {
+    errno = Error;
+    return -1;
+  }
+  return 0;
+}
+
+/*****************************************************************************
+  QueueBlock()
+
+  Hand the current block of a sink to the writer.  Waits while
+  SINK_MAXBLOCKS blocks are queued.  Returns FALSE if there is no memory
+  to queue the block; the data is then dropped and the file fails when
+  it is closed.
+*****************************************************************************/
+static int QueueBlock(OUTPUTSINK *Sink)
+{
+  SINKBLOCK *Block;
+
+  if (!(Block = (SINKBLOCK *) malloc(sizeof(SINKBLOCK)))) {
+    free(Sink->Data);
+    Sink->Data = NULL;
+    Sink->Size = 0;
+    pthread_mutex_lock(&SinkLock);
+    Sink->Error = ENOMEM;
+    pthread_mutex_unlock(&SinkLock);
+    return FALSE;
+  }
+  Block->Sink = Sink;
+  Block->Data = Sink->Data;
+  Block->Size = Sink->Size;
+  Block->Next = NULL;
+  Sink->Data = NULL;
+  Sink->Size = 0;
+
+  pthread_mutex_lock(&SinkLock);
+  Sink->Pending++;
+  if (!WriterRunning) {
+    WriteBlock(Block);
+    pthread_mutex_unlock(&SinkLock);
+    return TRUE;
+  }
+  while (NQueued >= SINK_MAXBLOCKS)
+    pthread_cond_wait(&BlockWritten, &SinkLock);
+  if (QueueTail != NULL)
+    QueueTail->Next = Block;
+  else
+    QueueHead = Block;
+  QueueTail = Block;
+  NQueued++;
+  pthread_cond_signal(&BlockQueued);
+  pthread_mutex_unlock(&SinkLock);
+  return TRUE;
+}
+
+/*****************************************************************************
+  WriteBlock()
+
+  Write a block to its file and release it.  Called without SinkLock by the
+  writer, and with SinkLock if there is no writer.
+*****************************************************************************/
+static void WriteBlock(SINKBLOCK *Block)
+{
+  OUTPUTSINK *Sink = Block->Sink;
+  size_t Done;
+  ssize_t Written;
+
+  for (Done = 0; Done < Block->Size; Done += Written) {
+    Written = write(Sink->fd, Block->Data + Done, Block->Size - Done);
+    if (Written < 0) {
+      if (errno == EINTR) {
+	Written = 0;
+	continue;
+      }
+      Sink->Error = errno;
+      break;
+    }
+  }
+
+  free(Block->Data);
+  free(Block);
+  if (!WriterRunning)
+    Sink->Pending--;
+}
+
+/*****************************************************************************
+  SinkWriter()
+
+  Writer thread: write the queued blocks in order
+*****************************************************************************/
+static void *SinkWriter(void *Arg)
+{
+  OUTPUTSINK *Sink;
+  SINKBLOCK *Block;
+
+  pthread_mutex_lock(&SinkLock);
+  for (;;) {
+    while (QueueHead == NULL)
+      pthread_cond_wait(&BlockQueued, &SinkLock);
+    Block = QueueHead;
+    QueueHead = Block->Next;
+    if (QueueHead == NULL)
+      QueueTail = NULL;
+    pthread_mutex_unlock(&SinkLock);
+
+    Sink = Block->Sink;
+    WriteBlock(Block);
+
+    pthread_mutex_lock(&SinkLock);
+    Sink->Pending--;
+    NQueued--;
+    pthread_cond_broadcast(&BlockWritten);
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************
+  DrainOutputSinks()
+
+  Registered with atexit(): write out the files that are still open when
+  the process exits, including after a fatal error
+*****************************************************************************/
+static void DrainOutputSinks(void)
+{
+  OUTPUTSINK *Sink;
+
+  pthread_mutex_lock(&SinkLock);
+  for (Sink = OpenSinks; Sink != NULL; Sink = Sink->Next) {
+    pthread_mutex_unlock(&SinkLock);
+    fflush(Sink->File);
+    if (Sink->Size > 0)
+      QueueBlock(Sink);
+    pthread_mutex_lock(&SinkLock);
+  }
+  while (NQueued > 0)
+    pthread_cond_wait(&BlockWritten, &SinkLock);
+  pthread_mutex_unlock(&SinkLock);
+}
+
+#else
+
+/*****************************************************************************
+  OpenOutputFile()
+
+  Without fopencookie() the file is an ordinary stream
+*****************************************************************************/
+void OpenOutputFile(FILE **FilePtr, char *FileName, char *Mode)
+{
+  OpenFile(FilePtr, FileName, Mode, TRUE);
+}
+
+#endif
@@ -0,0 +1,397 @@
+/*
+ * SUMMARY:      ParameterBinding.c - Bind table entries to the parameter vector
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Read the parameter binding file, which says which entries of
+ *               the soil and vegetation tables are taken from which column
+ *               of the parameter vector, and store the values of a sample
+ *               in those entries.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitParameterBindings()
+ *               ApplyParameterBindings()
+ * COMMENTS:     The binding file has one binding per line:
+ *
+ *                 table class field column [factor ...]
+ *
+ *               table   SOIL or VEGETATION
+ *               class   soil or vegetation class, counted from 1 as in the
+ *                       input file
+ *               field   key of the entry in the input file, with _ for
+ *                       spaces, e.g. LATERAL_CONDUCTIVITY.  An index in
+ *                       brackets, e.g. HEIGHT[1], selects one element of a
+ *                       field with several values
+ *               column  column of the parameter vector, counted from 0
+ *               factor  element k of the field (from the index on) is set
+ *                       to a*value+b for the k-th factor "a", "a+b" or
+ *                       "a-b".  Without factors the value is stored in the
+ *                       indexed element, or in all elements if there is no
+ *                       index.
+ *
+ *               Everything after # is a comment.  The run number follows
+ *               the highest bound column, so the parameter vector has
+ *               that column + 2 values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+#include "getinit.h"
+
+/* how a field is stored */
+#define BIND_SCALAR     1	/* float */
+#define BIND_ARRAY      2	/* float[Length] */
+#define BIND_VECTOR     3	/* float *, Length elements */
+#define BIND_OVERSTORY  4	/* float **, row of the overstory */
+#define BIND_UNDERSTORY 5	/* float **, row of the understory */
+
+/* Length of fields with one element per layer */
+#define SOIL_LAYERS -1
+#define VEG_LAYERS  -2
+
+typedef struct {
+  int Table;
+  char *Key;
+  size_t Offset;
+  int Kind;
+  int Length;
+} BINDFIELD;
+
+static BINDFIELD Fields[] = {
+  {SOIL_BINDING, "LATERAL CONDUCTIVITY", offsetof(SOILTABLE, KsLat), BIND_SCALAR, 1},
+  {SOIL_BINDING, "EXPONENTIAL DECREASE", offsetof(SOILTABLE, KsLatExp), BIND_SCALAR, 1},
+  {SOIL_BINDING, "DEPTH THRESHOLD", offsetof(SOILTABLE, DepthThresh), BIND_SCALAR, 1},
+  {SOIL_BINDING, "MAXIMUM INFILTRATION", offsetof(SOILTABLE, MaxInfiltrationRate), BIND_SCALAR, 1},
+  {SOIL_BINDING, "CAPILLARY DRIVE", offsetof(SOILTABLE, G_Infilt), BIND_SCALAR, 1},
+  {SOIL_BINDING, "SURFACE ALBEDO", offsetof(SOILTABLE, Albedo), BIND_SCALAR, 1},
+  {SOIL_BINDING, "POROSITY", offsetof(SOILTABLE, Porosity), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "PORE SIZE DISTRIBUTION", offsetof(SOILTABLE, PoreDist), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "BUBBLING PRESSURE", offsetof(SOILTABLE, Press), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "FIELD CAPACITY", offsetof(SOILTABLE, FCap), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "WILTING POINT", offsetof(SOILTABLE, WP), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "BULK DENSITY", offsetof(SOILTABLE, Dens), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "VERTICAL CONDUCTIVITY", offsetof(SOILTABLE, Ks), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "THERMAL CONDUCTIVITY", offsetof(SOILTABLE, KhSol), BIND_VECTOR, SOIL_LAYERS},
+  {SOIL_BINDING, "THERMAL CAPACITY", offsetof(SOILTABLE, Ch), BIND_VECTOR, SOIL_LAYERS},
+  {VEG_BINDING, "FRACTIONAL COVERAGE", offsetof(VEGTABLE, Fract), BIND_VECTOR, 1},
+  {VEG_BINDING, "HEMI FRACT COVERAGE", offsetof(VEGTABLE, HemiFract), BIND_VECTOR, 1},
+  {VEG_BINDING, "TRUNK SPACE", offsetof(VEGTABLE, Trunk), BIND_SCALAR, 1},
+  {VEG_BINDING, "AERODYNAMIC ATTENUATION", offsetof(VEGTABLE, Cn), BIND_SCALAR, 1},
+  {VEG_BINDING, "RADIATION ATTENUATION", offsetof(VEGTABLE, Atten), BIND_SCALAR, 1},
+  {VEG_BINDING, "DIFFUSE RADIATION ATTENUATION", offsetof(VEGTABLE, Taud), BIND_SCALAR, 1},
+  {VEG_BINDING, "CLUMPING FACTOR", offsetof(VEGTABLE, ClumpingFactor), BIND_SCALAR, 1},
+  {VEG_BINDING, "LEAF ANGLE A", offsetof(VEGTABLE, LeafAngleA), BIND_SCALAR, 1},
+  {VEG_BINDING, "LEAF ANGLE B", offsetof(VEGTABLE, LeafAngleB), BIND_SCALAR, 1},
+  {VEG_BINDING, "SCATTERING PARAMETER", offsetof(VEGTABLE, Scat), BIND_SCALAR, 1},
+  {VEG_BINDING, "MAX SNOW INT CAPACITY", offsetof(VEGTABLE, MaxSnowInt), BIND_SCALAR, 1},
+  {VEG_BINDING, "MASS RELEASE DRIP RATIO", offsetof(VEGTABLE, MDRatio), BIND_SCALAR, 1},
+  {VEG_BINDING, "SNOW INTERCEPTION EFF", offsetof(VEGTABLE, SnowIntEff), BIND_SCALAR, 1},
+  {VEG_BINDING, "DETENTION FRACTION", offsetof(VEGTABLE, DetentionFrac), BIND_SCALAR, 1},
+  {VEG_BINDING, "DETENTION DECAY", offsetof(VEGTABLE, DetentionDecay), BIND_SCALAR, 1},
+  {VEG_BINDING, "HEIGHT", offsetof(VEGTABLE, Height), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "MAXIMUM RESISTANCE", offsetof(VEGTABLE, RsMax), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "MINIMUM RESISTANCE", offsetof(VEGTABLE, RsMin), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "MOISTURE THRESHOLD", offsetof(VEGTABLE, MoistThres), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "VAPOR PRESSURE DEFICIT", offsetof(VEGTABLE, VpdThres), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "RPC", offsetof(VEGTABLE, Rpc), BIND_VECTOR, VEG_LAYERS},
+  {VEG_BINDING, "ROOT ZONE DEPTHS", offsetof(VEGTABLE, RootDepth), BIND_VECTOR, SOIL_LAYERS},
+  {VEG_BINDING, "OVERSTORY ROOT FRACTION", offsetof(VEGTABLE, RootFract), BIND_OVERSTORY, SOIL_LAYERS},
+  {VEG_BINDING, "UNDERSTORY ROOT FRACTION", offsetof(VEGTABLE, RootFract), BIND_UNDERSTORY, SOIL_LAYERS},
+  {VEG_BINDING, "MONTHLY LIGHT EXTINCTION", offsetof(VEGTABLE, MonthlyExtnCoeff), BIND_ARRAY, 12},
+  {VEG_BINDING, "CANOPY VIEW ADJ FACTOR", offsetof(VEGTABLE, VfAdjust), BIND_SCALAR, 1},
+  {VEG_BINDING, "OVERSTORY MONTHLY LAI", offsetof(VEGTABLE, LAIMonthly), BIND_OVERSTORY, 12},
+  {VEG_BINDING, "UNDERSTORY MONTHLY LAI", offsetof(VEGTABLE, LAIMonthly), BIND_UNDERSTORY, 12},
+  {VEG_BINDING, "OVERSTORY MONTHLY ALB", offsetof(VEGTABLE, AlbedoMonthly), BIND_OVERSTORY, 12},
+  {VEG_BINDING, "UNDERSTORY MONTHLY ALB", offsetof(VEGTABLE, AlbedoMonthly), BIND_UNDERSTORY, 12},
+  {0, NULL, 0, 0, 0}
+};
+
+static void ReadBinding(char *Line, char *Where, PARBINDING *Binding);
+static int ReadFactor(char *Str, double *Scale, double *Shift);
+
+/*****************************************************************************
+  Function name: InitParameterBindings()
+
+  Purpose      : Read the parameter binding file named in the input file
+
+  Required     :
+    LISTPTR Input         - Linked list with input strings
+    PARBINDINGS *Bindings - Bindings to fill
+
+  Returns      : void
+
+  Modifies     : Bindings
+
+  Comments     : Processes the key PARAMETER BINDING FILE in [OPTIONS].
+                 With "none" nothing is bound and the parameter vector only
+                 holds the run number.
+*****************************************************************************/
+void InitParameterBindings(LISTPTR Input, PARBINDINGS *Bindings)
+{
+  const char *Routine = "InitParameterBindings";
+  char FileName[BUFSIZE + 1];
+  char Line[BUFSIZE + 1];
+  char Where[2 * BUFSIZE + 1];
+  FILE *InFile;
+  int LineNo;
+  int MaxColumn;
+
+  memset(Bindings, 0, sizeof(PARBINDINGS));
+  Bindings->NParam = 1;
+
+  GetInitString("OPTIONS", "PARAMETER BINDING FILE", "none", FileName,
+		(unsigned long) BUFSIZE, Input);
+  if (IsEmptyStr(FileName) || strncmp(FileName, "none", 4) == 0)
+    return;
+
+  if (!(InFile = fopen(FileName, "r")))
+    ReportError(FileName, 3);
+
+  MaxColumn = -1;
+  LineNo = 0;
+  while (fgets(Line, BUFSIZE, InFile)) {
+    LineNo++;
+    Strip(Line);
+    if (IsEmptyStr(Line))
+      continue;
+
+    if (!(Bindings->Binding = (PARBINDING *)
+	  realloc(Bindings->Binding,
+		  (Bindings->NBindings + 1) * sizeof(PARBINDING))))
+      ReportError((char *) Routine, 1);
+
+    sprintf(Where, "%s line %d", FileName, LineNo);
+    ReadBinding(Line, Where, &(Bindings->Binding[Bindings->NBindings]));
+    if (Bindings->Binding[Bindings->NBindings].Column > MaxColumn)
+      MaxColumn = Bindings->Binding[Bindings->NBindings].Column;
+    Bindings->NBindings++;
+  }
+  fclose(InFile);
+
+  Bindings->NParam = MaxColumn + 2;
+  printf("%d parameter bindings in %s, %d values per parameter vector\n",
+	 Bindings->NBindings, FileName, Bindings->NParam);
+}
+
+/*****************************************************************************
+  Function name: ApplyParameterBindings()
+
+  Purpose      : Store the values of a parameter vector in a soil or
+                 vegetation table
+
+  Required     :
+    PARBINDINGS *Bindings - Bindings read by InitParameterBindings()
+    int Table             - SOIL_BINDING or VEG_BINDING
+    void *Types           - SOILTABLE or VEGTABLE array
+    int NTypes            - Number of classes in Types
+    double *Anovapara     - Parameter vector
+
+  Returns      : void
+
+  Modifies     : Types
+
+  Comments     : The table must have been read and allocated already, so
+                 that the layer counts are known
+*****************************************************************************/
+void ApplyParameterBindings(PARBINDINGS *Bindings, int Table, void *Types,
+			    int NTypes, double *Anovapara)
+{
+  PARBINDING *Binding;
+  SOILTABLE *SType;
+  VEGTABLE *VType;
+  char *Entry;
+  float *Values;
+  double Value;
+  int NSoilLayers;
+  int NVegLayers;
+  int OverStory;
+  int UnderStory;
+  int Length;
+  int i;
+  int k;
+
+  for (i = 0; i < Bindings->NBindings; i++) {
+    Binding = &(Bindings->Binding[i]);
+    if (Binding->Table != Table)
+      continue;
+    if (Binding->Class >= NTypes)
+      ReportError(Binding->Name, 71);
+
+    if (Table == SOIL_BINDING) {
+      SType = (SOILTABLE *) Types + Binding->Class;
+      Entry = (char *) SType;
+      NSoilLayers = SType->NLayers;
+      NVegLayers = 0;
+      OverStory = FALSE;
+      UnderStory = FALSE;
+    }
+    else {
+      VType = (VEGTABLE *) Types + Binding->Class;
+      Entry = (char *) VType;
+      NSoilLayers = VType->NSoilLayers;
+      NVegLayers = VType->NVegLayers;
+      OverStory = VType->OverStory;
+      UnderStory = VType->UnderStory;
+    }
+
+    if (Binding->Length == SOIL_LAYERS)
+      Length = NSoilLayers;
+    else if (Binding->Length == VEG_LAYERS)
+      Length = NVegLayers;
+    else
+      Length = Binding->Length;
+
+    switch (Binding->Kind) {
+    case BIND_SCALAR:
+    case BIND_ARRAY:
+      Values = (float *) (Entry + Binding->Offset);
+      break;
+    case BIND_VECTOR:
+      Values = *(float **) (Entry + Binding->Offset);
+      break;
+    case BIND_OVERSTORY:
+      Values = OverStory ? (*(float ***) (Entry + Binding->Offset))[0] : NULL;
+      break;
+    case BIND_UNDERSTORY:
+      Values = UnderStory ?
+	(*(float ***) (Entry + Binding->Offset))[OverStory ? 1 : 0] : NULL;
+      break;
+    default:
+      Values = NULL;
+    }
+    if (Values == NULL || Binding->Start >= Length)
+      ReportError(Binding->Name, 71);
+
+    Value = Anovapara[Binding->Column];
+    if (Binding->NFactors == 0) {
+      for (k = Binding->Start; k < Length; k++)
+	Values[k] = Value;
+    }
+    else {
+      for (k = 0; k < Binding->NFactors && Binding->Start + k < Length; k++)
+	Values[Binding->Start + k] = Binding->Scale[k] * Value +
+	  Binding->Shift[k];
+    }
+  }
+}
+
+/*****************************************************************************
+  ReadBinding()
+
+  Parse one line of the binding file and look up the field
+*****************************************************************************/
+static void ReadBinding(char *Line, char *Where, PARBINDING *Binding)
+{
+  const char *Routine = "ReadBinding";
+  char *Token[4];
+  char *Factor;
+  char *Bracket;
+  char Key[BUFSIZE + 1];
+  char *Ptr;
+  int Class;
+  int Index;
+  int i;
+
+  memset(Binding, 0, sizeof(PARBINDING));
+
+  for (i = 0; i < 4; i++) {
+    if (!(Token[i] = strtok(i == 0 ? Line : NULL, " \t\r\n")))
+      ReportError(Where, 71);
+  }
+
+  strcpy(Key, Token[0]);
+  MakeKeyString(Key);
+  if (strcmp(Key, "SOIL") == 0)
+    Binding->Table = SOIL_BINDING;
+  else if (strcmp(Key, "VEGETATION") == 0)
+    Binding->Table = VEG_BINDING;
+  else
+    ReportError(Where, 71);
+
+  if (!CopyInt(&Class, Token[1], 1) || Class < 1)
+    ReportError(Where, 71);
+  Binding->Class = Class - 1;
+
+  if (!CopyInt(&(Binding->Column), Token[3], 1) || Binding->Column < 0)
+    ReportError(Where, 71);
+
+  /* field key, with an optional element index */
+  Index = -1;
+  strcpy(Key, Token[2]);
+  if ((Bracket = strchr(Key, '['))) {
+    Index = (int) strtol(Bracket + 1, &Ptr, 10);
+    if (Ptr == Bracket + 1 || strcmp(Ptr, "]") != 0 || Index < 0)
+      ReportError(Where, 71);
+    *Bracket = '\0';
+  }
+  for (Ptr = Key; *Ptr != '\0'; Ptr++)
+    if (*Ptr == '_')
+      *Ptr = ' ';
+  MakeKeyString(Key);
+
+  for (i = 0; Fields[i].Key != NULL; i++)
+    if (Fields[i].Table == Binding->Table && strcmp(Fields[i].Key, Key) == 0)
+      break;
+  if (Fields[i].Key == NULL)
+    ReportError(Where, 71);
+  Binding->Offset = Fields[i].Offset;
+  Binding->Kind = Fields[i].Kind;
+  Binding->Length = Fields[i].Length;
+  if (Binding->Kind == BIND_SCALAR && Index > 0)
+    ReportError(Where, 71);
+  snprintf(Binding->Name, sizeof(Binding->Name), "%s %d %s",
+	   Binding->Table == SOIL_BINDING ? "SOIL" : "VEGETATION", Class,
+	   Token[2]);
+
+  /* factors */
+  while ((Factor = strtok(NULL, " \t\r\n"))) {
+    if (!(Binding->Scale = (double *) realloc(Binding->Scale,
+					      (Binding->NFactors + 1) * sizeof(double))) ||
+	!(Binding->Shift = (double *) realloc(Binding->Shift,
+					      (Binding->NFactors + 1) * sizeof(double))))
+      ReportError((char *) Routine, 1);
+    if (!ReadFactor(Factor, &(Binding->Scale[Binding->NFactors]),
+		    &(Binding->Shift[Binding->NFactors])))
+      ReportError(Where, 71);
+    Binding->NFactors++;
+  }
+
+  /* an index without factors sets only that element */
+  Binding->Start = Index < 0 ? 0 : Index;
+  if (Index >= 0 && Binding->NFactors == 0) {
+    if (!(Binding->Scale = (double *) malloc(sizeof(double))) ||
+	!(Binding->Shift = (double *) malloc(sizeof(double))))
+      ReportError((char *) Routine, 1);
+    Binding->Scale[0] = 1.0;
+    Binding->Shift[0] = 0.0;
+    Binding->NFactors = 1;
+  }
+}
+
+/*****************************************************************************
+  ReadFactor()
+
+  Parse "a", "a+b" or "a-b".  Returns FALSE if Str is not of that form.
+*****************************************************************************/
+static int ReadFactor(char *Str, double *Scale, double *Shift)
+{
+  char *End;
+
+  *Scale = strtod(Str, &End);
+  if (End == Str)
+    return FALSE;
+  *Shift = 0.0;
+  if (*End == '+' || *End == '-') {
+    Str = End;
+    *Shift = strtod(Str, &End);
+    if (End == Str)
+      return FALSE;
+  }
+  return *End == '\0';
+}
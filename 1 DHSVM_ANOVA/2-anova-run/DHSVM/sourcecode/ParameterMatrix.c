@@ -0,0 +1,80 @@
+/*
+ * SUMMARY:      ParameterMatrix.c - Read one sample from a parameter matrix
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Read a parameter vector from the binary parameter matrix
+ *               written by the ANOVA driver (see parmatrix.h).  The file is
+ *               mapped into memory, so only the pages of the requested row
+ *               are read and the values are exact doubles.
+ * DESCRIP-END.
+ * FUNCTIONS:    ReadParameterMatrix()
+ * COMMENTS:
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "settings.h"
+#include "DHSVMerror.h"
+#include "parmatrix.h"
+
+/*****************************************************************************
+  Function name: ReadParameterMatrix()
+
+  Purpose      : Copy one row of a binary parameter matrix
+
+  Required     :
+    char *FileName - Binary parameter matrix
+    int Row        - Row to read (0 based)
+    int NCols      - Number of values expected per row
+    double *Values - Array of NCols values to fill
+
+  Returns      : void
+
+  Modifies     : Values
+
+  Comments     :
+*****************************************************************************/
+void ReadParameterMatrix(char *FileName, int Row, int NCols, double *Values)
+{
+  PARMATRIXHEADER *Header;
+  struct stat FileStat;
+  char *Map;
+  int fd;
+
+  if ((fd = open(FileName, O_RDONLY)) == -1)
+    ReportError(FileName, 3);
+
+  if (fstat(fd, &FileStat) == -1 ||
+      FileStat.st_size < (off_t) sizeof(PARMATRIXHEADER))
+    ReportError(FileName, 2);
+
+  Map = (char *) mmap(NULL, (size_t) FileStat.st_size, PROT_READ, MAP_SHARED,
+		      fd, 0);
+  if (Map == (char *) MAP_FAILED)
+    ReportError(FileName, 2);
+
+  Header = (PARMATRIXHEADER *) Map;
+  if (strncmp(Header->Magic, PARMATRIX_MAGIC, sizeof(Header->Magic)) != 0 ||
+      Header->NCols != NCols ||
+      FileStat.st_size < (off_t) (sizeof(PARMATRIXHEADER) +
+	(size_t) Header->NRows * NCols * sizeof(double)))
+    ReportError(FileName, 5);
+  if (Row < 0 || Row >= Header->NRows) {
+    sprintf(errorstr, "%s, row %d of %d", FileName, Row, Header->NRows);
+    ReportError(errorstr, 47);
+  }
+
+  memcpy(Values, Map + sizeof(PARMATRIXHEADER) +
+	 (size_t) Row * NCols * sizeof(double), NCols * sizeof(double));
+
+  munmap(Map, (size_t) FileStat.st_size);
+  close(fd);
+}
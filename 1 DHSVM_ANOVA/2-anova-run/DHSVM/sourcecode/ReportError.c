@@ -6,9 +6,12 @@
  * ORG:          University of Washington, Department of Civil Engineering
  * E-MAIL:       nijssen@u.washington.edu
  * ORIG-DATE:    Apr-96
- * DESCRIPTION:  Display a context-dependent error message and exit
+ * DESCRIPTION:  Display a context-dependent error message and exit, or
+ *               return to the caller of RunParameterSample() if the model
+ *               runs in-process
  * DESCRIP-END.
  * FUNCTIONS:    ReportError()
+ *               LoopErrorString()
  *               ReportWarning()
  * COMMENTS:
  * $Id: ReportError.c,v 1.6 2004/08/24 23:21:48 tbohn Exp $     
@@ -16,6 +19,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "settings.h"
 #include "data.h"
 #include "DHSVMerror.h"
@@ -91,15 +99,45 @@ static char *ErrorMessage[] = {
   "Riparian parameter < 0:", /* 68 */
   "No gridded met file is found within the basin boundary", /* 69 */
   "Unknown keyword: ",                                      /* 70 */
+  "Invalid parameter binding:",                            /* 71 */
+  "Gridded met files do not form a regular lat/lon grid in:", /* 72 */
   NULL
 };
 
+jmp_buf *ErrorJump = NULL;
+jmp_buf *LoopJump = NULL;
+static char LoopError[BUFSIZE + 1];	/* ErrorString of a jump to LoopJump */
+#ifdef _OPENMP
+#pragma omp threadprivate(LoopError)
+#endif
+
 void ReportError(char *ErrorString, int ErrorCode)
 {
+#ifdef _OPENMP
+  /* a jump cannot leave a parallel region.  A parallel loop that set
+     LoopJump catches the error and reports it after the region, otherwise
+     the process ends */
+  if (omp_in_parallel()) {
+    if (LoopJump != NULL) {
+      strncpy(LoopError, ErrorString, BUFSIZE);
+      longjmp(*LoopJump, ErrorCode);
+    }
+    printf("%s %s\n", ErrorMessage[ErrorCode - 1], ErrorString);
+    exit(ErrorCode);
+  }
+#endif
   printf("%s %s\n", ErrorMessage[ErrorCode - 1], ErrorString);
+  if (ErrorJump != NULL)
+    longjmp(*ErrorJump, ErrorCode);
   exit(ErrorCode);
 }
 
+/* ErrorString of the last error this thread caught in LoopJump */
+char *LoopErrorString(void)
+{
+  return LoopError;
+}
+
 void ReportWarning(char *ErrorString, int ErrorCode)
 {
   fprintf(stderr, "%s %s\n", ErrorMessage[ErrorCode - 1], ErrorString);
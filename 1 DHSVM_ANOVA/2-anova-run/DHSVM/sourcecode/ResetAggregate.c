@@ -92,16 +92,16 @@ void ResetAggregate(LAYER * Soil, LAYER * Veg, AGGREGATED * Total,
   /* initialize soil moisture data.  The total amount of runoff is calculated
      in the RouteSurface() routine */
   Total->Soil.Soil = 0;
-  Total->Soil.Depth = 0.0;
+  Total->SoilDepth = 0.0;
   for (i = 0; i < Soil->MaxLayers + 1; i++)
     Total->Soil.Moist[i] = 0.0;
   for (i = 0; i < Soil->MaxLayers; i++) {
     Total->Soil.Perc[i] = 0.0;
     Total->Soil.Temp[i] = 0.0;
   }
-  Total->Soil.TableDepth = 0.0;
+  Total->TableDepth = 0.0;
   Total->Soil.WaterLevel = 0.0;
-  Total->Soil.SatFlow = 0.0;
+  Total->SatFlow = 0.0;
   Total->Soil.TSurf = 0.0;
   Total->Soil.Qnet = 0.0;
   Total->Soil.Qs = 0.0;
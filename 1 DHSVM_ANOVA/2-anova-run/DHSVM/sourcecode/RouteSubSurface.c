@@ -93,19 +93,34 @@
   and FlowGrad (SubDir, SubTotalDir, SubFlowGrad) for Gradient = WATERTABLE 
   are now determined locally here (in RouteSubsurface.c.)
 
+  The WATERTABLE directions go into Work, which is allocated once per run
+  and reused every time step.  For TOPOGRAPHY the directions are read from
+  TopoMap directly.
+
+  The soil depth, water table depth, lateral conductivity and saturated flow
+  come from SoilCells, so the sweeps below walk the basin cells in the order
+  of their storage.  Flow directions never point out of the basin, so the
+  neighbours that receive water are always basin cells.
+
   WORK IN PROGRESS
 *****************************************************************************/
 void RouteSubSurface(int Dt, MAPSIZE *Map, TOPOPIX **TopoMap,
 		     VEGTABLE *VType, VEGPIX **VegMap,
 		     ROADSTRUCT **Network, SOILTABLE *SType,
-		     SOILPIX **SoilMap, CHANNEL *ChannelData,
-		     TIMESTRUCT *Time, OPTIONSTRUCT *Options, 
-		     char *DumpPath, int MaxStreamID, SNOWPIX **SnowMap)
+		     SOILPIX **SoilMap, SOILCELLS *SoilCells,
+		     CHANNEL *ChannelData, TIMESTRUCT *Time,
+		     OPTIONSTRUCT *Options, FILE *SatExtentFile,
+		     int MaxStreamID, SNOWPIX **SnowMap, ROUTEWORK *Work)
 {
-  const char *Routine = "RouteSubSurface";
+  int c;			/* basin cell counter */
+  int n;			/* basin cell of a neighbour */
   int x;			/* counter */
   int y;			/* counter */
-  int i, j;	        /* counters */
+  int i;	            /* cell index in Work */
+  float *SoilDepth = SoilCells->Depth;
+  float *TableDepth = SoilCells->TableDepth;
+  float *KsLat = SoilCells->KsLat;
+  float *SatFlow = SoilCells->SatFlow;
   float BankHeight;
   float *Adjust;
   float fract_used;
@@ -115,239 +130,187 @@ void RouteSubSurface(int Dt, MAPSIZE *Map, TOPOPIX **TopoMap,
   float Transmissivity;
   float AvailableWater;
   int k;
-  float **SubFlowGrad;	        /* Magnitude of subsurface flow gradient slope * width */
-  unsigned char ***SubDir;      /* Fraction of flux moving in each direction*/ 
-  unsigned int **SubTotalDir;	/* Sum of Dir array */
+  const unsigned char *SubDir;  /* Fraction of flux moving in each direction*/ 
+  unsigned int SubTotalDir;     /* Sum of Dir array */
+  float SubFlowGrad;            /* Magnitude of subsurface flow gradient slope * width */
 
   int count, totalcount;
-  float mgrid, sat;
+  float sat;
   char buffer[32];
-  char satoutfile[100];         /* Character arrays to hold file name. */ 
-  FILE *fs;                     /* File pointer. */
-
-  /*****************************************************************************
-   Allocate memory 
-  ****************************************************************************/
-  
-  if (!(SubFlowGrad = (float **)calloc(Map->NY, sizeof(float *))))
-    ReportError((char *) Routine, 1);
-  for(i=0; i<Map->NY; i++) {
-    if (!(SubFlowGrad[i] = (float *)calloc(Map->NX, sizeof(float))))
-      ReportError((char *) Routine, 1);
-  }
-  
-  if (!((SubDir) = (unsigned char ***) calloc(Map->NY, sizeof(unsigned char **))))
-    ReportError((char *) Routine, 1);
-  for (i=0; i<Map->NY; i++) {
-    if (!((SubDir)[i] = (unsigned char **) calloc(Map->NX, sizeof(unsigned char*))))
-	  ReportError((char *) Routine, 1);
-	for (j=0; j<Map->NX; j++) {
-      if (!(SubDir[i][j] = (unsigned char *)calloc(NDIRS, sizeof(unsigned char ))))
-		ReportError((char *) Routine, 1);
-    }
-  }
 
-  if (!(SubTotalDir = (unsigned int **)calloc(Map->NY, sizeof(unsigned int *))))
-    ReportError((char *) Routine, 1);
-  for (i=0; i<Map->NY; i++) {
-    if (!(SubTotalDir[i] = (unsigned int *)calloc(Map->NX, sizeof(unsigned int))))
-      ReportError((char *) Routine, 1);
-  }
-  
   /* reset the saturated subsurface flow to zero */
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-		SoilMap[y][x].SatFlow = 0;
-		SoilMap[y][x].RoadInt = 0;
-      }
-    }
+  for (c = 0; c < Map->NumCells; c++)
+    SatFlow[c] = 0;
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    SoilMap[y][x].RoadInt = 0;
   }
 
   if (Options->FlowGradient == WATERTABLE)
-    HeadSlopeAspect(Map, TopoMap, SoilMap, SubFlowGrad, SubDir, SubTotalDir);
+    HeadSlopeAspect(Map, TopoMap, SoilMap, Work->FlowGrad, Work->Dir,
+		    Work->TotalDir);
 
   /* next sweep through all the grid cells, calculate the amount of
      flow in each direction, and divide the flow over the surrounding
      pixels */
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-		if (Options->FlowGradient == TOPOGRAPHY){
-		  SubTotalDir[y][x] = TopoMap[y][x].TotalDir;
-	      SubFlowGrad[y][x] = TopoMap[y][x].FlowGrad;
-		  for (k = 0; k < NDIRS; k++) 
-	        SubDir[y][x][k] = TopoMap[y][x].Dir[k];
-		}
-		BankHeight = (Network[y][x].BankHeight > SoilMap[y][x].Depth) ?
-	    SoilMap[y][x].Depth : Network[y][x].BankHeight;
-	    Adjust = Network[y][x].Adjust;
-	    fract_used = 0.0f;
-		water_out_road = 0.0;
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    if (Options->FlowGradient == TOPOGRAPHY){
+      SubTotalDir = TopoMap[y][x].TotalDir;
+      SubFlowGrad = TopoMap[y][x].FlowGrad;
+      SubDir = TopoMap[y][x].Dir;
+    }
+    else {
+      i = Map->BasinCell[c];
+      SubTotalDir = Work->TotalDir[i];
+      SubFlowGrad = Work->FlowGrad[i];
+      SubDir = &(Work->Dir[i * NDIRS]);
+    }
+    BankHeight = (Network[y][x].BankHeight > SoilDepth[c]) ?
+    SoilDepth[c] : Network[y][x].BankHeight;
+    Adjust = Network[y][x].Adjust;
+    fract_used = 0.0f;
+    water_out_road = 0.0;
 		
-		if (!channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-	      for (k = 0; k < NDIRS; k++) {
-			fract_used += (float) SubDir[y][x][k];
-		  }
-		  if (SubTotalDir[y][x] > 0)
-	        fract_used /= (float) SubTotalDir[y][x];
-		  else
-	        fract_used = 0.;
+    if (!channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+      for (k = 0; k < NDIRS; k++) {
+        fract_used += (float) SubDir[k];
+      }
+      if (SubTotalDir > 0)
+        fract_used /= (float) SubTotalDir;
+      else
+        fract_used = 0.;
 		  
-		  /* only bother calculating subsurface flow if water table is above bedrock */
-		  if (SoilMap[y][x].TableDepth < SoilMap[y][x].Depth) {
-	        depth = ((SoilMap[y][x].TableDepth > BankHeight) ?
-				SoilMap[y][x].TableDepth : BankHeight);
+      /* only bother calculating subsurface flow if water table is above bedrock */
+      if (TableDepth[c] < SoilDepth[c]) {
+        depth = ((TableDepth[c] > BankHeight) ?
+            TableDepth[c] : BankHeight);
 			
-			Transmissivity = CalcTransmissivity(SoilMap[y][x].Depth, depth,
-				 SoilMap[y][x].KsLat,
-				 SType[SoilMap[y][x].Soil - 1].KsLatExp,
-                 SType[SoilMap[y][x].Soil - 1].DepthThresh);
+        Transmissivity = CalcTransmissivity(SoilDepth[c], depth,
+             KsLat[c],
+             SType[SoilMap[y][x].Soil - 1].KsLatExp,
+             SType[SoilMap[y][x].Soil - 1].DepthThresh);
 			
-			OutFlow = 
-				(Transmissivity * fract_used * SubFlowGrad[y][x] * Dt) / (Map->DX * Map->DY);
+        OutFlow = 
+            (Transmissivity * fract_used * SubFlowGrad * Dt) / (Map->DX * Map->DY);
 			
-			/* check whether enough water is available for redistribution */
-			AvailableWater =
-				CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
-				 SoilMap[y][x].Depth, VType[VegMap[y][x].Veg - 1].RootDepth,
-				 SoilMap[y][x].Porosity, SoilMap[y][x].FCap,
-				 SoilMap[y][x].TableDepth, Adjust);
-			OutFlow = (OutFlow > AvailableWater) ? AvailableWater : OutFlow;
-		  }
-		  else {
-	        depth = SoilMap[y][x].Depth;
-	        OutFlow = 0.0f;
-		  }
+        /* check whether enough water is available for redistribution */
+        AvailableWater =
+            CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
+             SoilDepth[c], VType[VegMap[y][x].Veg - 1].RootDepth,
+             SoilMap[y][x].Porosity, SoilMap[y][x].FCap,
+             TableDepth[c], Adjust);
+        OutFlow = (OutFlow > AvailableWater) ? AvailableWater : OutFlow;
+      }
+      else {
+        depth = SoilDepth[c];
+        OutFlow = 0.0f;
+      }
 		  
-		  /* compute road interception if water table is above road cut */
-		  if (SoilMap[y][x].TableDepth < BankHeight &&
-			  channel_grid_has_channel(ChannelData->road_map, x, y)) {
-		    if (SubTotalDir[y][x] > 0)
-	          fract_used = ((float) Network[y][x].fraction /
-			    (float)SubTotalDir[y][x]);
-			else
-	          fract_used = 0.;
-			Transmissivity =
-				 CalcTransmissivity(BankHeight, SoilMap[y][x].TableDepth,
-				 SoilMap[y][x].KsLat,
-				 SType[SoilMap[y][x].Soil - 1].KsLatExp,
-                 SType[SoilMap[y][x].Soil - 1].DepthThresh);
+      /* compute road interception if water table is above road cut */
+      if (TableDepth[c] < BankHeight &&
+          channel_lookup_has_channel(ChannelData->road_lookup, x, y)) {
+        if (SubTotalDir > 0)
+          fract_used = ((float) Network[y][x].fraction /
+            (float)SubTotalDir);
+        else
+          fract_used = 0.;
+        Transmissivity =
+             CalcTransmissivity(BankHeight, TableDepth[c],
+             KsLat[c],
+             SType[SoilMap[y][x].Soil - 1].KsLatExp,
+             SType[SoilMap[y][x].Soil - 1].DepthThresh);
 			
-			water_out_road = (Transmissivity * fract_used *
-			      SubFlowGrad[y][x] * Dt) / (Map->DX * Map->DY);
+        water_out_road = (Transmissivity * fract_used *
+              SubFlowGrad * Dt) / (Map->DX * Map->DY);
 			
-			AvailableWater =
-				CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
-				 BankHeight, VType[VegMap[y][x].Veg - 1].RootDepth,
-				 SoilMap[y][x].Porosity,
-				 SoilMap[y][x].FCap,
-				 SoilMap[y][x].TableDepth, Adjust);
+        AvailableWater =
+            CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
+             BankHeight, VType[VegMap[y][x].Veg - 1].RootDepth,
+             SoilMap[y][x].Porosity,
+             SoilMap[y][x].FCap,
+             TableDepth[c], Adjust);
 			
-			water_out_road = 
-				(water_out_road > AvailableWater) ? AvailableWater : water_out_road;
+        water_out_road = 
+            (water_out_road > AvailableWater) ? AvailableWater : water_out_road;
 			
-			/* increase lateral inflow to road channel */
-			SoilMap[y][x].RoadInt = water_out_road;
-			channel_grid_inc_inflow(ChannelData->road_map, x, y,
-				    water_out_road * Map->DX * Map->DY);
-		  }
-		  /* Subsurface Component - Decrease water change by outwater */
-		  SoilMap[y][x].SatFlow -= OutFlow + water_out_road;
+        /* increase lateral inflow to road channel */
+        SoilMap[y][x].RoadInt = water_out_road;
+        channel_lookup_inc_inflow(ChannelData->road_lookup, x, y,
+                water_out_road * Map->DX * Map->DY);
+      }
+      /* Subsurface Component - Decrease water change by outwater */
+      SatFlow[c] -= OutFlow + water_out_road;
 		  
-		  /* Assign the water to appropriate surrounding pixels */
-		  if (SubTotalDir[y][x] > 0)
-	        OutFlow /= (float) SubTotalDir[y][x];
-		  else
-	        OutFlow = 0.;
+      /* Assign the water to appropriate surrounding pixels */
+      if (SubTotalDir > 0)
+        OutFlow /= (float) SubTotalDir;
+      else
+        OutFlow = 0.;
 		  
-		  for (k = 0; k < NDIRS; k++) {
-	        int nx = xdirection[k] + x;
-	        int ny = ydirection[k] + y;
-	        if (valid_cell(Map, nx, ny)) {
-	          SoilMap[ny][nx].SatFlow += OutFlow * SubDir[y][x][k];
-			}
-		  }
-		}
-	    else {			/* cell has a stream channel */
-	      if (SoilMap[y][x].TableDepth < BankHeight &&
-	        channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-			float gradient = 4.0 * (BankHeight - SoilMap[y][x].TableDepth);
-			if (gradient < 0.0)
-	          gradient = 0.0;
-			Transmissivity =
-				CalcTransmissivity(BankHeight, SoilMap[y][x].TableDepth,
-				 SoilMap[y][x].KsLat,
-				 SType[SoilMap[y][x].Soil - 1].KsLatExp,
-                 SType[SoilMap[y][x].Soil - 1].DepthThresh);
+      for (k = 0; k < NDIRS; k++) {
+        int nx = xdirection[k] + x;
+        int ny = ydirection[k] + y;
+        if (valid_cell(Map, nx, ny) &&
+            (n = Map->BasinIndex[ny * Map->NX + nx]) >= 0) {
+          SatFlow[n] += OutFlow * SubDir[k];
+        }
+      }
+    }
+    else {			/* cell has a stream channel */
+      if (TableDepth[c] < BankHeight &&
+        channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+        float gradient = 4.0 * (BankHeight - TableDepth[c]);
+        if (gradient < 0.0)
+          gradient = 0.0;
+        Transmissivity =
+            CalcTransmissivity(BankHeight, TableDepth[c],
+             KsLat[c],
+             SType[SoilMap[y][x].Soil - 1].KsLatExp,
+             SType[SoilMap[y][x].Soil - 1].DepthThresh);
 
-			OutFlow = (Transmissivity * gradient * Dt) / (Map->DX * Map->DY);
+        OutFlow = (Transmissivity * gradient * Dt) / (Map->DX * Map->DY);
 			
-			/* check whether enough water is available for redistribution */
-			AvailableWater = 
-				 CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
-				 BankHeight, VType[VegMap[y][x].Veg - 1].RootDepth,
-				 SoilMap[y][x].Porosity,
-				 SoilMap[y][x].FCap,
-				 SoilMap[y][x].TableDepth, Adjust);
+        /* check whether enough water is available for redistribution */
+        AvailableWater = 
+             CalcAvailableWater(VType[VegMap[y][x].Veg - 1].NSoilLayers,
+             BankHeight, VType[VegMap[y][x].Veg - 1].RootDepth,
+             SoilMap[y][x].Porosity,
+             SoilMap[y][x].FCap,
+             TableDepth[c], Adjust);
 			
-			OutFlow = (OutFlow > AvailableWater) ? AvailableWater : OutFlow;
+        OutFlow = (OutFlow > AvailableWater) ? AvailableWater : OutFlow;
 			
-			/* remove water going to channel from the grid cell */
-			SoilMap[y][x].SatFlow -= OutFlow;
+        /* remove water going to channel from the grid cell */
+        SatFlow[c] -= OutFlow;
 			
-			/* contribute to channel segment lateral inflow */
-			channel_grid_inc_inflow(ChannelData->stream_map, x, y,
-				    OutFlow * Map->DX * Map->DY);
+        /* contribute to channel segment lateral inflow */
+        channel_lookup_inc_inflow(ChannelData->stream_lookup, x, y,
+                OutFlow * Map->DX * Map->DY);
 			
-			SoilMap[y][x].ChannelInt += OutFlow;
-		  }
-		}
+        SoilMap[y][x].ChannelInt += OutFlow;
       }
     }
   }
 
- for(i=0; i<Map->NY; i++) { 
-    free(SubTotalDir[i]);
-    free(SubFlowGrad[i]);
-    for(j=0; j<Map->NX; j++){
-      free(SubDir[i][j]);
-    }
-    free(SubDir[i]);
-  }
-  free(SubDir);
-  free(SubTotalDir);
-  free(SubFlowGrad);
-
   /**********************************************************************/
   /* Dump saturation extent file to screen.
      Saturation extent is based on the number of pixels with a water table 
-     that is at least MTHRESH of soil depth. */ 
+     that is at least MTHRESH of soil depth.  There is no file for a point
+     model. */ 
   
-  count =0;
-  totalcount = 0;
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-	     mgrid = (SoilMap[y][x].Depth - SoilMap[y][x].TableDepth)/SoilMap[y][x].Depth;
-	     if (mgrid > MTHRESH) 
-		   count += 1;
-		 totalcount += 1;
-      }
-    }
-  }
+  if (SatExtentFile == NULL)
+    return;
+
+  count = 0;
+  for (c = 0; c < Map->NumCells; c++)
+    count += ((SoilDepth[c] - TableDepth[c]) / SoilDepth[c] > MTHRESH);
+  totalcount = Map->NumCells;
  
   sat = 100.*((float)count/(float)totalcount);
   
-  sprintf(satoutfile, "%ssaturation_extent.txt", DumpPath);
-  
-  if((fs = fopen(satoutfile,"a")) == NULL){
-    printf("Cannot open saturation extent output file.\n");
-    exit(0);
-  }
-  
   SPrintDate(&(Time->Current), buffer);
-  fprintf(fs, "%-20s %.4f \n", buffer, sat); 
-  fclose(fs);    
+  fprintf(SatExtentFile, "%-20s %.4f \n", buffer, sat);
 }
-
@@ -47,107 +47,104 @@ void RouteSurface(MAPSIZE * Map, TIMESTRUCT * Time, TOPOPIX ** TopoMap,
   DUMPSTRUCT *Dump, VEGPIX ** VegMap, VEGTABLE * VType, CHANNEL *ChannelData)
 {
   const char *Routine = "RouteSurface";
-  int Lag;			/* Lag time for hydrograph */
-  int Step;
+  int Bin;			/* Bin of the unit hydrograph */
+  int NBins;			/* Number of bins of the hydrograph */
   float StreamFlow;
   int TravelTime;
-  int WaveLength;
-  int i, j, x, y, n, k;         /* Counters */
+  int c, i, j, x, y, n, k;      /* Counters */
 
 
   /* Allocate memory for Runon Matrix */
   if (Options->HasNetwork) {
     /* Option->Routing = false when routing = conventional */
-    for (y = 0; y < Map->NY; y++) {
-      for (x = 0; x < Map->NX; x++) {
-        if (INBASIN(TopoMap[y][x].Mask)) {
-          SoilMap[y][x].Runoff = SoilMap[y][x].IExcess;
-          SoilMap[y][x].IExcess = 0;
-          SoilMap[y][x].DetentionIn = 0;
-        }
-      }
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      SoilMap[y][x].Runoff = SoilMap[y][x].IExcess;
+      SoilMap[y][x].IExcess = 0;
+      SoilMap[y][x].DetentionIn = 0;
     }
-    for (y = 0; y < Map->NY; y++) {
-      for (x = 0; x < Map->NX; x++) {
-        if (INBASIN(TopoMap[y][x].Mask)) {
-          if (!channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-            if (VType[VegMap[y][x].Veg - 1].ImpervFrac > 0.0) {
-              /* Calculate the outflow from impervious portion of urban cell straight to nearest channel cell */
-              SoilMap[TopoMap[y][x].drains_y][TopoMap[y][x].drains_x].IExcess +=
-                (1 - VType[VegMap[y][x].Veg - 1].DetentionFrac) *
-                VType[VegMap[y][x].Veg - 1].ImpervFrac * SoilMap[y][x].Runoff;
-              /* Retained water in detention storage */
-              SoilMap[y][x].DetentionIn = VType[VegMap[y][x].Veg - 1].DetentionFrac *
-                VType[VegMap[y][x].Veg - 1].ImpervFrac * SoilMap[y][x].Runoff;
-              /* Retained water in Detention storage routed to channel */
-              SoilMap[y][x].DetentionStorage += SoilMap[y][x].DetentionIn;
-              SoilMap[y][x].DetentionOut = SoilMap[y][x].DetentionStorage * VType[VegMap[y][x].Veg - 1].DetentionDecay;
-              SoilMap[TopoMap[y][x].drains_y][TopoMap[y][x].drains_x].IExcess += SoilMap[y][x].DetentionOut;
-              SoilMap[y][x].DetentionStorage -= SoilMap[y][x].DetentionOut;
-              if (SoilMap[y][x].DetentionStorage < 0.0)
-                SoilMap[y][x].DetentionStorage = 0.0;
-              /* Route the runoff from pervious portion of urban cell to the neighboring cell */
-              for (n = 0; n < NDIRS; n++) {
-                int xn = x + xdirection[n];
-                int yn = y + ydirection[n];
-                if (valid_cell(Map, xn, yn)) {
-                  SoilMap[yn][xn].IExcess += (1 - VType[VegMap[y][x].Veg - 1].ImpervFrac) * SoilMap[y][x].Runoff
-                    *((float)TopoMap[y][x].Dir[n] / (float)TopoMap[y][x].TotalDir);
-                }
-              }
-            }
-            else {
-              for (n = 0; n < NDIRS; n++) {
-                int xn = x + xdirection[n];
-                int yn = y + ydirection[n];
-                if (valid_cell(Map, xn, yn)) {
-                  SoilMap[yn][xn].IExcess += SoilMap[y][x].Runoff *((float)TopoMap[y][x].Dir[n] / (float)TopoMap[y][x].TotalDir);
-                }
-              }
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      if (!channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+        if (VType[VegMap[y][x].Veg - 1].ImpervFrac > 0.0) {
+          /* Calculate the outflow from impervious portion of urban cell straight to nearest channel cell */
+          SoilMap[TopoMap[y][x].drains_y][TopoMap[y][x].drains_x].IExcess +=
+            (1 - VType[VegMap[y][x].Veg - 1].DetentionFrac) *
+            VType[VegMap[y][x].Veg - 1].ImpervFrac * SoilMap[y][x].Runoff;
+          /* Retained water in detention storage */
+          SoilMap[y][x].DetentionIn = VType[VegMap[y][x].Veg - 1].DetentionFrac *
+            VType[VegMap[y][x].Veg - 1].ImpervFrac * SoilMap[y][x].Runoff;
+          /* Retained water in Detention storage routed to channel */
+          SoilMap[y][x].DetentionStorage += SoilMap[y][x].DetentionIn;
+          SoilMap[y][x].DetentionOut = SoilMap[y][x].DetentionStorage * VType[VegMap[y][x].Veg - 1].DetentionDecay;
+          SoilMap[TopoMap[y][x].drains_y][TopoMap[y][x].drains_x].IExcess += SoilMap[y][x].DetentionOut;
+          SoilMap[y][x].DetentionStorage -= SoilMap[y][x].DetentionOut;
+          if (SoilMap[y][x].DetentionStorage < 0.0)
+            SoilMap[y][x].DetentionStorage = 0.0;
+          /* Route the runoff from pervious portion of urban cell to the neighboring cell */
+          for (n = 0; n < NDIRS; n++) {
+            int xn = x + xdirection[n];
+            int yn = y + ydirection[n];
+            if (valid_cell(Map, xn, yn)) {
+              SoilMap[yn][xn].IExcess += (1 - VType[VegMap[y][x].Veg - 1].ImpervFrac) * SoilMap[y][x].Runoff
+                *((float)TopoMap[y][x].Dir[n] / (float)TopoMap[y][x].TotalDir);
             }
           }
-          else if (channel_grid_has_channel(ChannelData->stream_map, x, y)) {
-            SoilMap[y][x].IExcess += SoilMap[y][x].Runoff;
+        }
+        else {
+          for (n = 0; n < NDIRS; n++) {
+            int xn = x + xdirection[n];
+            int yn = y + ydirection[n];
+            if (valid_cell(Map, xn, yn)) {
+              SoilMap[yn][xn].IExcess += SoilMap[y][x].Runoff *((float)TopoMap[y][x].Dir[n] / (float)TopoMap[y][x].TotalDir);
+            }
           }
         }
       }
+      else if (channel_lookup_has_channel(ChannelData->stream_lookup, x, y)) {
+        SoilMap[y][x].IExcess += SoilMap[y][x].Runoff;
+      }
     }
   }/* end if Options->routing = conventional */
 
-/* MAKE SURE THIS WORKS WITH A TIMESTEP IN SECONDS */
-  else {			/* No network, so use unit hydrograph method */
-    for (y = 0; y < Map->NY; y++) {
-      for (x = 0; x < Map->NX; x++) {
-        if (INBASIN(TopoMap[y][x].Mask)) {
-          TravelTime = (int)TopoMap[y][x].Travel;
-          if (TravelTime != 0) {
-            WaveLength = HydrographInfo->WaveLength[TravelTime - 1];
-            for (Step = 0; Step < WaveLength; Step++) {
-              Lag = UnitHydrograph[TravelTime - 1][Step].TimeStep;
-              Hydrograph[Lag] += SoilMap[y][x].Runoff * UnitHydrograph[TravelTime - 1][Step].Fraction;
-
-            }
-            SoilMap[y][x].Runoff = 0.0;
-          }
-        }
+  /* No network, so use unit hydrograph method.  The hydrograph is a ring
+     buffer of bins of one time step, starting at Head (see
+     InitUnitHydrograph()).  The runoff is summed per travel time class and
+     spread over the bins with the unit hydrograph of the class. */
+  else {
+    for (i = 0; i < HydrographInfo->MaxTravelTime; i++)
+      HydrographInfo->ClassRunoff[i] = 0.0;
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      TravelTime = (int)TopoMap[y][x].Travel;
+      if (TravelTime != 0) {
+        HydrographInfo->ClassRunoff[TravelTime - 1] += SoilMap[y][x].Runoff;
+        SoilMap[y][x].Runoff = 0.0;
       }
     }
 
-    StreamFlow = 0.0;
-    for (i = 0; i < Time->Dt; i++)
-      StreamFlow += (Hydrograph[i] * Map->DX * Map->DY) / Time->Dt;
-
-    /* Advance Hydrograph */
-    for (i = 0; i < Time->Dt; i++) {
-      for (j = 0; j < HydrographInfo->TotalWaveLength - 1; j++) {
-        Hydrograph[j] = Hydrograph[j + 1];
+    NBins = HydrographInfo->NBins;
+    for (i = 0; i < HydrographInfo->MaxTravelTime; i++) {
+      if (HydrographInfo->ClassRunoff[i] == 0.0)
+        continue;
+      for (Bin = 0, j = HydrographInfo->Head;
+           Bin < HydrographInfo->NClassBins[i]; Bin++, j++) {
+        if (j == NBins)
+          j = 0;
+        Hydrograph[j] += HydrographInfo->ClassRunoff[i] *
+          HydrographInfo->ClassBins[i][Bin];
       }
-
     }
 
-    /* Set the last elements of the hydrograph to zero */
-    for (i = 0; i < Time->Dt; i++)
-      Hydrograph[HydrographInfo->TotalWaveLength - (i + 1)] = 0.0;
+    StreamFlow = (Hydrograph[HydrographInfo->Head] * Map->DX * Map->DY) /
+      Time->Dt;
+
+    /* Advance Hydrograph */
+    Hydrograph[HydrographInfo->Head] = 0.0;
+    HydrographInfo->Head = (HydrographInfo->Head + 1) % NBins;
 
     PrintDate(&(Time->Current), Dump->Stream.FilePtr);
     fprintf(Dump->Stream.FilePtr, " %g\n", StreamFlow);
@@ -0,0 +1,731 @@
+/*
+ * SUMMARY:      RunDHSVM.c - Run DHSVM for one parameter vector
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Entry points to run DHSVM repeatedly within one process.
+ *               InitStaticInput() reads the configuration file and all the
+ *               inputs that do not depend on the parameter vector (terrain,
+ *               met stations, met maps and interpolation weights).
+ *               RunParameterSample() then builds the parameter dependent
+ *               model state, runs the model over the full period and
+ *               releases that state again, so that it can be called once
+ *               for every sample of an ensemble.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitStaticInput()
+ *               RunParameterSample()
+ *               RunModel()
+ *               PixelBalance()
+ *               ParallelPixelBalance()
+ *               CatchPixelBalance()
+ * COMMENTS:
+ */
+
+/******************************************************************************/
+/*				    INCLUDES                                  */
+/******************************************************************************/
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "settings.h"
+#include "constants.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+#include "fileio.h"
+#include "getinit.h"
+#include "massenergy.h"
+#include "DHSVMChannel.h"
+#include "channel.h"
+#include "rundhsvm.h"
+#include "staticshare.h"
+
+static int GetMaxSoilLayers(LISTPTR Input);
+static void PixelBalance(STATICINPUT *Static, MODELSTATE *State, int y, int x,
+			 int shade_offset);
+#ifdef _OPENMP
+static void ParallelPixelBalance(STATICINPUT *Static, MODELSTATE *State,
+				 int shade_offset);
+static int CatchPixelBalance(STATICINPUT *Static, MODELSTATE *State, int y,
+			     int x, int shade_offset);
+#endif
+
+/*****************************************************************************
+  Function name: InitStaticInput()
+
+  Purpose      : Read everything that is shared by all model runs
+
+  Required     :
+    char *ConfigFile     - DHSVM configuration file
+    int argc, char **argv - command line, only used for X11 graphics
+    STATICINPUT *Static  - structure to fill
+
+  Returns      : void
+
+  Modifies     : Static
+
+  Comments     : Nothing read here may depend on the parameter vector.  The
+                 soil and vegetation tables are parameter dependent, so only
+                 the number of soil layers is taken from the [SOILS] section.
+*****************************************************************************/
+void InitStaticInput(char *ConfigFile, int argc, char **argv,
+		     STATICINPUT *Static)
+{
+  char ShareFile[BUFSIZE + 1];	/* Shared static file, optional */
+
+  memset(Static, 0, sizeof(STATICINPUT));
+  Static->argc = argc;
+  Static->argv = argv;
+
+  strcpy(Static->InFiles.Const, ConfigFile);
+
+  ReadInitFile(Static->InFiles.Const, &(Static->Input));
+  InitConstants(Static->Input, &(Static->Options), &(Static->Map),
+		&(Static->SolarGeo), &(Static->Time), NULL);
+
+  InitFileIO(Static->Options.FileFormat);
+
+  InitParameterBindings(Static->Input, &(Static->Bindings));
+
+  printf("\nInitializing terrain maps\n");
+  InitTopoMap(Static->Input, &(Static->Options), &(Static->Map),
+	      &(Static->TopoMap));
+
+  Static->NSoilLayers = GetMaxSoilLayers(Static->Input);
+
+  InitMetSources(Static->Input, &(Static->Options), &(Static->Map),
+		 Static->TopoMap, Static->NSoilLayers, &(Static->Time),
+		 &(Static->InFiles), &(Static->NStats), &(Static->Stat),
+		 &(Static->Radar), &(Static->MM5Map), &(Static->Grid));
+
+  InitMetMaps(Static->Input, Static->Time.NDaySteps, &(Static->Map),
+	      &(Static->Radar), &(Static->Options), Static->InFiles.WindMapPath,
+	      Static->InFiles.PrecipLapseFile, &(Static->PrecipLapseMap),
+	      &(Static->PrismMap), &(Static->ShadowMap), &(Static->SkyViewMap),
+	      &(Static->PptMultiplierMap), &(Static->RadarMap),
+	      Static->NSoilLayers, &(Static->MM5Input), &(Static->WindModel));
+
+  /* weights and met maps in a file shared with the other processes, or
+     calculated by this process alone */
+  GetInitString("OPTIONS", "SHARED STATIC FILE", "", ShareFile,
+		(unsigned long) BUFSIZE, Static->Input);
+  if (!IsEmptyStr(ShareFile) && strncmp(ShareFile, "none", 4))
+    InitStaticShare(ShareFile, &(Static->Map), &(Static->Options),
+		    Static->TopoMap, &(Static->MetWeights), Static->Stat,
+		    Static->NStats, &(Static->Grid), Static->SkyViewMap,
+		    Static->PrecipLapseMap, Static->PptMultiplierMap,
+		    Static->WindModel);
+  else
+    InitInterpolationWeights(&(Static->Map), &(Static->Options),
+			     Static->TopoMap, &(Static->MetWeights),
+			     Static->Stat, Static->NStats, &(Static->Grid));
+}
+
+/*****************************************************************************
+  Function name: RunParameterSample()
+
+  Purpose      : Run the model for one parameter vector
+
+  Required     :
+    STATICINPUT *Static - inputs read by InitStaticInput()
+    double *Anovapara   - parameter vector, the last entry is the run number
+
+  Returns      : EXIT_SUCCESS, or the error code if the run failed
+
+  Modifies     : Output files for this run number
+
+  Comments     : Errors reported through ReportError() during the run end
+                 this run only; the model state built so far is released
+                 and the error code is returned to the caller.  A run whose
+                 output files could not be written fails with code 41.
+*****************************************************************************/
+int RunParameterSample(STATICINPUT *Static, double *Anovapara)
+{
+  const char *Routine = "RunParameterSample";
+  jmp_buf Jump;
+  MODELSTATE *State;
+  int Status;
+
+  if (!(State = (MODELSTATE *)calloc(1, sizeof(MODELSTATE))))
+    ReportError((char *)Routine, 1);
+
+  ErrorJump = &Jump;
+  if ((Status = setjmp(Jump)) == 0) {
+    RunModel(Static, Anovapara, State);
+    Status = EXIT_SUCCESS;
+  }
+  ErrorJump = NULL;
+
+  if (!FreeModelState(Static, State) && Status == EXIT_SUCCESS) {
+    ReportWarning(State->Dump.Path, 41);
+    Status = 41;
+  }
+  free(State);
+
+  return Status;
+}
+
+/*****************************************************************************
+  Function name: RunModel()
+
+  Purpose      : Initialize the parameter dependent state and perform the
+                 calculations for the entire model period
+
+  Required     :
+    STATICINPUT *Static - inputs read by InitStaticInput()
+    double *Anovapara   - parameter vector, the last entry is the run number
+    MODELSTATE *State   - zeroed structure to hold the model state
+
+  Returns      : void
+
+  Modifies     : State
+
+  Comments     : All allocations are recorded in State, so that
+                 FreeModelState() can release them even if the run ends
+                 early.
+*****************************************************************************/
+void RunModel(STATICINPUT *Static, double *Anovapara, MODELSTATE *State)
+{
+  MAPSIZE *Map = &(Static->Map);
+  TOPOPIX **TopoMap = Static->TopoMap;
+  METLOCATION *Stat = Static->Stat;
+  int NStats = Static->NStats;
+  OPTIONSTRUCT *Options = &(State->Options);
+  TIMESTRUCT *Time = &(State->Time);
+  SOLARGEOMETRY *SolarGeo = &(State->SolarGeo);
+  PIXMET LocalMet;				/* Meteorological conditions for current pixel */
+  clock_t start, finish1;
+  double runtime = 0.0;
+  float roadarea;
+  int t = 0;
+  int i;
+  int j;
+  int c;						/* basin cell counter */
+  int x;						/* row counter */
+  int y;						/* column counter */
+  int shade_offset;				/* a fast way of handling arraay position given the number of mm5 input options */
+
+  State->RunNumber = Anovapara[Static->Bindings.NParam - 1];
+
+  /* Options, time and solar geometry are changed during a run, so every run
+     starts from a copy */
+  State->Options = Static->Options;
+  State->Time = Static->Time;
+  State->SolarGeo = Static->SolarGeo;
+
+  /* the met files are read sequentially, rewind them for this run.  They
+     are closed if the records come from the met cache. */
+  for (i = 0; i < NStats; i++)
+    if (Stat[i].MetFile.FilePtr != NULL)
+      rewind(Stat[i].MetFile.FilePtr);
+
+  printf("\nSTARTING INITIALIZATION PROCEDURES FOR RUN %d\n\n", State->RunNumber);
+
+  /* Start recording time */
+  start = clock();
+
+  InitTables(Time->NDaySteps, Static->Input, Options, Map, &(State->SType),
+	     &(State->Soil), &(State->VType), &(State->Veg), &(Static->Bindings), Anovapara);
+
+  InitSoilMap(Static->Input, Options, Map, &(State->Soil), TopoMap,
+	      &(State->SoilMap), &(State->SoilCells), State->SType);
+  InitVegMap(Options, Static->Input, Map, &(State->VegMap), State->VType);
+  if (Options->CanopyGapping)
+    InitCanopyGapMap(Options, Static->Input, Map, &(State->Soil), &(State->Veg),
+		     State->VType, &(State->VegMap), State->SType, &(State->SoilMap));
+
+  InitSnowMap(Map, &(State->SnowMap), Time);
+
+  InitMappedConstants(Static->Input, Options, Map, &(State->SnowMap), Anovapara);
+
+  CheckOut(Options, State->Veg, State->Soil, State->VType, State->SType, Map,
+	   TopoMap, State->VegMap, State->SoilMap, &(State->SoilCells));
+
+#ifdef TOPO_DUMP
+  DumpTopo(Map, TopoMap);
+#endif
+
+  if (Options->HasNetwork)
+    InitChannel(Static->Input, Map, Time->Dt, &(State->ChannelData),
+		&(State->SoilCells), &(State->MaxStreamID), &(State->MaxRoadID),
+		Options);
+  else if (Options->Extent != POINT)
+    InitUnitHydrograph(Static->Input, Map, Time->Dt, TopoMap,
+		       &(State->UnitHydrograph), &(State->Hydrograph),
+		       &(State->HydrographInfo));
+
+  InitNetwork(Map->NY, Map->NX, Map->DX, Map->DY, TopoMap, &(State->SoilCells),
+	      Map->BasinIndex, State->VegMap, State->VType, &(State->Network), &(State->ChannelData),
+	      State->Veg, Options);
+
+  /* the following piece of code is for the UW PRISM project */
+  /* for real-time verification of SWE at Snotel sites */
+  /* Other users, set OPTION.SNOTEL to FALSE, or use TRUE with caution */
+
+  if (Options->Snotel == TRUE && Options->Outside == FALSE) {
+    printf
+      ("Warning: All met stations locations are being set to the vegetation class GLACIER\n");
+    printf
+      ("Warning: This requires that you have such a vegetation class in your vegetation table\n");
+    printf("To disable this feature set Snotel OPTION to FALSE\n");
+    for (i = 0; i < NStats; i++) {
+      printf("veg type for station %d is %d ", i,
+	     State->VegMap[Stat[i].Loc.N][Stat[i].Loc.E].Veg);
+      for (j = 0; j < State->Veg.NTypes; j++) {
+	    if (State->VType[j].Index == GLACIER) {
+	      State->VegMap[Stat[i].Loc.N][Stat[i].Loc.E].Veg = j;
+		  break;
+		}
+      }
+      if (j == State->Veg.NTypes) {	/* glacier class not found */
+	    ReportError("MainDHSVM", 62);
+	  }
+      printf("setting to glacier type (assumed bare class): %d\n", j);
+    }
+  }
+
+  InitEvapMap(Map, &(State->EvapMap), State->SoilMap, &(State->Soil),
+	      State->VegMap, &(State->Veg), TopoMap);
+  InitPrecipMap(Map, &(State->PrecipMap), State->VegMap, &(State->Veg), TopoMap);
+  InitRadMap(Map, &(State->RadiationMap));
+  if (!(State->StepMap = (PIXSTEP **) calloc(Map->NY, sizeof(PIXSTEP *))))
+    ReportError("RunModel", 1);
+  for (y = 0; y < Map->NY; y++) {
+    if (!(State->StepMap[y] = (PIXSTEP *) calloc(Map->NX, sizeof(PIXSTEP))))
+      ReportError("RunModel", 1);
+  }
+  if (!(State->RouteWork.FlowGrad =
+	(float *) calloc(Map->NY * Map->NX, sizeof(float))))
+    ReportError("RunModel", 1);
+  if (!(State->RouteWork.TotalDir =
+	(unsigned int *) calloc(Map->NY * Map->NX, sizeof(unsigned int))))
+    ReportError("RunModel", 1);
+  if (!(State->RouteWork.Dir =
+	(unsigned char *) calloc(Map->NY * Map->NX * NDIRS, sizeof(unsigned char))))
+    ReportError("RunModel", 1);
+
+  InitDump(Static->Input, Options, Map, State->Soil.MaxLayers, State->Veg.MaxLayers,
+	   Time->Dt, TopoMap, &(State->Dump), &(State->NGraphics),
+	   &(State->which_graphics), State->RunNumber);
+
+#ifndef SNOW_ONLY
+  if (Options->HasNetwork == TRUE) {
+    InitChannelDump(Options, &(State->ChannelData), State->Dump.Path,
+		    State->Dump.EnsembleStore, Time, State->RunNumber);
+    ReadChannelState(State->Dump.InitStatePath, &(Time->Start),
+		     State->ChannelData.streams);
+	if (Options->StreamTemp && Options->CanopyShading)
+	  InitChannelRVeg(Time, State->ChannelData.streams);
+  }
+#endif
+
+  InitAggregated(Options, State->Veg.MaxLayers, State->Soil.MaxLayers, &(State->Total));
+
+  InitModelState(&(Time->Start), Time->NDaySteps, Map, Options, State->PrecipMap,
+		 State->SnowMap, State->SoilMap, &(State->SoilCells), State->Soil,
+		 State->SType, State->VegMap, State->Veg, State->VType,
+		 State->Dump.InitStatePath,
+		 TopoMap, State->Network, &(State->HydrographInfo), State->Hydrograph);
+
+  InitNewMonth(Time, Options, Map, TopoMap, Static->PrismMap, Static->ShadowMap,
+	       &(Static->InFiles), State->Veg.NTypes, State->VType, NStats, Stat,
+	       State->Dump.InitStatePath, &(State->VegMap));
+
+  InitNewDay(Time->Current.JDay, SolarGeo);
+
+  if (State->NGraphics > 0 && Static->MetMap == NULL) {
+    printf("Initialzing X11 display and graphics \n");
+    InitXGraphics(Static->argc, Static->argv, Map->NY, Map->NX,
+		  State->NGraphics, &(Static->MetMap));
+  }
+
+  shade_offset = FALSE;
+  if (Options->Shading == TRUE)
+    shade_offset = TRUE;
+
+  /* setup for mass balance calculations */
+  Aggregate(Map, Options, TopoMap, &(State->Soil), &(State->Veg), State->VegMap,
+	    State->EvapMap, State->PrecipMap, State->RadiationMap, State->SnowMap,
+	    State->SoilMap, &(State->SoilCells), &(State->Total), State->VType,
+	    State->Network, &(State->ChannelData), &roadarea, Time->Dt);
+
+  State->Mass.StartWaterStorage =
+    State->Total.Soil.IExcess + State->Total.CanopyWater + State->Total.SoilWater +
+    State->Total.Snow.Swq + State->Total.SatFlow;
+  State->Mass.OldWaterStorage = State->Mass.StartWaterStorage;
+
+  /* computes the number of grid cell contributing to one segment */
+  if (Options->StreamTemp)
+	Init_segment_ncell(TopoMap, State->ChannelData.stream_map, Map->NY, Map->NX,
+			   State->ChannelData.streams);
+
+/*****************************************************************************
+  Perform Calculations
+*****************************************************************************/
+  while (Before(&(Time->Current), &(Time->End)) ||
+	 IsEqualTime(&(Time->Current), &(Time->End))) {
+
+    /* reset aggregated variables */
+    ResetAggregate(&(State->Soil), &(State->Veg), &(State->Total), Options);
+
+    /* redistribute snow based on snow surface slope etc */
+    if (Options->SnowSlide)
+	    Avalanche(Map, TopoMap, Time, Options, State->SnowMap,
+		      &(State->RouteWork));
+
+    if (IsNewWaterYear(&(Time->Current)))
+      InitNewWaterYear(Time, Options, Map, TopoMap, State->SnowMap);
+
+    if (IsNewMonth(&(Time->Current), Time->Dt))
+      InitNewMonth(Time, Options, Map, TopoMap, Static->PrismMap, Static->ShadowMap,
+		   &(Static->InFiles), State->Veg.NTypes, State->VType, NStats, Stat,
+		   State->Dump.InitStatePath, &(State->VegMap));
+
+    if (IsNewDay(Time->DayStep)) {
+      InitNewDay(Time->Current.JDay, SolarGeo);
+      PrintDate(&(Time->Current), stdout);
+      printf("\n");
+    }
+
+    InitNewStep(&(Static->InFiles), Map, Time, State->Soil.MaxLayers, Options,
+		NStats, Stat, Static->InFiles.RadarFile, &(Static->Radar),
+		Static->RadarMap, SolarGeo, TopoMap, State->SoilMap,
+		&(State->SoilCells), Static->MM5Input,
+		Static->PrecipLapseMap, Static->WindModel, &(Static->MM5Map));
+
+    /* initialize channel/road networks for time step */
+    if (Options->HasNetwork) {
+      if (State->ChannelData.stream_route != NULL)
+        channel_step_initialize_network(State->ChannelData.stream_route);
+      if (State->ChannelData.road_route != NULL)
+        channel_step_initialize_network(State->ChannelData.road_route);
+    }
+
+
+    /* vertical mass and energy balance of each pixel.  A pixel only changes
+       its own state, its contributions to shared totals are stored in
+       StepMap and added in pixel order below, so the results do not depend
+       on the number of threads */
+#ifdef _OPENMP
+    if (Options->Threads > 1)
+      ParallelPixelBalance(Static, State, shade_offset);
+    else
+#endif
+      for (c = 0; c < Map->NumCells; c++) {
+        y = Map->BasinCell[c] / Map->NX;
+        x = Map->BasinCell[c] % Map->NX;
+        PixelBalance(Static, State, y, x, shade_offset);
+      }
+
+    /* add the contributions of the pixels to the shared totals, in pixel
+       order */
+    for (c = 0; c < Map->NumCells; c++) {
+      y = Map->BasinCell[c] / Map->NX;
+      x = Map->BasinCell[c] % Map->NX;
+      AggregateRadiation(State->Veg.MaxLayers,
+        State->VType[State->VegMap[y][x].Veg - 1].NVegLayers,
+        &(State->RadiationMap[y][x]), &(State->Total.Rad));
+      if (State->StepMap[y][x].ChannelInflow > 0.)
+        channel_lookup_inc_inflow(State->ChannelData.stream_lookup, x, y,
+          State->StepMap[y][x].ChannelInflow);
+      if (Options->StreamTemp &&
+          channel_lookup_has_channel(State->ChannelData.stream_lookup, x, y))
+        channel_lookup_inc_other(State->ChannelData.stream_lookup, x, y,
+          &(State->RadiationMap[y][x]), &(State->StepMap[y][x].Met),
+          Static->SkyViewMap[y][x]);
+    }
+
+    /* RouteChannel() gets the met conditions of the last basin pixel, as
+       the serial pixel loop left them */
+    c = Map->BasinCell[Map->NumCells - 1];
+    LocalMet = State->StepMap[c / Map->NX][c % Map->NX].Met;
+
+	/* Average all RBM inputs over each segment */
+	if (Options->StreamTemp) {
+	  channel_grid_avg(State->ChannelData.streams);
+      if (Options->CanopyShading)
+	    CalcCanopyShading(Time, State->ChannelData.streams, SolarGeo);
+	}
+
+ #ifndef SNOW_ONLY
+
+    RouteSubSurface(Time->Dt, Map, TopoMap, State->VType, State->VegMap,
+		    State->Network, State->SType, State->SoilMap, &(State->SoilCells),
+		    &(State->ChannelData),
+		    Time, Options, State->Dump.SatExtent.FilePtr, State->MaxStreamID, State->SnowMap,
+		    &(State->RouteWork));
+
+    if (Options->HasNetwork)
+      RouteChannel(&(State->ChannelData), Time, Map, TopoMap, State->SoilMap,
+		   &(State->Total), Options, State->Network, State->SType,
+		   State->PrecipMap, LocalMet.Tair, LocalMet.Rh, State->SnowMap);
+
+    if (Options->Extent == BASIN)
+      RouteSurface(Map, Time, TopoMap, State->SoilMap, Options,
+        State->UnitHydrograph, &(State->HydrographInfo), State->Hydrograph,
+        &(State->Dump), State->VegMap, State->VType, &(State->ChannelData));
+
+
+#endif
+
+    if (State->NGraphics > 0)
+      draw(&(Time->Current), IsEqualTime(&(Time->Current), &(Time->Start)),
+	   Time->DayStep, Map, State->NGraphics, State->which_graphics, State->VType,
+	   State->SType, State->SnowMap, State->SoilMap, &(State->SoilCells),
+	   State->VegMap, TopoMap,
+	   State->PrecipMap, Static->PrismMap, Static->SkyViewMap, Static->ShadowMap,
+	   State->EvapMap, State->RadiationMap, Static->MetMap, State->Network, Options);
+
+    Aggregate(Map, Options, TopoMap, &(State->Soil), &(State->Veg), State->VegMap,
+	      State->EvapMap, State->PrecipMap, State->RadiationMap, State->SnowMap,
+	      State->SoilMap, &(State->SoilCells), &(State->Total), State->VType,
+	      State->Network, &(State->ChannelData), &roadarea, Time->Dt);
+
+    if (Options->SnowStats)
+      SnowStats(&(Time->Current), Map, Options, TopoMap, State->SnowMap, Time->Dt);
+
+    MassBalance(&(Time->Current), &(Time->Start), &(State->Dump.Balance),
+		&(State->Total), &(State->Mass));
+
+    ExecDump(Map, &(Time->Current), &(Time->Start), Options, &(State->Dump), TopoMap,
+	     State->EvapMap, State->RadiationMap, State->PrecipMap, State->SnowMap,
+	     Static->MetMap, State->VegMap, &(State->Veg), State->SoilMap,
+	     &(State->SoilCells), State->Network, &(State->ChannelData), &(State->Soil), &(State->Total),
+	     &(State->HydrographInfo), State->Hydrograph);
+
+    IncreaseTime(Time);
+	t += 1;
+  }
+
+  ExecDump(Map, &(Time->Current), &(Time->Start), Options, &(State->Dump), TopoMap,
+	   State->EvapMap, State->RadiationMap, State->PrecipMap, State->SnowMap,
+	   Static->MetMap, State->VegMap, &(State->Veg), State->SoilMap,
+	   &(State->SoilCells), State->Network, &(State->ChannelData), &(State->Soil), &(State->Total),
+	   &(State->HydrographInfo), State->Hydrograph);
+
+#ifndef SNOW_ONLY
+  FinalMassBalance(&(State->Dump.FinalBalance), &(State->Total), &(State->Mass));
+  if (State->ChannelData.ensemble != NULL)
+    SaveEnsembleStore(State->Dump.EnsembleStore, State->ChannelData.ensemble);
+#endif
+
+  printf("\nEND OF MODEL RUN\n\n");
+
+  /* record the run time at the end of each time loop */
+  finish1 = clock ();
+  runtime = (finish1-start)/CLOCKS_PER_SEC;
+  printf("***********************************************************************************");
+  printf("\nRuntime Summary:\n");
+  printf("%6.2f hours elapsed for the simulation period of %d hours (%.1f days) \n",
+	  runtime/3600, t*Time->Dt/3600, (float)t*Time->Dt/3600/24);
+}
+
+/*****************************************************************************
+  GetMaxSoilLayers()
+
+  Read the maximum number of soil layers from the [SOILS] section without
+  building the (parameter dependent) soil table
+*****************************************************************************/
+static int GetMaxSoilLayers(LISTPTR Input)
+{
+  char KeyName[BUFSIZE + 1];
+  char VarStr[BUFSIZE + 1];
+  int NSoils;
+  int NLayers;
+  int MaxLayers = 0;
+  int i;
+
+  GetInitString("SOILS", "NUMBER OF SOIL TYPES", "", VarStr,
+		(unsigned long)BUFSIZE, Input);
+  if (!CopyInt(&NSoils, VarStr, 1))
+    ReportError("NUMBER OF SOIL TYPES", 51);
+
+  for (i = 0; i < NSoils; i++) {
+    sprintf(KeyName, "NUMBER OF SOIL LAYERS %d", i + 1);
+    GetInitString("SOILS", KeyName, "", VarStr, (unsigned long)BUFSIZE, Input);
+    if (!CopyInt(&NLayers, VarStr, 1))
+      ReportError(KeyName, 51);
+    if (NLayers > MaxLayers)
+      MaxLayers = NLayers;
+  }
+
+  return MaxLayers;
+}
+
+/*****************************************************************************
+  Function name: PixelBalance()
+
+  Purpose      : Local meteorology and vertical mass and energy balance of
+                 one pixel for the current time step
+
+  Required     :
+    STATICINPUT *Static - inputs read by InitStaticInput()
+    MODELSTATE *State   - model state of the run
+    int y, x            - pixel
+    int shade_offset    - TRUE if the MM5 input has a shading map
+
+  Returns      : void
+
+  Modifies     : State for pixel (y, x) only
+
+  Comments     : Pixels are independent, so this may run for several pixels
+                 at the same time.  Contributions to totals shared by all
+                 pixels are stored in State->StepMap[y][x] instead.
+*****************************************************************************/
+static void PixelBalance(STATICINPUT *Static, MODELSTATE *State, int y, int x,
+			 int shade_offset)
+{
+  MAPSIZE *Map = &(Static->Map);
+  TOPOPIX **TopoMap = Static->TopoMap;
+  METLOCATION *Stat = Static->Stat;
+  int NStats = Static->NStats;
+  OPTIONSTRUCT *Options = &(State->Options);
+  TIMESTRUCT *Time = &(State->Time);
+  SOLARGEOMETRY *SolarGeo = &(State->SolarGeo);
+  PIXMET LocalMet;				/* Meteorological conditions for current pixel */
+  int c = Map->BasinIndex[y * Map->NX + x];	/* basin cell of the pixel */
+  int i;
+
+  if (Options->Shading)
+    LocalMet =
+      MakeLocalMetData(y, x, Map, Time->DayStep, Time->NDaySteps, Options, NStats,
+		       Stat, &(Static->MetWeights), TopoMap[y][x].Dem,
+		       &(State->RadiationMap[y][x]), &(State->PrecipMap[y][x]),
+		       &(Static->Radar), Static->RadarMap, Static->PrismMap,
+		       &(State->SnowMap[y][x]), &(State->VegMap[y][x].Type),
+		       &(State->VegMap[y][x]), Static->MM5Input, Static->WindModel,
+		       Static->PrecipLapseMap, &(Static->MetMap),
+		       Static->PptMultiplierMap[y][x], State->NGraphics,
+		       Time->Current.Month, Static->SkyViewMap[y][x],
+		       Static->ShadowMap[Time->DayStep][y][x],
+		       SolarGeo->SunMax, SolarGeo->SineSolarAltitude);
+  else
+    LocalMet =
+      MakeLocalMetData(y, x, Map, Time->DayStep, Time->NDaySteps, Options, NStats,
+		       Stat, &(Static->MetWeights), TopoMap[y][x].Dem,
+		       &(State->RadiationMap[y][x]), &(State->PrecipMap[y][x]),
+		       &(Static->Radar), Static->RadarMap, Static->PrismMap,
+		       &(State->SnowMap[y][x]), &(State->VegMap[y][x].Type),
+		       &(State->VegMap[y][x]), Static->MM5Input, Static->WindModel,
+		       Static->PrecipLapseMap, &(Static->MetMap),
+		       Static->PptMultiplierMap[y][x], State->NGraphics,
+		       Time->Current.Month, 0.0, 0.0,
+		       SolarGeo->SunMax, SolarGeo->SineSolarAltitude);
+
+  /* get surface tempeature of each soil layer */
+  for (i = 0; i < State->Soil.MaxLayers; i++) {
+    if (Options->HeatFlux == TRUE) {
+      if (Options->MM5 == TRUE)
+	State->SoilMap[y][x].Temp[i] =
+	  Static->MM5Input[shade_offset + i + N_MM5_MAPS][y][x];
+
+      /* read tempeature of each soil layer from met station input */
+      else
+	State->SoilMap[y][x].Temp[i] = Stat[0].Data.Tsoil[i];
+    }
+    /* if heat flux option is turned off, soil temperature of all 3 layers
+       is taken equal to air tempeature */
+    else
+      State->SoilMap[y][x].Temp[i] = LocalMet.Tair;
+  }
+
+  MassEnergyBalance(Options, y, x, SolarGeo->SineSolarAltitude, Map->DX, Map->DY,
+    Time->Dt, Options->HeatFlux, Options->CanopyRadAtt, Options->Infiltration,
+    State->Soil.MaxLayers, State->Veg.MaxLayers, &LocalMet,
+    &(State->Network[y][x]), &(State->PrecipMap[y][x]),
+    &(State->VType[State->VegMap[y][x].Veg - 1]), &(State->VegMap[y][x]),
+    &(State->SType[State->SoilMap[y][x].Soil - 1]), &(State->SoilMap[y][x]),
+    State->SoilCells.Depth[c], State->SoilCells.SatFlow[c],
+    &(State->SoilCells.TableDepth[c]), &(State->SnowMap[y][x]), &(State->RadiationMap[y][x]), &(State->EvapMap[y][x]),
+    &(State->ChannelData), &(State->StepMap[y][x].ChannelInflow));
+
+  State->StepMap[y][x].Met = LocalMet;
+  State->PrecipMap[y][x].SumPrecip += State->PrecipMap[y][x].Precip;
+}
+
+#ifdef _OPENMP
+/*****************************************************************************
+  Function name: ParallelPixelBalance()
+
+  Purpose      : PixelBalance() for all basin pixels, on Options->Threads
+                 threads
+
+  Required     :
+    STATICINPUT *Static - inputs read by InitStaticInput()
+    MODELSTATE *State   - model state of the run
+    int shade_offset    - TRUE if the MM5 input has a shading map
+
+  Returns      : void
+
+  Modifies     : State for all basin pixels
+
+  Comments     : ReportError() cannot jump out of the parallel region, so
+                 each thread catches the errors of its pixels with
+                 CatchPixelBalance().
+                 Pixels after a failed one are skipped, and the error of the
+                 first failed pixel in basin order is reported after the
+                 region.  A run therefore fails with the same error, and
+                 returns to RunParameterSample(), for any number of threads.
+*****************************************************************************/
+static void ParallelPixelBalance(STATICINPUT *Static, MODELSTATE *State,
+				 int shade_offset)
+{
+  MAPSIZE *Map = &(Static->Map);
+  char ErrorString[BUFSIZE + 1];
+  int ErrorCell = Map->NumCells;	/* First failed pixel */
+  int ErrorCode = 0;
+  int Cell;
+  int Code;
+  int c;
+
+#pragma omp parallel for num_threads(State->Options.Threads) schedule(dynamic, 64) private(Cell, Code)
+  for (c = 0; c < Map->NumCells; c++) {
+#pragma omp atomic read
+    Cell = ErrorCell;
+    if (c > Cell)
+      continue;
+    Code = CatchPixelBalance(Static, State, Map->BasinCell[c] / Map->NX,
+			     Map->BasinCell[c] % Map->NX, shade_offset);
+    if (Code != 0) {
+#pragma omp critical (PixelError)
+      if (c < ErrorCell) {
+	strcpy(ErrorString, LoopErrorString());
+	ErrorCode = Code;
+#pragma omp atomic write
+	ErrorCell = c;
+      }
+    }
+  }
+
+  if (ErrorCode != 0)
+    ReportError(ErrorString, ErrorCode);
+}
+
+/*****************************************************************************
+  Function name: CatchPixelBalance()
+
+  Purpose      : PixelBalance() of one pixel inside a parallel region
+
+  Required     : as PixelBalance()
+
+  Returns      : int - 0, or the error code if ReportError() was called
+
+  Comments     : The message of the error is in LoopErrorString()
+*****************************************************************************/
+static int CatchPixelBalance(STATICINPUT *Static, MODELSTATE *State, int y,
+			     int x, int shade_offset)
+{
+  jmp_buf Jump;
+  int Code;
+
+  LoopJump = &Jump;
+  if ((Code = setjmp(Jump)) == 0)
+    PixelBalance(Static, State, y, x, shade_offset);
+  LoopJump = NULL;
+
+  return Code;
+}
+#endif
@@ -35,10 +35,13 @@ static FLOATTABLE svp;		/* Table that contains saturated vapor
 
   Modifies     : none
   
-  Comments     :  Table runs from -100 C to 100 C with an interval of 0.02 C
+  Comments     :  Table runs from -100 C to 100 C with an interval of 0.02 C.
+                  The table is only built once per process.
 *****************************************************************************/
 void InitSatVaporTable(void)
 {
+  if (svp.Data != NULL)
+    return;
   InitFloatTable(30000L, -300., .02, CalcVaporPressure, &svp);
 }
 
@@ -0,0 +1,158 @@
+/*
+ * SUMMARY:      ShadowFile.c - Monthly shadow maps mapped from their files
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  A monthly shadow file holds one byte map per hour of the day.
+ *               Instead of reading the maps one by one into ShadowMap at the
+ *               start of every month, MapShadowMonth() maps the whole file
+ *               read-only and points the rows of ShadowMap into it.  Files
+ *               stay mapped for the life of the process, so later months and
+ *               later runs reuse them, and the file of the next month is
+ *               mapped ahead of time and read in the background by the
+ *               kernel.
+ * DESCRIP-END.
+ * FUNCTIONS:    MapShadowMonth()
+ * COMMENTS:     Only for the binary file formats.  The shade factor is a
+ *               single byte, so byte swapping does not apply.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+
+/* mapped shadow file of each month */
+typedef struct {
+  char FileName[MAXSTRING + 1];
+  unsigned char *Data;
+  size_t Size;
+} SHADOWFILE;
+
+static SHADOWFILE ShadowFiles[12];
+
+static unsigned char *MapShadowFile(OPTIONSTRUCT *Options, int Month,
+				    size_t Size, int Required);
+static int ShadowLayer(int NDaySteps, int Step);
+
+/*****************************************************************************
+  Function name: MapShadowMonth()
+
+  Purpose      : Point the rows of ShadowMap to the shadow file of a month
+                 and prefetch the file of the next month
+
+  Required     :
+    OPTIONSTRUCT *Options    - Shading data path and extension
+    MAPSIZE *Map             - Model area
+    int NDaySteps            - Number of time steps per day
+    int Month                - Month, 1 - 12
+    unsigned char ***ShadowMap - Shadow maps, one per time step of the day
+
+  Returns      : void
+
+  Modifies     : The row pointers of ShadowMap
+
+  Comments     : Time steps finer than an hour share the map of their hour,
+                 as in the copy that InitNewMonth() makes for NetCDF files.
+                 A missing file of the next month is only an error once that
+                 month is reached.
+*****************************************************************************/
+void MapShadowMonth(OPTIONSTRUCT *Options, MAPSIZE *Map, int NDaySteps,
+		    int Month, unsigned char ***ShadowMap)
+{
+  unsigned char *Data;
+  size_t MapSize;
+  size_t Size;
+  int i;
+  int y;
+
+  MapSize = (size_t) Map->NY * Map->NX;
+  Size = (ShadowLayer(NDaySteps, NDaySteps - 1) + 1) * MapSize;
+
+  Data = MapShadowFile(Options, Month, Size, TRUE);
+  for (i = 0; i < NDaySteps; i++)
+    for (y = 0; y < Map->NY; y++)
+      ShadowMap[i][y] = Data + ShadowLayer(NDaySteps, i) * MapSize +
+	(size_t) y * Map->NX;
+
+  MapShadowFile(Options, Month % 12 + 1, Size, FALSE);
+}
+
+/*****************************************************************************
+  MapShadowFile()
+
+  Map the shadow file of a month, unless it is mapped already, and ask the
+  kernel to read it ahead.  If the file cannot be used, report the error if
+  Required, and return NULL otherwise.
+*****************************************************************************/
+static unsigned char *MapShadowFile(OPTIONSTRUCT *Options, int Month,
+				    size_t Size, int Required)
+{
+  SHADOWFILE *File = &(ShadowFiles[Month - 1]);
+  char FileName[MAXSTRING + 1];
+  struct stat FileStat;
+  unsigned char *Data;
+  int fd;
+
+  if (snprintf(FileName, sizeof(FileName), "%s.%02d.%s",
+	       Options->ShadingDataPath, Month, Options->ShadingDataExt) >=
+      (int) sizeof(FileName)) {
+    if (Required)
+      ReportError(Options->ShadingDataPath, 3);
+    return NULL;
+  }
+  if (File->Data != NULL && File->Size >= Size &&
+      strcmp(File->FileName, FileName) == 0)
+    return File->Data;
+
+  if ((fd = open(FileName, O_RDONLY)) == -1) {
+    if (Required)
+      ReportError(FileName, 3);
+    return NULL;
+  }
+  if (fstat(fd, &FileStat) == -1 || FileStat.st_size < (off_t) Size) {
+    close(fd);
+    if (Required)
+      ReportError(FileName, 2);
+    return NULL;
+  }
+
+  Data = (unsigned char *) mmap(NULL, Size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (Data == (unsigned char *) MAP_FAILED) {
+    if (Required)
+      ReportError(FileName, 2);
+    return NULL;
+  }
+  madvise(Data, Size, MADV_WILLNEED);
+
+  if (File->Data != NULL)
+    munmap(File->Data, File->Size);
+  strcpy(File->FileName, FileName);
+  File->Data = Data;
+  File->Size = Size;
+
+  return Data;
+}
+
+/*****************************************************************************
+  ShadowLayer()
+
+  Map in the shadow file that holds the shade of a time step of the day
+*****************************************************************************/
+static int ShadowLayer(int NDaySteps, int Step)
+{
+  if (NDaySteps > 24)
+    return round(Step / (NDaySteps / 24));
+  return Step;
+}
@@ -73,15 +73,11 @@ static void slope_aspect(float dx, float dy, float celev, float
 {
   int n;
   float dzdx, dzdy;
-  float *dummyelev;
+  float dummyelev[NNEIGHBORS];
   /* this dummy varaible is added for calculation of elev difference,
   in which the elev of OUTSIDEBASIN cells (which is ZERO) is 
   replaced by the elev of the central cell */
 
-  /* allocate memory */
-  if (!(dummyelev = (float*) calloc(NNEIGHBORS, sizeof(float))))
-	  ReportError("slope_aspect( )", 1);
-  
   for (n = 0; n < NNEIGHBORS; n++) {
       if (nelev[n] == OUTSIDEBASIN) {
 		  dummyelev[n] = celev;
@@ -102,7 +98,6 @@ static void slope_aspect(float dx, float dy, float celev, float
 	  /* convert from radian to degree */
 	  *aspect = atan2(dzdx, dzdy) ;
   }
-  free(dummyelev);
   return;
 }
 /* -------------------------------------------------------------
@@ -119,17 +114,16 @@ static void flow_fractions(float dx, float dy, float slope, float aspect,
   float cosine = cos(aspect);
   float sine = sin(aspect);
   float total_width, effective_width;
-  float *cos, *sin;
+  float cos[MAXDIRS/2], sin[MAXDIRS/2];
   int n;
   float drop[NDIRS]; 
   float maxdrop; 
   int steepest;
  
-  /* allocate memory */
-  if (!(cos = (float*) calloc(NDIRS/2, sizeof(float))))
-	  ReportError("slope_aspect( )", 1);
-  if (!(sin = (float*) calloc(NDIRS/2, sizeof(float))))
-	  ReportError("slope_aspect( )", 1);
+  /* dir may hold the fractions of an earlier call, and the D8 case below
+     only sets the steepest direction */
+  for (n = 0; n < NDIRS; n++)
+    dir[n] = 0;
 
  switch (NDIRS) {
   case 4:
@@ -229,8 +223,6 @@ static void flow_fractions(float dx, float dy, float slope, float aspect,
     ReportError("flow_fractions",65);
     assert(0);			/* other cases don't work either */
   }
-  free(sin);
-  free(cos);
   return;
 }
 /* -------------------------------------------------------------
@@ -377,40 +369,43 @@ void qs(ITEM *item, int left, int right)
 /* -------------------------------------------------------------
    HeadSlopeAspect
    This computes slope and aspect using the water table elevation. 
+   FlowGrad, Dir and TotalDir are flat NY * NX arrays, with NDIRS entries
+   of Dir per cell.
 
    Comment: rewritten to fill the sinks (Ning, 2013)
    ------------------------------------------------------------- */
 void HeadSlopeAspect(MAPSIZE * Map, TOPOPIX ** TopoMap, SOILPIX ** SoilMap,
-		     float **FlowGrad, unsigned char ***Dir, unsigned int **TotalDir)
+		     float *FlowGrad, unsigned char *Dir, unsigned int *TotalDir)
 {
+  int c;
   int x;
   int y;
   int n;
+  int i;
+  float slope, aspect;
   float neighbor_elev[NNEIGHBORS];
 
   /* let's assume for now that WaterLevel is the SOILPIX map is
      computed elsewhere */
-  for (x = 0; x < Map->NX; x++) {
-    for (y = 0; y < Map->NY; y++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-		  float slope, aspect;
-		  for (n = 0; n < NNEIGHBORS; n++) {
-			  int xn = x + xneighbor[n];
-			  int yn = y + yneighbor[n];			  
-			  if (valid_cell(Map, xn, yn)) {
-				  neighbor_elev[n] =
-					  ((TopoMap[yn][xn].Mask) ? SoilMap[yn][xn].WaterLevel : (float) OUTSIDEBASIN);
-			  }
-			  else {
-				  neighbor_elev[n] = (float) OUTSIDEBASIN;
-			  }
-		  }
-		  slope_aspect(Map->DX, Map->DY, SoilMap[y][x].WaterLevel, neighbor_elev,
-		     &slope, &aspect);
-		  flow_fractions(Map->DX, Map->DY, slope, aspect, SoilMap[y][x].WaterLevel, neighbor_elev,
-		       &(FlowGrad[y][x]), Dir[y][x], &(TotalDir[y][x])); 
-      }
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    i = Map->BasinCell[c];
+    for (n = 0; n < NNEIGHBORS; n++) {
+        int xn = x + xneighbor[n];
+        int yn = y + yneighbor[n];			  
+        if (valid_cell(Map, xn, yn)) {
+            neighbor_elev[n] =
+                ((TopoMap[yn][xn].Mask) ? SoilMap[yn][xn].WaterLevel : (float) OUTSIDEBASIN);
+        }
+        else {
+            neighbor_elev[n] = (float) OUTSIDEBASIN;
+        }
     }
+    slope_aspect(Map->DX, Map->DY, SoilMap[y][x].WaterLevel, neighbor_elev,
+       &slope, &aspect);
+    flow_fractions(Map->DX, Map->DY, slope, aspect, SoilMap[y][x].WaterLevel, neighbor_elev,
+         &(FlowGrad[i]), &(Dir[i * NDIRS]), &(TotalDir[i])); 
   }
   return;
 }
@@ -422,39 +417,40 @@ SnowSlopeAspect
 This computes slope and aspect using the SnowSurface Elevation.
 ------------------------------------------------------------- */
 void SnowSlopeAspect(MAPSIZE *Map, TOPOPIX **TopoMap, SNOWPIX **Snow,
-  float **SubSnowGrad, unsigned char ***Dir, unsigned int **TotalDir)
+  float *SubSnowGrad, unsigned char *Dir, unsigned int *TotalDir)
 {
+  int c;
   int x;
   int y;
   int n;
+  int i;
+  float slope, aspect;
   float neighbor_elev[NNEIGHBORS];
 
-  for (x = 0; x < Map->NX; x++) {
-    for (y = 0; y < Map->NY; y++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-        float slope, aspect;
-        for (n = 0; n < NNEIGHBORS; n++) {
-          int xn = x + xneighbor[n];
-          int yn = y + yneighbor[n];
-          if (valid_cell(Map, xn, yn)) {
-            /* snow elevation (swq+dem) of neighboring cells */
-            neighbor_elev[n] =
-              ((TopoMap[yn][xn].Mask) ? (TopoMap[yn][xn].Dem + Snow[yn][xn].Swq) : (float)OUTSIDEBASIN);
-          }
-          else {
-            neighbor_elev[n] = (float)OUTSIDEBASIN;
-          }
-        }
-
-        slope_aspect(Map->DX, Map->DY, (TopoMap[y][x].Dem + Snow[y][x].Swq), neighbor_elev,
-          &slope, &aspect);
-        flow_fractions(Map->DX, Map->DY, slope, aspect, (TopoMap[y][x].Dem + Snow[y][x].Swq), neighbor_elev,
-          &(SubSnowGrad[y][x]), Dir[y][x], &(TotalDir[y][x]));
-
-        /* Reset SubSnowGrad to slope, don't want width in computation */
-        SubSnowGrad[y][x] = slope;
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    i = Map->BasinCell[c];
+    for (n = 0; n < NNEIGHBORS; n++) {
+      int xn = x + xneighbor[n];
+      int yn = y + yneighbor[n];
+      if (valid_cell(Map, xn, yn)) {
+        /* snow elevation (swq+dem) of neighboring cells */
+        neighbor_elev[n] =
+          ((TopoMap[yn][xn].Mask) ? (TopoMap[yn][xn].Dem + Snow[yn][xn].Swq) : (float)OUTSIDEBASIN);
+      }
+      else {
+        neighbor_elev[n] = (float)OUTSIDEBASIN;
       }
     }
+
+    slope_aspect(Map->DX, Map->DY, (TopoMap[y][x].Dem + Snow[y][x].Swq), neighbor_elev,
+      &slope, &aspect);
+    flow_fractions(Map->DX, Map->DY, slope, aspect, (TopoMap[y][x].Dem + Snow[y][x].Swq), neighbor_elev,
+      &(SubSnowGrad[i]), &(Dir[i * NDIRS]), &(TotalDir[i]));
+
+    /* Reset SubSnowGrad to slope, don't want width in computation */
+    SubSnowGrad[i] = slope;
   }
   return;
 }
@@ -37,6 +37,7 @@
 void SnowStats(DATE *Now, MAPSIZE *Map, OPTIONSTRUCT *Options, 
         TOPOPIX **TopoMap, SNOWPIX **Snow, int Dt)
 {
+  int c;
   int x;
   int y;
   int DNum; 
@@ -47,30 +48,28 @@ void SnowStats(DATE *Now, MAPSIZE *Map, OPTIONSTRUCT *Options,
   // printf("currnet month is %d \n", Now->Month);
   // printf("currnet day is %d \n", Now->Day);
   // printf("currnet DNum is %d \n", DNum);
-  for (y = 0; y < Map->NY; y++) {
-    for (x = 0; x < Map->NX; x++) {
-      if (INBASIN(TopoMap[y][x].Mask)) {
-           //printf("currnet SWE is %f \n", Snow[y][x].Swq);
-          // Update Peak SWE and Peak SWE date
-          if ( Snow[y][x].Swq > Snow[y][x].MaxSwe){
-            Snow[y][x].MaxSwe = Snow[y][x].Swq;
-            Snow[y][x].MaxSweDate = DNum; 
-            /* When the MaxSwe is updated, reset the melt out date to 0 so that it
-            overwrites previous in-corret dates*/
-            Snow[y][x].MeltOutDate = 0; 
-          }
+  for (c = 0; c < Map->NumCells; c++) {
+    y = Map->BasinCell[c] / Map->NX;
+    x = Map->BasinCell[c] % Map->NX;
+    //printf("currnet SWE is %f \n", Snow[y][x].Swq);
+    // Update Peak SWE and Peak SWE date
+    if ( Snow[y][x].Swq > Snow[y][x].MaxSwe){
+      Snow[y][x].MaxSwe = Snow[y][x].Swq;
+      Snow[y][x].MaxSweDate = DNum;
+      /* When the MaxSwe is updated, reset the melt out date to 0 so that it
+      overwrites previous in-corret dates*/
+      Snow[y][x].MeltOutDate = 0;
+    }
 
-          // Update Peak SWE Date
-          /* Criteria :
-            1. If snow < 5mm
-            2. First date past the peak SWE date
-            3. And Preceding 7/15 day has snow  //for now this was not implimented
-          */
-         if ((Snow[y][x].Swq < MIN_SWE) && (DNum > Snow[y][x].MaxSweDate) && (Snow[y][x].MeltOutDate == 0)){
-            Snow[y][x].MeltOutDate = DNum;    
-            if (DEBUG) printf("SWE Melt out date is %d \n", Snow[y][x].MeltOutDate);
-            }
-      }
+    // Update Peak SWE Date
+    /* Criteria :
+      1. If snow < 5mm
+      2. First date past the peak SWE date
+      3. And Preceding 7/15 day has snow  //for now this was not implimented
+    */
+    if ((Snow[y][x].Swq < MIN_SWE) && (DNum > Snow[y][x].MaxSweDate) && (Snow[y][x].MeltOutDate == 0)){
+      Snow[y][x].MeltOutDate = DNum;
+      if (DEBUG) printf("SWE Melt out date is %d \n", Snow[y][x].MeltOutDate);
     }
   }
 }
@@ -0,0 +1,420 @@
+/*
+ * SUMMARY:      StaticShare.c - Static inputs shared by the processes on a node
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Every process of an ensemble holds the same station
+ *               interpolation weights and terrain based met maps.
+ *               InitStaticShare() writes them once to a file (see
+ *               staticshare.h) and maps that file read-only, so that the
+ *               processes on a node that use the same file share one copy
+ *               in the page cache instead of holding one each.  Processes
+ *               that find a matching file do not calculate the weights.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitStaticShare()
+ * COMMENTS:     Put the file on a memory file system such as /dev/shm.  The
+ *               maps must not change after initialization, which excludes
+ *               the terrain map (its flow directions are set for every run)
+ *               and the monthly shadow and PRISM maps.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+#include "constants.h"
+#include "staticshare.h"
+
+static unsigned long long HashBytes(unsigned long long Hash, const void *Data,
+				    size_t Size);
+static size_t BlockSize(STATICSHAREHEADER *Header, int Block);
+static char *MapStaticShare(char *FileName, STATICSHAREHEADER *Header);
+static void WriteStaticShare(char *FileName, STATICSHAREHEADER *Header,
+			     METWEIGHTS *MetWeights, float **SkyViewMap,
+			     float **PrecipLapseMap, float **PptMultiplierMap,
+			     float ***WindModel);
+static void WriteMap(FILE *OutFile, char *FileName, float **Map, int NY,
+		     int NX);
+static void PadBlock(FILE *OutFile, char *FileName, size_t Size);
+static void PointRows(float **Map, float *Data, int NY, int NX);
+
+/*****************************************************************************
+  Function name: InitStaticShare()
+
+  Purpose      : Calculate the interpolation weights, or take them from the
+                 shared static file, and point the weights and the static
+                 met maps into the shared file
+
+  Required     :
+    char *FileName          - Shared static file
+    MAPSIZE *Map            - Model area
+    OPTIONSTRUCT *Options   - Model options
+    TOPOPIX **TopoMap       - Terrain, for the basin mask
+    METWEIGHTS *MetWeights  - Interpolation weights, empty on entry
+    METLOCATION *Stat       - Met stations
+    int NStats              - Number of met stations
+    GRID *Grid              - Grid of gridded met input
+    float **SkyViewMap      - Sky view map, or NULL
+    float **PrecipLapseMap  - Precipitation lapse map, or NULL
+    float **PptMultiplierMap - Precipitation multiplier map, or NULL
+    float ***WindModel      - Wind model maps, or NULL
+
+  Returns      : void
+
+  Modifies     : MetWeights and the rows of the maps, which afterwards point
+                 into the read-only mapping of the file
+
+  Comments     : Replaces InitInterpolationWeights().  The maps are read by
+                 every process, and the file is only used if its key, a hash
+                 of the maps, the basin mask, the station locations and the
+                 interpolation options, matches.  Otherwise it is written
+                 again.  A lock on <FileName>.lock makes the other processes
+                 wait while one of them writes the file.
+*****************************************************************************/
+void InitStaticShare(char *FileName, MAPSIZE *Map, OPTIONSTRUCT *Options,
+		     TOPOPIX **TopoMap, METWEIGHTS *MetWeights,
+		     METLOCATION *Stat, int NStats, GRID *Grid,
+		     float **SkyViewMap,
+		     float **PrecipLapseMap, float **PptMultiplierMap,
+		     float ***WindModel)
+{
+  char LockName[BUFSIZE + 1];
+  STATICSHAREHEADER Header;
+  unsigned long long Key;
+  char *Share;
+  char *Block;
+  int LockFile;
+  int i;
+  int n;
+  int x;
+  int y;
+
+  memset(&Header, 0, sizeof(STATICSHAREHEADER));
+  memcpy(Header.Magic, STATICSHARE_MAGIC, sizeof(Header.Magic));
+  Header.NY = Map->NY;
+  Header.NX = Map->NX;
+  Header.NStats = NStats;
+
+  /* with MM5 input there are no weights, and the precipitation lapse map
+     is read again at every time step */
+  if (Options->MM5 == TRUE && Options->QPF == FALSE)
+    InitInterpolationWeights(Map, Options, TopoMap, MetWeights, Stat, NStats,
+			     Grid);
+  else
+    Header.Blocks |= ss_weights;
+  if (SkyViewMap != NULL)
+    Header.Blocks |= ss_skyview;
+  if (PrecipLapseMap != NULL && Options->MM5 == FALSE)
+    Header.Blocks |= ss_preciplapse;
+  if (PptMultiplierMap != NULL)
+    Header.Blocks |= ss_pptmultiplier;
+  if (WindModel != NULL) {
+    Header.Blocks |= ss_windmodel;
+    Header.NWindMaps = NWINDMAPS;
+  }
+
+  if ((Header.Blocks & ss_weights) && Options->GRIDMET)
+    for (i = 0; i < NStats; i++)
+      Stat[i].Elev = TopoMap[Stat[i].Loc.N][Stat[i].Loc.E].Dem;
+
+  Key = HashBytes(0xcbf29ce484222325ULL, &(Header.NY),
+		  5 * sizeof(int));
+  if (Header.Blocks & ss_weights) {
+    Key = HashBytes(Key, &(Options->Interpolation), sizeof(int));
+    Key = HashBytes(Key, &(Options->CressRadius), sizeof(int));
+    Key = HashBytes(Key, &(Options->CressStations), sizeof(int));
+    for (i = 0; i < NStats; i++)
+      Key = HashBytes(Key, &(Stat[i].Loc), sizeof(COORD));
+    if (Grid->Node != NULL) {
+      Key = HashBytes(Key, &(Grid->NLat), sizeof(int));
+      Key = HashBytes(Key, &(Grid->NLon), sizeof(int));
+      Key = HashBytes(Key, &(Grid->Lat0), sizeof(float));
+      Key = HashBytes(Key, &(Grid->Lon0), sizeof(float));
+      Key = HashBytes(Key, &(Grid->DLat), sizeof(float));
+      Key = HashBytes(Key, &(Grid->DLon), sizeof(float));
+      Key = HashBytes(Key, Grid->Node,
+		      (size_t) Grid->NLat * Grid->NLon * sizeof(int));
+    }
+    for (y = 0; y < Map->NY; y++)
+      for (x = 0; x < Map->NX; x++)
+	Key = HashBytes(Key, &(TopoMap[y][x].Mask), sizeof(uchar));
+  }
+  for (y = 0; y < Map->NY; y++) {
+    if (Header.Blocks & ss_skyview)
+      Key = HashBytes(Key, SkyViewMap[y], Map->NX * sizeof(float));
+    if (Header.Blocks & ss_preciplapse)
+      Key = HashBytes(Key, PrecipLapseMap[y], Map->NX * sizeof(float));
+    if (Header.Blocks & ss_pptmultiplier)
+      Key = HashBytes(Key, PptMultiplierMap[y], Map->NX * sizeof(float));
+    if (Header.Blocks & ss_windmodel)
+      for (n = 0; n < Header.NWindMaps; n++)
+	Key = HashBytes(Key, WindModel[n][y], Map->NX * sizeof(float));
+  }
+  Header.Key = Key;
+
+  if (snprintf(LockName, sizeof(LockName), "%s.lock", FileName) >=
+      (int) sizeof(LockName))
+    ReportError(FileName, 3);
+  if ((LockFile = open(LockName, O_RDWR | O_CREAT, 0666)) == -1)
+    ReportError(LockName, 3);
+  if (flock(LockFile, LOCK_EX) == -1)
+    ReportError(LockName, 3);
+
+  if ((Share = MapStaticShare(FileName, &Header)) != NULL)
+    printf("Attaching shared static inputs %s\n", FileName);
+  else {
+    printf("Writing shared static inputs %s\n", FileName);
+    if (Header.Blocks & ss_weights) {
+      InitInterpolationWeights(Map, Options, TopoMap, MetWeights, Stat,
+			       NStats, Grid);
+      Header.NWeights = MetWeights->NWeights;
+    }
+    WriteStaticShare(FileName, &Header, MetWeights, SkyViewMap,
+		     PrecipLapseMap, PptMultiplierMap, WindModel);
+    if ((Share = MapStaticShare(FileName, &Header)) == NULL)
+      ReportError(FileName, 5);
+  }
+
+  flock(LockFile, LOCK_UN);
+  close(LockFile);
+
+  /* release the private copies and point them into the mapping, which is
+     kept for the life of the process */
+  Block = Share + STATICSHARE_ALIGN;
+  if (Header.Blocks & ss_weights) {
+    free(MetWeights->Start);
+    free(MetWeights->Weight);
+    MetWeights->NY = Map->NY;
+    MetWeights->NX = Map->NX;
+    MetWeights->NWeights = (size_t) Header.NWeights;
+    MetWeights->Start = (size_t *) Block;
+    MetWeights->Weight = (METWEIGHT *) (Block + ((size_t) Map->NY * Map->NX +
+						 1) * sizeof(size_t));
+    Block += BlockSize(&Header, ss_weights);
+  }
+  if (Header.Blocks & ss_skyview) {
+    PointRows(SkyViewMap, (float *) Block, Map->NY, Map->NX);
+    Block += BlockSize(&Header, ss_skyview);
+  }
+  if (Header.Blocks & ss_preciplapse) {
+    PointRows(PrecipLapseMap, (float *) Block, Map->NY, Map->NX);
+    Block += BlockSize(&Header, ss_preciplapse);
+  }
+  if (Header.Blocks & ss_pptmultiplier) {
+    PointRows(PptMultiplierMap, (float *) Block, Map->NY, Map->NX);
+    Block += BlockSize(&Header, ss_pptmultiplier);
+  }
+  if (Header.Blocks & ss_windmodel) {
+    for (n = 0; n < Header.NWindMaps; n++)
+      PointRows(WindModel[n], (float *) Block + (size_t) n * Map->NY * Map->NX,
+		Map->NY, Map->NX);
+  }
+}
+
+/*****************************************************************************
+  HashBytes()
+
+  FNV-1a hash of Size bytes, continuing from Hash
+*****************************************************************************/
+static unsigned long long HashBytes(unsigned long long Hash, const void *Data,
+				    size_t Size)
+{
+  const unsigned char *Byte = (const unsigned char *) Data;
+  size_t i;
+
+  for (i = 0; i < Size; i++) {
+    Hash ^= Byte[i];
+    Hash *= 0x100000001b3ULL;
+  }
+  return Hash;
+}
+
+/*****************************************************************************
+  BlockSize()
+
+  Size of a block in the file, including the padding to STATICSHARE_ALIGN.
+  Zero if the block is not in the file.
+*****************************************************************************/
+static size_t BlockSize(STATICSHAREHEADER *Header, int Block)
+{
+  size_t Size;
+
+  if (!(Header->Blocks & Block))
+    return 0;
+
+  Size = (size_t) Header->NY * Header->NX;
+  if (Block == ss_weights)
+    Size = (Size + 1) * sizeof(size_t) +
+      (size_t) Header->NWeights * sizeof(METWEIGHT);
+  else if (Block == ss_windmodel)
+    Size *= Header->NWindMaps * sizeof(float);
+  else
+    Size *= sizeof(float);
+
+  return (Size + STATICSHARE_ALIGN - 1) / STATICSHARE_ALIGN *
+    STATICSHARE_ALIGN;
+}
+
+/*****************************************************************************
+  MapStaticShare()
+
+  Map the file read-only if it exists and its header matches Header.
+  Returns the mapping, or NULL otherwise.  The number of weights is not
+  known before they are calculated, so it is taken from the file.
+*****************************************************************************/
+static char *MapStaticShare(char *FileName, STATICSHAREHEADER *Header)
+{
+  STATICSHAREHEADER FileHeader;
+  struct stat FileStat;
+  size_t Size;
+  char *Map;
+  int Block;
+  int fd;
+
+  if ((fd = open(FileName, O_RDONLY)) == -1)
+    return NULL;
+  if (read(fd, &FileHeader, sizeof(STATICSHAREHEADER)) !=
+      sizeof(STATICSHAREHEADER)) {
+    close(fd);
+    return NULL;
+  }
+  Header->NWeights = FileHeader.NWeights;
+
+  Size = STATICSHARE_ALIGN;
+  for (Block = ss_weights; Block <= ss_windmodel; Block <<= 1)
+    Size += BlockSize(Header, Block);
+
+  if (fstat(fd, &FileStat) == -1 || FileStat.st_size != (off_t) Size) {
+    close(fd);
+    return NULL;
+  }
+
+  Map = (char *) mmap(NULL, Size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (Map == (char *) MAP_FAILED)
+    return NULL;
+
+  if (memcmp(Map, Header, sizeof(STATICSHAREHEADER)) != 0) {
+    munmap(Map, Size);
+    return NULL;
+  }
+
+#ifdef MADV_HUGEPAGE
+  /* a hint only, honoured on memory file systems that allow huge pages */
+  madvise(Map, Size, MADV_HUGEPAGE);
+#endif
+
+  return Map;
+}
+
+/*****************************************************************************
+  WriteStaticShare()
+
+  Write the file under a temporary name and rename it
+*****************************************************************************/
+static void WriteStaticShare(char *FileName, STATICSHAREHEADER *Header,
+			     METWEIGHTS *MetWeights, float **SkyViewMap,
+			     float **PrecipLapseMap, float **PptMultiplierMap,
+			     float ***WindModel)
+{
+  char TempName[BUFSIZE + 1];
+  FILE *OutFile;
+  size_t Size;
+  int n;
+  int y;
+
+  if (snprintf(TempName, sizeof(TempName), "%s.%d", FileName,
+	       (int) getpid()) >= (int) sizeof(TempName))
+    ReportError(FileName, 3);
+  if (!(OutFile = fopen(TempName, "wb")))
+    ReportError(TempName, 3);
+
+  if (fwrite(Header, sizeof(STATICSHAREHEADER), 1, OutFile) != 1)
+    ReportError(TempName, 41);
+  PadBlock(OutFile, TempName, sizeof(STATICSHAREHEADER));
+
+  if (Header->Blocks & ss_weights) {
+    Size = (size_t) Header->NY * Header->NX + 1;
+    if (fwrite(MetWeights->Start, sizeof(size_t), Size, OutFile) != Size)
+      ReportError(TempName, 41);
+    if (Header->NWeights > 0 &&
+	fwrite(MetWeights->Weight, sizeof(METWEIGHT), Header->NWeights,
+	       OutFile) != Header->NWeights)
+      ReportError(TempName, 41);
+    PadBlock(OutFile, TempName, Size * sizeof(size_t) +
+	     (size_t) Header->NWeights * sizeof(METWEIGHT));
+  }
+  if (Header->Blocks & ss_skyview)
+    WriteMap(OutFile, TempName, SkyViewMap, Header->NY, Header->NX);
+  if (Header->Blocks & ss_preciplapse)
+    WriteMap(OutFile, TempName, PrecipLapseMap, Header->NY, Header->NX);
+  if (Header->Blocks & ss_pptmultiplier)
+    WriteMap(OutFile, TempName, PptMultiplierMap, Header->NY, Header->NX);
+  if (Header->Blocks & ss_windmodel) {
+    for (n = 0; n < Header->NWindMaps; n++)
+      for (y = 0; y < Header->NY; y++)
+	if (fwrite(WindModel[n][y], sizeof(float), Header->NX, OutFile) !=
+	    (size_t) Header->NX)
+	  ReportError(TempName, 41);
+    PadBlock(OutFile, TempName, (size_t) Header->NWindMaps * Header->NY *
+	     Header->NX * sizeof(float));
+  }
+
+  if (fclose(OutFile) != 0)
+    ReportError(TempName, 41);
+  if (rename(TempName, FileName) != 0)
+    ReportError(FileName, 41);
+}
+
+/*****************************************************************************
+  WriteMap()
+
+  Write a map row by row as one block
+*****************************************************************************/
+static void WriteMap(FILE *OutFile, char *FileName, float **Map, int NY,
+		     int NX)
+{
+  int y;
+
+  for (y = 0; y < NY; y++)
+    if (fwrite(Map[y], sizeof(float), NX, OutFile) != (size_t) NX)
+      ReportError(FileName, 41);
+  PadBlock(OutFile, FileName, (size_t) NY * NX * sizeof(float));
+}
+
+/*****************************************************************************
+  PadBlock()
+
+  Pad a block of Size bytes with zeros to a multiple of STATICSHARE_ALIGN
+*****************************************************************************/
+static void PadBlock(FILE *OutFile, char *FileName, size_t Size)
+{
+  for (; Size % STATICSHARE_ALIGN != 0; Size++)
+    if (fputc(0, OutFile) == EOF)
+      ReportError(FileName, 41);
+}
+
+/*****************************************************************************
+  PointRows()
+
+  Free the rows of a map and point them to the rows of Data
+*****************************************************************************/
+static void PointRows(float **Map, float *Data, int NY, int NX)
+{
+  int y;
+
+  for (y = 0; y < NY; y++) {
+    free(Map[y]);
+    Map[y] = Data + (size_t) y * NX;
+  }
+}
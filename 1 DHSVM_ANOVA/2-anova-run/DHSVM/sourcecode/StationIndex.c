@@ -0,0 +1,254 @@
+/*
+ * SUMMARY:      StationIndex.c - Nearest met stations of a pixel
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  The NEAREST and VARCRESS interpolation only use the closest
+ *               stations of a pixel.  InitStationIndex() sorts the stations
+ *               into a grid of buckets (see stationindex.h), and
+ *               FindNearestStations() searches the buckets in rings around
+ *               the pixel until no station outside the rings can be closer,
+ *               instead of measuring the distance to every station.
+ * DESCRIP-END.
+ * FUNCTIONS:    InitStationIndex()
+ *               FindNearestStations()
+ *               FreeStationIndex()
+ * COMMENTS:     The buckets hold about one station each, so a search visits
+ *               a few buckets when the stations are spread evenly, as with
+ *               gridded met input.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include "settings.h"
+#include "data.h"
+#include "DHSVMerror.h"
+#include "functions.h"
+#include "stationindex.h"
+
+static int FloorDiv(int a, int b);
+static int CompareDistance(const void *A, const void *B);
+
+/*****************************************************************************
+  Function name: InitStationIndex()
+
+  Purpose      : Sort the stations into buckets
+
+  Required     :
+    METLOCATION *Station - Met stations
+    int NStats           - Number of met stations, at least one
+    STATIONINDEX *Index  - Index to fill
+
+  Returns      : void
+
+  Modifies     : *Index
+
+  Comments     : The bucket size is chosen so that there are about as many
+                 buckets as stations over the area that the stations span.
+                 The stations can be outside the model area.
+*****************************************************************************/
+void InitStationIndex(METLOCATION *Station, int NStats, STATIONINDEX *Index)
+{
+  const char *Routine = "InitStationIndex";
+  double Area;
+  int *Bucket;			/* Bucket of each station */
+  int MaxN;
+  int MaxE;
+  int b;
+  int i;
+
+  Index->MinN = Index->MinE = INT_MAX;
+  MaxN = MaxE = INT_MIN;
+  for (i = 0; i < NStats; i++) {
+    if (Station[i].Loc.N < Index->MinN)
+      Index->MinN = Station[i].Loc.N;
+    if (Station[i].Loc.N > MaxN)
+      MaxN = Station[i].Loc.N;
+    if (Station[i].Loc.E < Index->MinE)
+      Index->MinE = Station[i].Loc.E;
+    if (Station[i].Loc.E > MaxE)
+      MaxE = Station[i].Loc.E;
+  }
+
+  Area = ((double) MaxN - Index->MinN + 1) * ((double) MaxE - Index->MinE + 1);
+  Index->Size = (int) ceil(sqrt(Area / NStats));
+  if (Index->Size < 1)
+    Index->Size = 1;
+  Index->NBN = (MaxN - Index->MinN) / Index->Size + 1;
+  Index->NBE = (MaxE - Index->MinE) / Index->Size + 1;
+
+  if (!(Index->Start = (int *) calloc(Index->NBN * Index->NBE + 1,
+				      sizeof(int))))
+    ReportError((char *) Routine, 1);
+  if (!(Index->Station = (int *) calloc(NStats, sizeof(int))))
+    ReportError((char *) Routine, 1);
+  if (!(Bucket = (int *) calloc(NStats, sizeof(int))))
+    ReportError((char *) Routine, 1);
+
+  /* count the stations per bucket, then place them in station order */
+  for (i = 0; i < NStats; i++) {
+    Bucket[i] = ((Station[i].Loc.N - Index->MinN) / Index->Size) * Index->NBE +
+      (Station[i].Loc.E - Index->MinE) / Index->Size;
+    Index->Start[Bucket[i] + 1]++;
+  }
+  for (b = 0; b < Index->NBN * Index->NBE; b++)
+    Index->Start[b + 1] += Index->Start[b];
+  for (i = 0; i < NStats; i++)
+    Index->Station[Index->Start[Bucket[i]]++] = i;
+  for (b = Index->NBN * Index->NBE; b > 0; b--)
+    Index->Start[b] = Index->Start[b - 1];
+  Index->Start[0] = 0;
+
+  free(Bucket);
+}
+
+/*****************************************************************************
+  Function name: FindNearestStations()
+
+  Purpose      : Find the K stations closest to a location, and all the
+                 stations as close as the Kth one
+
+  Required     :
+    STATIONINDEX *Index       - Station index
+    METLOCATION *Station      - Met stations
+    COORD *Loc                - Location
+    int K                     - Number of stations wanted, at least one
+    STATIONDISTANCE *Nearest  - Room for all the stations
+
+  Returns      : int - Number of stations in Nearest, K or more unless there
+                 are fewer stations
+
+  Modifies     : Nearest, sorted by distance and then by station
+
+  Comments     : The distances are those of CalcDistance().  The stations that
+                 tie with the Kth one are all included, so that the caller
+                 can break ties the way it needs to.
+*****************************************************************************/
+int FindNearestStations(STATIONINDEX *Index, METLOCATION *Station,
+			COORD *Loc, int K, STATIONDISTANCE *Nearest)
+{
+  double Bound;			/* Distance within which all stations are found */
+  int Count;			/* Number of stations found */
+  int Done;
+  int Gap;
+  int Step;
+  int bn;			/* Bucket row of the location */
+  int be;			/* Bucket column of the location */
+  int b;
+  int i;
+  int j;
+  int r;			/* Ring of buckets around the location */
+  int s;
+
+  bn = FloorDiv(Loc->N - Index->MinN, Index->Size);
+  be = FloorDiv(Loc->E - Index->MinE, Index->Size);
+
+  Count = 0;
+  for (r = 0;; r++) {
+
+    /* the buckets on ring r: whole rows at the top and bottom, and the first
+       and last column in between */
+    for (i = bn - r; i <= bn + r; i++) {
+      if (i < 0 || i >= Index->NBN)
+	continue;
+      Step = (i == bn - r || i == bn + r) ? 1 : 2 * r;
+      for (j = be - r; j <= be + r; j += Step) {
+	if (j < 0 || j >= Index->NBE)
+	  continue;
+	b = i * Index->NBE + j;
+	for (s = Index->Start[b]; s < Index->Start[b + 1]; s++) {
+	  Nearest[Count].Station = Index->Station[s];
+	  Nearest[Count].Distance =
+	    CalcDistance(&(Station[Index->Station[s]].Loc), Loc);
+	  Count++;
+	}
+      }
+    }
+
+    /* stations in buckets outside the rings are at least Bound away */
+    Bound = DHSVM_HUGE;
+    Done = TRUE;
+    if (bn - r > 0) {
+      Done = FALSE;
+      Gap = Loc->N - (Index->MinN + (bn - r) * Index->Size) + 1;
+      if (Gap < Bound)
+	Bound = Gap;
+    }
+    if (bn + r < Index->NBN - 1) {
+      Done = FALSE;
+      Gap = Index->MinN + (bn + r + 1) * Index->Size - Loc->N;
+      if (Gap < Bound)
+	Bound = Gap;
+    }
+    if (be - r > 0) {
+      Done = FALSE;
+      Gap = Loc->E - (Index->MinE + (be - r) * Index->Size) + 1;
+      if (Gap < Bound)
+	Bound = Gap;
+    }
+    if (be + r < Index->NBE - 1) {
+      Done = FALSE;
+      Gap = Index->MinE + (be + r + 1) * Index->Size - Loc->E;
+      if (Gap < Bound)
+	Bound = Gap;
+    }
+    if (Done)
+      break;
+
+    if (Count >= K) {
+      qsort(Nearest, Count, sizeof(STATIONDISTANCE), CompareDistance);
+      if (Bound > Nearest[K - 1].Distance)
+	break;
+    }
+  }
+
+  qsort(Nearest, Count, sizeof(STATIONDISTANCE), CompareDistance);
+  while (Count > K && Nearest[Count - 1].Distance > Nearest[K - 1].Distance)
+    Count--;
+
+  return Count;
+}
+
+/*****************************************************************************
+  Function name: FreeStationIndex()
+*****************************************************************************/
+void FreeStationIndex(STATIONINDEX *Index)
+{
+  free(Index->Start);
+  free(Index->Station);
+  Index->Start = NULL;
+  Index->Station = NULL;
+}
+
+/*****************************************************************************
+  FloorDiv()
+
+  Integer division rounded down, also for negative a
+*****************************************************************************/
+static int FloorDiv(int a, int b)
+{
+  if (a >= 0)
+    return a / b;
+  return -((-a + b - 1) / b);
+}
+
+/*****************************************************************************
+  CompareDistance()
+
+  Compare two STATIONDISTANCE elements for qsort, by distance and then by
+  station
+*****************************************************************************/
+static int CompareDistance(const void *A, const void *B)
+{
+  const STATIONDISTANCE *a = (const STATIONDISTANCE *) A;
+  const STATIONDISTANCE *b = (const STATIONDISTANCE *) B;
+
+  if (a->Distance < b->Distance)
+    return -1;
+  if (a->Distance > b->Distance)
+    return 1;
+  return a->Station - b->Station;
+}
@@ -472,8 +472,11 @@ void StoreModelState(char *Path, DATE * Current, MAPSIZE * Map,
   if (Options->Extent == BASIN && Options->HasNetwork == FALSE) {
     sprintf(FileName, "%sHydrograph.State.%s", Path, Str);
     OpenFile(&HydroStateFile, FileName, "w", FALSE);
+    /* one value per second, the bin of each time step at its first second */
     for (i = 0; i < HydrographInfo->TotalWaveLength; i++)
-      fprintf(HydroStateFile, "%f\n", Hydrograph[i]);
+      fprintf(HydroStateFile, "%f\n", (i % HydrographInfo->Dt) ? 0.0 :
+	      Hydrograph[(HydrographInfo->Head + i / HydrographInfo->Dt) %
+			 HydrographInfo->NBins]);
     fclose(HydroStateFile);
   }
 }
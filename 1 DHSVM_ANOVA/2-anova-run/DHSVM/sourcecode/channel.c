@@ -519,34 +519,117 @@ static int channel_route_segment(Channel * segment, int deltat)
   segment->outflow = outflow * deltat;
   segment->storage = storage;
 
-  if (segment->outlet != NULL)
-    segment->outlet->inflow += segment->outflow;
-
   return (err);
 }
 
+/* -------------------------------------------------------------
+channel_order_network
+Compiles the network for routing.  The segments are sorted by
+order; within an order they keep their place in the list, so the
+inflows of an outlet are summed in the same sequence as a scan of
+the list order by order.  As in that scan, the routed orders stop
+at the first order without segments.
+------------------------------------------------------------- */
+ChannelRoute *channel_order_network(Channel *net)
+{
+  ChannelRoute *route;
+  Channel *current;
+  int *count;			/* segments of each order */
+  int *first;			/* position of the next segment of each order */
+  int *index;			/* position in seg of each segment id */
+  unsigned maxorder = 0;
+  unsigned last;		/* last order that is routed */
+  unsigned order;
+  int maxid = 0;
+  int i;
+
+  if ((route = (ChannelRoute *) malloc(sizeof(ChannelRoute))) == NULL) {
+    error_handler(ERRHDL_ERROR, "channel_order_network: malloc failed: %s",
+      strerror(errno));
+    return NULL;
+  }
+  route->nseg = 0;
+  for (current = net; current != NULL; current = current->next) {
+    route->nseg++;
+    if (current->order > maxorder)
+      maxorder = current->order;
+    if (current->id > maxid)
+      maxid = current->id;
+  }
+
+  count = (int *) calloc(maxorder + 2, sizeof(int));
+  first = (int *) calloc(maxorder + 2, sizeof(int));
+  index = (int *) calloc(maxid + 1, sizeof(int));
+  route->seg = (Channel **) malloc((route->nseg + 1) * sizeof(Channel *));
+  route->outlet = (int *) malloc((route->nseg + 1) * sizeof(int));
+  if (count == NULL || first == NULL || index == NULL ||
+      route->seg == NULL || route->outlet == NULL) {
+    error_handler(ERRHDL_ERROR, "channel_order_network: malloc failed: %s",
+      strerror(errno));
+    return NULL;
+  }
+
+  for (current = net; current != NULL; current = current->next)
+    count[current->order]++;
+  for (last = 0; last < maxorder && count[last + 1] > 0; last++)
+    ;
+
+  /* orders 1 to last first, then the segments that are not routed */
+  route->nroute = 0;
+  for (order = 1; order <= last; order++) {
+    first[order] = route->nroute;
+    route->nroute += count[order];
+  }
+  i = route->nroute;
+  for (current = net; current != NULL; current = current->next) {
+    order = current->order;
+    if (order >= 1 && order <= last)
+      route->seg[first[order]++] = current;
+    else
+      route->seg[i++] = current;
+  }
+
+  for (i = 0; i < route->nseg; i++)
+    index[route->seg[i]->id] = i;
+  for (i = 0; i < route->nseg; i++) {
+    current = route->seg[i]->outlet;
+    route->outlet[i] = (current != NULL) ? index[current->id] : -1;
+  }
+
+  error_handler(ERRHDL_DEBUG,
+    "channel_order_network: %d segments, %d routed in %u orders",
+    route->nseg, route->nroute, last);
+
+  free(count);
+  free(first);
+  free(index);
+  return route;
+}
+
+/* -------------------------------------------------------------
+channel_free_order
+------------------------------------------------------------- */
+void channel_free_order(ChannelRoute *route)
+{
+  free(route->seg);
+  free(route->outlet);
+  free(route);
+}
+
 /* -------------------------------------------------------------
 channel_route_network
 ------------------------------------------------------------- */
-int channel_route_network(Channel * net, int deltat)
+int channel_route_network(ChannelRoute *route, int deltat)
 {
-  int order;
-  int order_count;
+  int i;
   int err = 0;
-  Channel *current;
+  Channel *segment;
 
-  for (order = 1;; order += 1) {
-    order_count = 0;
-    current = net;
-    while (current != NULL) {
-      if (current->order == order) {
-        err += channel_route_segment(current, deltat);
-        order_count += 1;
-      }
-      current = current->next;
-    }
-    if (order_count == 0)
-      break;
+  for (i = 0; i < route->nroute; i++) {
+    segment = route->seg[i];
+    err += channel_route_segment(segment, deltat);
+    if (route->outlet[i] >= 0)
+      route->seg[route->outlet[i]]->inflow += segment->outflow;
   }
   return (err);
 }
@@ -554,9 +637,13 @@ int channel_route_network(Channel * net, int deltat)
 /* -------------------------------------------------------------
 channel_step_initialize_network
 ------------------------------------------------------------- */
-int channel_step_initialize_network(Channel *net)
+int channel_step_initialize_network(ChannelRoute *route)
 {
-  if (net != NULL) {
+  int i;
+  Channel *net;
+
+  for (i = 0; i < route->nseg; i++) {
+    net = route->seg[i];
     net->last_inflow = net->inflow;
     net->inflow = 0.0;
     net->lateral_inflow = 0.0;
@@ -578,8 +665,6 @@ int channel_step_initialize_network(Channel *net)
     net->azimuth = 0;
     net->skyview = 0;
     //net->Ncells = 0; /* not used for now */
-
-    channel_step_initialize_network(net->next);
   }
   return (0);
 }
@@ -592,17 +677,20 @@ int channel_save_outflow(double time, Channel * net, FILE * out, FILE * out2)
 {
   char buffer[16];
   sprintf(buffer, "%12.5g", time);
-  return (channel_save_outflow_text(buffer, net, out, out2, 0));
+  return (channel_save_outflow_text(buffer, net, out, out2, NULL, 0));
 }
 
 /* -------------------------------------------------------------
 channel_save_outflow_wtext
-Saves the channel outflow using a text string as the time field
+Saves the channel outflow using a text string as the time field.
+If store is not NULL, the outflow of each recorded segment is
+also copied into it, in network order.
 ------------------------------------------------------------- */
 int
   channel_save_outflow_text(char *tstring, Channel * net, FILE * out,
-  FILE * out2, int flag)
+  FILE * out2, float *store, int flag)
 {
+  Channel *seg;
   int err = 0;
   float total_outflow = 0.0;
   float total_lateral_inflow = 0.0;
@@ -610,6 +698,13 @@ int
   float total_storage_change = 0.0;
   float total_error = 0.0;
 
+  if (store != NULL) {
+    for (seg = net; seg != NULL; seg = seg->next) {
+      if (seg->record)
+        *store++ = seg->outflow;
+    }
+  }
+
   if (flag == 1) {
     fprintf(out2, "DATE ");
     for (; net != NULL; net = net->next) {
@@ -689,10 +784,14 @@ channel_free_network
 ------------------------------------------------------------- */
 void channel_free_network(Channel * net)
 {
-  if (net->next != NULL) {
-    channel_free_network(net->next);
+  Channel *next;
+
+  for (; net != NULL; net = next) {
+    next = net->next;
+    if (net->record_name != NULL)
+      free(net->record_name);
+    free(net);
   }
-  free(net);
 }
 
 /* -------------------------------------------------------------
@@ -99,6 +99,20 @@ struct _channel_rec_ {
 };
 typedef struct _channel_rec_ Channel, *ChannelPtr;
 
+/* -------------------------------------------------------------
+   struct ChannelRoute
+   The network compiled for routing: all segments in one array,
+   sorted by order, with the outlets as indices into that array.
+   Only the first nroute segments are routed, the others have an
+   order that is not reached (zero or after a missing order).
+   ------------------------------------------------------------- */
+typedef struct {
+  int nseg;			/* number of segments in the network */
+  int nroute;			/* number of segments that are routed */
+  Channel **seg;		/* segments in routing order */
+  int *outlet;			/* index of the outlet in seg, -1 if none */
+} ChannelRoute;
+
 /* -------------------------------------------------------------
    externally available routines
    ------------------------------------------------------------- */
@@ -112,12 +126,14 @@ Channel *channel_read_network(const char *file, ChannelClass * class_list, int *
 int channel_read_rveg_param(Channel *net, const char *file, int *MaxID);
 void channel_routing_parameters(Channel *net, int deltat);
 Channel *channel_find_segment(Channel *net, SegmentID id);
-int channel_step_initialize_network(Channel *net);
+ChannelRoute *channel_order_network(Channel *net);
+void channel_free_order(ChannelRoute *route);
+int channel_step_initialize_network(ChannelRoute *route);
 int channel_incr_lat_inflow(Channel *segment, float linflow);
-int channel_route_network(Channel *net, int deltat);
+int channel_route_network(ChannelRoute *route, int deltat);
 int channel_save_outflow(double time, Channel * net, FILE *file, FILE *file2);
 int channel_save_outflow_text(char *tstring, Channel *net, FILE *out,
-			      FILE *out2, int flag);
+			      FILE *out2, float *store, int flag);
 void channel_free_network(Channel *net);
 
 /* Module */
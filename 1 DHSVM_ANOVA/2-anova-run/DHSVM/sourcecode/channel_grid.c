@@ -175,7 +175,7 @@ void channel_grid_free_map(ChannelMapPtr ** map)
    channel_grid_read_map
    ------------------------------------------------------------- */
 ChannelMapPtr **channel_grid_read_map(Channel *net, const char *file,
-				      SOILPIX ** SoilMap)
+				      MAPSIZE *Map, SOILCELLS *SoilCells)
 {
   ChannelMapPtr **map;
   static const int fields = 8;
@@ -215,6 +215,7 @@ ChannelMapPtr **channel_grid_read_map(Channel *net, const char *file,
   while (!done) {
     int i;
     int row = 0, col = 0;
+    int basin_cell;
     int rec_err = 0;
     ChannelMapPtr cell;
 
@@ -295,12 +296,14 @@ ChannelMapPtr **channel_grid_read_map(Channel *net, const char *file,
 	  break;
 	case 4:
 	  cell->cut_height = map_fields[i].value.real;
-	  if (cell->cut_height > SoilMap[row][col].Depth) {
+	  /* the soil depth is only kept for cells inside the basin */
+	  basin_cell = Map->BasinIndex[row * Map->NX + col];
+	  if (basin_cell >= 0 &&
+	      cell->cut_height > SoilCells->Depth[basin_cell]) {
 	    printf("warning overriding cut depths with 0.95 soil depth \n");
-	    cell->cut_height = SoilMap[row][col].Depth*0.95;
+	    cell->cut_height = SoilCells->Depth[basin_cell]*0.95;
 	  }
-	  if (cell->cut_height < 0.0
-	      || cell->cut_height > SoilMap[row][col].Depth) {
+	  if (cell->cut_height < 0.0) {
 	    error_handler(ERRHDL_ERROR, "%s, line %d: bad cut_depth", file,
 			  table_lineno());
 	    err++;
@@ -353,6 +356,69 @@ ChannelMapPtr **channel_grid_read_map(Channel *net, const char *file,
   return (map);
 }
 
+/* -------------------------------------------------------------
+   channel_grid_compile
+   Builds the compiled lookup of a channel map.  The cell totals
+   are computed with the query functions of the map, so the lookup
+   returns the same values.
+   ------------------------------------------------------------- */
+ChannelLookup *channel_grid_compile(ChannelMapPtr ** map)
+{
+  ChannelLookup *lookup;
+  ChannelMapPtr cell;
+  int ncells = channel_grid_cols * channel_grid_rows;
+  int nrec = 0;
+  int row, col, k;
+
+  for (col = 0; col < channel_grid_cols; col++) {
+    for (row = 0; row < channel_grid_rows; row++) {
+      for (cell = map[col][row]; cell != NULL; cell = cell->next)
+	nrec++;
+    }
+  }
+
+  if ((lookup = (ChannelLookup *) malloc(sizeof(ChannelLookup))) == NULL ||
+      (lookup->first = (int *) malloc((ncells + 1) * sizeof(int))) == NULL ||
+      (lookup->channel =
+       (Channel **) malloc((nrec + 1) * sizeof(Channel *))) == NULL ||
+      (lookup->length = (float *) malloc((nrec + 1) * sizeof(float))) == NULL ||
+      (lookup->azimuth = (float *) malloc((nrec + 1) * sizeof(float))) == NULL ||
+      (lookup->sink = (char *) malloc((nrec + 1) * sizeof(char))) == NULL ||
+      (lookup->cell_length =
+       (double *) calloc(ncells, sizeof(double))) == NULL ||
+      (lookup->cell_width =
+       (double *) calloc(ncells, sizeof(double))) == NULL ||
+      (lookup->cell_bankht =
+       (double *) calloc(ncells, sizeof(double))) == NULL) {
+    error_handler(ERRHDL_FATAL, "channel_grid_compile: malloc failed: %s",
+		  strerror(errno));
+  }
+  lookup->cols = channel_grid_cols;
+
+  nrec = 0;
+  for (row = 0; row < channel_grid_rows; row++) {
+    for (col = 0; col < channel_grid_cols; col++) {
+      k = row * channel_grid_cols + col;
+      lookup->first[k] = nrec;
+      for (cell = map[col][row]; cell != NULL; cell = cell->next) {
+	lookup->channel[nrec] = cell->channel;
+	lookup->length[nrec] = cell->length;
+	lookup->azimuth[nrec] = cell->azimuth;
+	lookup->sink[nrec] = cell->sink;
+	nrec++;
+      }
+      if (map[col][row] != NULL) {
+	lookup->cell_length[k] = channel_grid_cell_length(map, col, row);
+	lookup->cell_width[k] = channel_grid_cell_width(map, col, row);
+	lookup->cell_bankht[k] = channel_grid_cell_bankht(map, col, row);
+      }
+    }
+  }
+  lookup->first[ncells] = nrec;
+
+  return (lookup);
+}
+
 /* -------------------------------------------------------------
    ---------------------- Query Functions ---------------------
    ------------------------------------------------------------- */
@@ -643,6 +709,157 @@ ChannelClass* channel_grid_class(ChannelMapPtr ** map, int col, int row)
   return pntr;
 }
 
+/* -------------------------------------------------------------
+   ------------------ Compiled Map Functions -------------------
+   The same queries as above, on the compiled lookup.  These are
+   the ones used during the time step.
+   ------------------------------------------------------------- */
+
+/* -------------------------------------------------------------
+   channel_lookup_has_channel
+   ------------------------------------------------------------- */
+int channel_lookup_has_channel(ChannelLookup * lookup, int col, int row)
+{
+  int k;
+
+  if (lookup != NULL) {
+    k = row * lookup->cols + col;
+    return (lookup->first[k + 1] > lookup->first[k]);
+  }
+  else
+    return FALSE;
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_has_sink
+   ------------------------------------------------------------- */
+int channel_lookup_has_sink(ChannelLookup * lookup, int col, int row)
+{
+  int k = row * lookup->cols + col;
+  int i;
+
+  for (i = lookup->first[k]; i < lookup->first[k + 1]; i++) {
+    if (lookup->sink[i])
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_cell_length
+   ------------------------------------------------------------- */
+double channel_lookup_cell_length(ChannelLookup * lookup, int col, int row)
+{
+  return lookup->cell_length[row * lookup->cols + col];
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_cell_width
+   ------------------------------------------------------------- */
+double channel_lookup_cell_width(ChannelLookup * lookup, int col, int row)
+{
+  return lookup->cell_width[row * lookup->cols + col];
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_cell_bankht
+   ------------------------------------------------------------- */
+double channel_lookup_cell_bankht(ChannelLookup * lookup, int col, int row)
+{
+  return lookup->cell_bankht[row * lookup->cols + col];
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_inc_inflow
+   see channel_grid_inc_inflow
+   ------------------------------------------------------------- */
+void channel_lookup_inc_inflow(ChannelLookup * lookup, int col, int row,
+			       float mass)
+{
+  int k = row * lookup->cols + col;
+  float len = lookup->cell_length[k];
+  int i;
+
+  for (i = lookup->first[k]; i < lookup->first[k + 1]; i++)
+    lookup->channel[i]->lateral_inflow += mass * lookup->length[i] / len;
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_inc_melt
+   see channel_grid_inc_melt
+   ------------------------------------------------------------- */
+void channel_lookup_inc_melt(ChannelLookup * lookup, int col, int row,
+			     float mass)
+{
+  int k = row * lookup->cols + col;
+  float len = lookup->cell_length[k];
+  int i;
+
+  for (i = lookup->first[k]; i < lookup->first[k + 1]; i++)
+    lookup->channel[i]->melt += mass * lookup->length[i] / len;
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_inc_other
+   see channel_grid_inc_other
+   ------------------------------------------------------------- */
+void channel_lookup_inc_other(ChannelLookup * lookup, int col, int row,
+			      PIXRAD * LocalRad, PIXMET * LocalMet,
+			      float skyview)
+{
+  int k = row * lookup->cols + col;
+  Channel *channel;
+  int i;
+
+  for (i = lookup->first[k]; i < lookup->first[k + 1]; i++) {
+    channel = lookup->channel[i];
+    channel->ISW += LocalRad->ObsShortIn;
+    channel->NSW += LocalRad->RBMNetShort;
+    channel->Beam += LocalRad->PixelBeam;
+    channel->Diffuse += LocalRad->PixelDiffuse;
+    channel->ILW += LocalRad->PixelLongIn;
+    channel->NLW += LocalRad->RBMNetLong;
+    channel->VP += LocalMet->Eact;
+    channel->WND += LocalMet->Wind;
+    channel->ATP += LocalMet->Tair;
+    channel->azimuth += lookup->azimuth[i] * lookup->length[i] / channel->length;
+    channel->skyview += skyview;
+  }
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_outflow
+   see channel_grid_outflow
+   ------------------------------------------------------------- */
+double channel_lookup_outflow(ChannelLookup * lookup, int col, int row)
+{
+  int k = row * lookup->cols + col;
+  double mass = 0.0;
+  int i;
+
+  for (i = lookup->first[k]; i < lookup->first[k + 1]; i++) {
+    if (lookup->sink[i])
+      mass += lookup->channel[i]->outflow;
+  }
+  return mass;
+}
+
+/* -------------------------------------------------------------
+   channel_lookup_free
+   ------------------------------------------------------------- */
+void channel_lookup_free(ChannelLookup * lookup)
+{
+  free(lookup->first);
+  free(lookup->channel);
+  free(lookup->length);
+  free(lookup->azimuth);
+  free(lookup->sink);
+  free(lookup->cell_length);
+  free(lookup->cell_width);
+  free(lookup->cell_bankht);
+  free(lookup);
+}
+
 /* -------------------------------------------------------------
    ---------------------- Module Functions ---------------------
    ------------------------------------------------------------- */
@@ -41,6 +41,25 @@ struct _channel_map_rec_ {
 typedef struct _channel_map_rec_ ChannelMapRec;
 typedef struct _channel_map_rec_ *ChannelMapPtr;
 
+/* -------------------------------------------------------------
+   struct ChannelLookup
+   The channel map compiled for the time step: the records of all
+   cells in one set of arrays, cell by cell in row-major order, in
+   the order of the lists.  The records of the cell (col, row) are
+   first[k] to first[k + 1] - 1, with k = row * cols + col.
+   ------------------------------------------------------------- */
+typedef struct {
+  int cols;			/* number of columns of the grid */
+  int *first;			/* first record of each cell */
+  Channel **channel;		/* segment of each record */
+  float *length;		/* channel length of each record (m) */
+  float *azimuth;		/* channel azimuth of each record */
+  char *sink;			/* is this record a channel sink? */
+  double *cell_length;		/* total channel length of each cell (m) */
+  double *cell_width;		/* length weighted cut width of each cell (m) */
+  double *cell_bankht;		/* length weighted cut height of each cell (m) */
+} ChannelLookup;
+
 /* -------------------------------------------------------------
    externally available routines
    ------------------------------------------------------------- */
@@ -53,7 +72,8 @@ void channel_grid_done(void);
 				/* Input Functions */
 
 ChannelMapPtr **channel_grid_read_map(Channel *net, const char *file,
-				      SOILPIX **SoilMap);
+				      MAPSIZE *Map, SOILCELLS *SoilCells);
+ChannelLookup *channel_grid_compile(ChannelMapPtr **map);
 
 				/* Query Functions */
 
@@ -73,6 +93,22 @@ ChannelClass* channel_grid_class(ChannelMapPtr **map, int col, int row);
 
 void channel_grid_free_map(ChannelMapPtr **map);
 
+				/* Compiled Map Functions */
+
+int channel_lookup_has_channel(ChannelLookup *lookup, int col, int row);
+int channel_lookup_has_sink(ChannelLookup *lookup, int col, int row);
+double channel_lookup_cell_length(ChannelLookup *lookup, int col, int row);
+double channel_lookup_cell_width(ChannelLookup *lookup, int col, int row);
+double channel_lookup_cell_bankht(ChannelLookup *lookup, int col, int row);
+void channel_lookup_inc_inflow(ChannelLookup *lookup, int col, int row,
+			       float mass);
+void channel_lookup_inc_melt(ChannelLookup *lookup, int col, int row,
+			     float mass);
+void channel_lookup_inc_other(ChannelLookup *lookup, int col, int row,
+			      PIXRAD *LocalRad, PIXMET *LocalMet, float skyview);
+double channel_lookup_outflow(ChannelLookup *lookup, int col, int row);
+void channel_lookup_free(ChannelLookup *lookup);
+
 /* new functions for RBM model */
 void channel_grid_inc_other(ChannelMapPtr **map, int col, int row, PIXRAD *LocalRad , 
 							PIXMET *LocalMet, float skyview);
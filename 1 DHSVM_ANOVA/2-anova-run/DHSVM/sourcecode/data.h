@@ -56,10 +56,12 @@ typedef struct {
 typedef struct {
   char Path[BUFSIZE + 1];			/* Path to dump to */
   char InitStatePath[BUFSIZE + 1];	/* Path for initial state */
+  char EnsembleStore[BUFSIZE + 1];	/* Binary streamflow store shared by all runs, or "none" */
   FILES Aggregate;					/* File with aggregated values for entire basin */
   FILES Balance;					/* File with summed mass balance values for entire basin */
   FILES FinalBalance;               /* File with summed mass balance values for the entire simulation period for entire basin */
   FILES Stream;
+  FILES SatExtent;					/* Saturation extent, appended to by every run */
   int NStates;						/* Number of model state dumps */
   DATE *DState;						/* Array with dates on which to dump state */
   int NPix;							/* Number of pixels for which to output timeseries */
@@ -86,6 +88,14 @@ typedef struct {
   int MaxTravelTime;
   int TotalWaveLength;
   int *WaveLength;
+  int Dt;			/* Width of a hydrograph bin, the model time step (s) */
+  int NBins;			/* Number of bins in the hydrograph ring buffer */
+  int Head;			/* Bin of the current time step */
+  int *NClassBins;		/* Number of bins of each travel time class */
+  double **ClassBins;		/* Unit hydrograph of each travel time class,
+				   summed per bin */
+  double *ClassRunoff;		/* Runoff of each travel time class in the
+				   current time step */
 } UNITHYDRINFO;
 
 typedef enum {
@@ -163,6 +173,10 @@ typedef struct {
   int OffsetY;					 /* Offset in y-direction compared to basemap */
   int NumCells;                  /* Number of cells within the basin */
   ITEM *OrderedCells;            /* Structure array to hold the ranked elevations; NumCells in size */
+  int *BasinCell;                /* Offset y * NX + x of each basin cell in
+                                    row-major order; NumCells in size */
+  int *BasinIndex;               /* Position of each grid cell in BasinCell,
+                                    -1 outside the basin; NY * NX in size */
 } MAPSIZE;
 
 typedef struct {
@@ -196,9 +210,28 @@ typedef struct {
                                  specified.  In that case this field is TRUE
                                  for one (and only one) station, and FALSE for all others */
   FILES MetFile;				      /* File with observations */
+  float *MetCache;				      /* First record of the station in the met
+                                 cache, NULL if read from MetFile */
   MET Data;
 } METLOCATION;
 
+typedef struct {
+  int Station;					/* Index of the station */
+  uchar Weight;					/* Interpolation weight, the weights of a
+                                 pixel add up to about MAXUCHAR */
+} METWEIGHT;
+
+typedef struct {
+  int NY;					/* Number of rows */
+  int NX;					/* Number of columns */
+  size_t NWeights;				/* Number of nonzero weights */
+  size_t *Start;				/* First weight of each pixel, row by row,
+                                 and NWeights at the end.  NULL if there are
+                                 no weights (MM5 input) */
+  METWEIGHT *Weight;				/* Nonzero weights of all pixels, by
+                                 station within a pixel */
+} METWEIGHTS;
+
 typedef struct {
   int utmzone;                  /* utm zone used as reference for all geospatial input */
   int NGrids;                   /* total met grids used for memory allocation, must >= actual grids used */
@@ -209,6 +242,15 @@ typedef struct {
   float LonWest;                /* extreme west longitude */
   char filepath[BUFSIZE + 1];   /* file path */
   char fileprefix[BUFSIZE + 1]; /* file path */
+  int NLat;                     /* number of latitudes of the met grid, only for GRIDCELL and BILINEAR */
+  int NLon;                     /* number of longitudes of the met grid */
+  float Lat0;                   /* southernmost latitude of the met grid */
+  float Lon0;                   /* westernmost longitude of the met grid */
+  float DLat;                   /* latitude spacing of the met grid */
+  float DLon;                   /* longitude spacing of the met grid */
+  int *Node;                    /* station of each grid point, latitude by latitude, -1 if not used */
+  float *NodeN;                 /* model row of each grid point */
+  float *NodeE;                 /* model column of each grid point */
 } GRID;
 
 typedef struct {
@@ -251,6 +293,7 @@ typedef struct {
   int SnowSlide;                /* if snow sliding option is true */
   int PrecipSepr;               /* if TRUE use separate input of rain and snow */
   int SnowStats;               /* if TRUE dumps snow statistics for each water year */
+  int Threads;                  /* Number of threads for the pixel loop */
   char PrismDataPath[BUFSIZE + 1];
   char PrismDataExt[BUFSIZE + 1];
   char ShadingDataPath[BUFSIZE + 1];
@@ -296,6 +339,23 @@ typedef struct {
   float PixelDiffuse;       /* Net diffuse radiation W/m2 (used for RBM only) */
 } PIXRAD;
 
+/* Contributions of one pixel to totals that are shared by all pixels.  The
+   pixel loop stores them, and they are added in pixel order after the loop,
+   so that the pixels can be processed in parallel with the same results */
+typedef struct {
+  float ChannelInflow;      /* Precipitation on the stream channel (m3) */
+  PIXMET Met;               /* Local meteorology, for the stream temperature */
+} PIXSTEP;
+
+/* Flow directions for the subsurface and snow slide routing, allocated once
+   per run and reused every time step.  Cell (y, x) is at y * NX + x and its
+   NDIRS direction fractions start at Dir[(y * NX + x) * NDIRS] */
+typedef struct {
+  float *FlowGrad;          /* Magnitude of flow gradient slope * width */
+  unsigned int *TotalDir;   /* Sum of the direction fractions */
+  unsigned char *Dir;       /* Fraction of flux moving in each direction */
+} ROUTEWORK;
+
 typedef struct {
   float Area;			    /* Area of road or channel cut (m) */
   float BankHeight;		/* Height of road or channel cut (m) */
@@ -383,17 +443,16 @@ typedef struct {
   unint MeltOutDate;    /* Last day of SWE of the water year */
 } SNOWPIX;
 
+/* Soil depth, water table depth, lateral conductivity and saturated flow
+   are kept in SOILCELLS instead, see below */
 typedef struct {
   int   Soil;			/* Soil type */
-  float Depth;			/* Depth of total soil zone, including all root
-						zone layers, and the saturated zone */
-  float *Moist;			/* Soil moisture content in layers (0-1) */
+  float *Moist;			/* Soil moisture content in layers (0-1), points
+				   into SOILCELLS.Moist */
   float *Perc;			/* Percolation from layers */
   float *Temp;			/* Temperature in each layer (C) */
-  float TableDepth;		/* Depth of water table below ground surface (m) */
   float WaterLevel;		/* Absolute height of the watertable above datum (m), 
 						i.e. corrected for terrain elevation */
-  float SatFlow;		/* amount of saturated flow generated */
   float IExcess;		/* amount of surface runoff (m) generated from HOF and Return flow */
   float Runoff;         /* Surface water flux (m) from the grid cell. */
   float ChannelInt;		/* amount of subsurface flow intercepted by the channel */
@@ -412,11 +471,24 @@ typedef struct {
   float DetentionIn;			 /* detention storage change in current time step */
   float DetentionOut;            /* water flow out of detention storage */
   
-  float KsLat;      /* Soil Lateral Conductivity */
   float *Porosity;          /* Soil Porosity */
   float *FCap;      /* soil field capacity */
 } SOILPIX;
 
+/* Soil variables that RouteSubSurface() sweeps over every time step, one
+   array per variable in the order of MAPSIZE.BasinCell, so that the sweeps
+   run with unit stride.  Moist holds NLayers entries per cell, the layers
+   of a cell being contiguous for the vertical water balance */
+typedef struct {
+  int NLayers;			/* Entries per cell in Moist, MaxLayers + 1 */
+  float *Depth;			/* Depth of total soil zone, including all root
+				   zone layers, and the saturated zone (m) */
+  float *TableDepth;		/* Depth of water table below ground surface (m) */
+  float *KsLat;			/* Soil lateral conductivity */
+  float *SatFlow;		/* amount of saturated flow generated (m) */
+  float *Moist;			/* Soil moisture content in layers (0-1) */
+} SOILCELLS;
+
 typedef struct {
   char Desc[BUFSIZE + 1];	/* Soil type */
   int Index;
@@ -625,6 +697,9 @@ typedef struct {
   SNOWPIX Snow;
   SOILPIX Soil;
   VEGPIX Veg;
+  float SoilDepth;		/* Averages of the SOILCELLS variables */
+  float TableDepth;
+  float SatFlow;
   float NetRad;
   float SoilWater;
   float CanopyWater;
@@ -636,4 +711,27 @@ typedef struct {
   float CulvertToChannel;
 } AGGREGATED;
 
+/* One entry of a soil or vegetation table that is taken from the parameter
+   vector instead of the input file (see ParameterBinding.c) */
+typedef struct {
+  int Table;			/* SOIL_BINDING or VEG_BINDING */
+  int Class;			/* Soil or vegetation class (0 based) */
+  int Column;			/* Column of the parameter vector */
+  size_t Offset;		/* Offset of the field in SOILTABLE or VEGTABLE */
+  int Kind;			/* How the field is stored, see ParameterBinding.c */
+  int Length;			/* Number of elements, or a layer count rule */
+  int Start;			/* First element that is set */
+  int NFactors;			/* Number of elements that are set, 0 for all */
+  double *Scale;		/* Element Start+k is Scale[k] * value + Shift[k] */
+  double *Shift;
+  char Name[BUFSIZE + 1];	/* Table, class and field, for error messages */
+} PARBINDING;
+
+typedef struct {
+  int NBindings;
+  int NParam;			/* Length of the parameter vector, including the
+				   run number in the last column */
+  PARBINDING *Binding;
+} PARBINDINGS;
+
 #endif
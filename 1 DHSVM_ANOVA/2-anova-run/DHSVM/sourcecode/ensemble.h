@@ -0,0 +1,66 @@
+/*
+ * SUMMARY:      ensemble.h - header file for EnsembleStore.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Layout of the binary streamflow ensemble store.  All runs of
+ *               a campaign write the outflow of the recorded stream segments
+ *               into one file, one row per run, which the analysis tools
+ *               (objective.c, dailyflow.c) map into memory.
+ *
+ *               The file is, in native byte order:
+ *                 ENSEMBLEHEADER
+ *                 NSteps dates of ENSEMBLE_DATELEN characters
+ *                 NSeries segment names of ENSEMBLE_NAMELEN characters
+ *                 padding up to DataOffset
+ *                 rows of RowSize bytes, row r at DataOffset + r * RowSize
+ *               Each row is an ENSEMBLEROW followed by NSteps x NSeries
+ *               floats in step order, i.e. the outflow of segment s at step
+ *               t is value t * NSeries + s.  Outflow is in m3 per time step,
+ *               as in Streamflow.Only.  Rows of runs that did not finish are
+ *               holes in the file and read as Status == 0.
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:     This header only uses standard C types, so that the analysis
+ *               tools can include it without the rest of DHSVM.
+ */
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#define ENSEMBLE_MAGIC    "DHSVMENS"
+#define ENSEMBLE_VERSION  1
+#define ENSEMBLE_DATELEN  20	/* "01.01.2000-00:00:00" and terminator */
+#define ENSEMBLE_NAMELEN  32
+#define ENSEMBLE_ROW_DONE 1
+
+typedef struct {
+  char Magic[8];		/* ENSEMBLE_MAGIC, not terminated */
+  int Version;			/* ENSEMBLE_VERSION */
+  int NSteps;			/* Number of model time steps */
+  int NSeries;			/* Number of recorded stream segments */
+  int Dt;			/* Model time step in seconds */
+  int DataOffset;		/* Offset of the first row in bytes */
+  int RowSize;			/* Size of one row in bytes */
+} ENSEMBLEHEADER;
+
+typedef struct {
+  int Status;			/* ENSEMBLE_ROW_DONE once the run has finished */
+  int RunNumber;		/* Run that wrote the row */
+} ENSEMBLEROW;
+
+/* Outflow of one run, buffered until the run has finished */
+typedef struct {
+  int fd;			/* Open store */
+  int RunNumber;		/* Row to write */
+  int NSteps;			/* Number of model time steps */
+  int NSeries;			/* Number of recorded stream segments */
+  int Step;			/* Next step to fill */
+  int Dt;			/* Model time step in seconds */
+  char *Dates;			/* NSteps x ENSEMBLE_DATELEN */
+  char *Names;			/* NSeries x ENSEMBLE_NAMELEN */
+  float *Values;		/* NSteps x NSeries */
+} ENSEMBLEWRITER;
+
+#endif
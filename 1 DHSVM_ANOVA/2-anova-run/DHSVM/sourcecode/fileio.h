@@ -43,4 +43,6 @@ int Write2DMatrix(char *FileName, void *Matrix, int NumberType,
 void OpenFile(FILE **FilePtr, char *FileName, char *Mode,
 	      unsigned char OverWrite);
 
+void OpenOutputFile(FILE **FilePtr, char *FileName, char *Mode);
+
 #endif
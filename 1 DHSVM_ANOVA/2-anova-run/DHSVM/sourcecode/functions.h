@@ -19,16 +19,19 @@
 #include "data.h"
 #include "channel.h"
 #include "DHSVMChannel.h"
-#define NPARAM 105
 
 void Aggregate(MAPSIZE *Map, OPTIONSTRUCT *Options, TOPOPIX **TopoMap,
 	       LAYER *Soil, LAYER *Veg, VEGPIX **VegMap, EVAPPIX **Evap,
 	       PRECIPPIX **Precip, PIXRAD **RadMap, SNOWPIX **Snow,
-	       SOILPIX **SoilMap, AGGREGATED *Total, VEGTABLE *VType,
-	       ROADSTRUCT **Network, CHANNEL *ChannelData, float *roadarea, int Dt);
+	       SOILPIX **SoilMap, SOILCELLS *SoilCells, AGGREGATED *Total,
+	       VEGTABLE *VType, ROADSTRUCT **Network, CHANNEL *ChannelData,
+	       float *roadarea, int Dt);
+
+void ApplyParameterBindings(PARBINDINGS *Bindings, int Table, void *Types,
+			    int NTypes, double *Anovapara);
 
 void Avalanche(MAPSIZE *Map, TOPOPIX **TopoMap, TIMESTRUCT *Time, OPTIONSTRUCT *Options,
-  SNOWPIX **SnowMap);
+  SNOWPIX **SnowMap, ROUTEWORK *Work);
 
 void CalcAerodynamic(int NVegLayers, unsigned char OverStory,
 		     float n, float *Height, float Trunk, float *U,
@@ -50,14 +53,15 @@ float CalcTransmissivity(float SoilDepth, float WaterTable, float LateralKs,
 			 float KsExponent, float DepthThresh);
 
 void CalcWeights(METLOCATION *Station, int NStats, int NX, int NY,
-		 uchar **BasinMask, uchar ****WeightArray,
+		 uchar **BasinMask, METWEIGHTS *MetWeights, GRID *Grid,
 		 OPTIONSTRUCT *Options);
 
 double ChannelCulvertSedFlow(int y, int x, CHANNEL * ChannelData, int i);
 
 void CheckOut(OPTIONSTRUCT *Options, LAYER Veg, LAYER Soil,
 	      VEGTABLE *VType, SOILTABLE *SType, MAPSIZE *Map, 
-	      TOPOPIX **TopoMap, VEGPIX **VegMap, SOILPIX **SoilMap);
+	      TOPOPIX **TopoMap, VEGPIX **VegMap, SOILPIX **SoilMap,
+	      SOILCELLS *SoilCells);
 
 unsigned char dequal(double a, double b);
 
@@ -65,19 +69,22 @@ void deg2utm(float la, float lo, float *x, float *y, int zone);
 
 void draw(DATE *Day, int first, int DayStep, MAPSIZE *Map, int NGraphics,
 	  int *which_graphics, VEGTABLE *VType, SOILTABLE *SType, SNOWPIX **SnowMap, 
-	  SOILPIX **SoilMap, VEGPIX **VegMap, TOPOPIX **TopoMap, PRECIPPIX **PrecipMap, 
+	  SOILPIX **SoilMap, SOILCELLS *SoilCells, VEGPIX **VegMap, TOPOPIX **TopoMap,
+	  PRECIPPIX **PrecipMap, 
 	  float **PrismMap, float **SkyViewMap, unsigned char ***ShadowMap, 
 	  EVAPPIX **EvapMap, PIXRAD **RadMap, MET_MAP_PIX **MetMap,
 	  ROADSTRUCT **Network, OPTIONSTRUCT *Options);
 
 void DumpMap(MAPSIZE *Map, DATE *Current, MAPDUMP *DMap, TOPOPIX **TopoMap,
 	     EVAPPIX **EvapMap, PRECIPPIX **PrecipMap, PIXRAD **RadMap,
-	     SNOWPIX **Snowap, SOILPIX **SoilMap, LAYER *Soil, VEGPIX **VegMap, 
+	     SNOWPIX **Snowap, SOILPIX **SoilMap, SOILCELLS *SoilCells,
+	     LAYER *Soil, VEGPIX **VegMap, 
          LAYER *Veg, ROADSTRUCT **Network, OPTIONSTRUCT *Options);
 
 void DumpPix(DATE *Current, int first, FILES *OutFile, EVAPPIX *Evap,
         PRECIPPIX *Precip, PIXRAD *Rad, SNOWPIX *Snow, SOILPIX *Soil,
-        VEGPIX *Veg, int NSoil, int NVeg, OPTIONSTRUCT *Options, int flag);
+        float TableDepth, float SatFlow, VEGPIX *Veg, int NSoil, int NVeg,
+        OPTIONSTRUCT *Options, int flag);
 
 #ifdef TOPO_DUMP
 void DumpTopo(MAPSIZE *Map, TOPOPIX **TopoMap);
@@ -86,8 +93,8 @@ void DumpTopo(MAPSIZE *Map, TOPOPIX **TopoMap);
 void ExecDump(MAPSIZE *Map, DATE *Current, DATE *Start, OPTIONSTRUCT *Options,
 	      DUMPSTRUCT *Dump, TOPOPIX **TopoMap, EVAPPIX **EvapMap, PIXRAD **RadiMap,
 	      PRECIPPIX ** PrecipMap, SNOWPIX **SnowMap, MET_MAP_PIX **MetMap, 
-          VEGPIX **VegMap, LAYER *Veg, SOILPIX **SoilMap, ROADSTRUCT **Network, 
-          CHANNEL *ChannelData, LAYER *Soil, AGGREGATED *Total, 
+          VEGPIX **VegMap, LAYER *Veg, SOILPIX **SoilMap, SOILCELLS *SoilCells,
+          ROADSTRUCT **Network, CHANNEL *ChannelData, LAYER *Soil, AGGREGATED *Total, 
 	      UNITHYDRINFO *HydrographInfo, float *Hydrograph);
 
 unsigned char fequal(float a, float b);
@@ -109,12 +116,14 @@ uchar InArea(MAPSIZE *Map, COORD *Loc);
 void InitAggregated(OPTIONSTRUCT *Options, int MaxVegLayers, int MaxSoilLayers,
   AGGREGATED *Total);
 
+void InitBasinIndex(MAPSIZE *Map, TOPOPIX **TopoMap);
+
 void InitChannelRVeg(TIMESTRUCT *Time, Channel *Channel); 
 
 void InitCharArray(char *Array, int Size);
 
 void InitConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
-	SOLARGEOMETRY *SolarGeo, TIMESTRUCT *Time, double Anovapara[NPARAM]);
+	SOLARGEOMETRY *SolarGeo, TIMESTRUCT *Time, double *Anovapara);
 
 void InitDump(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
 	      int MaxSoilLayers, int MaxVegLayers, int Dt,
@@ -130,28 +139,29 @@ void InitImageDump(LISTPTR Input, int Dt, MAPSIZE *Map, int MaxSoilLayers,
 void InitInFiles(INPUTFILES *InFiles);
 
 void InitInterpolationWeights(MAPSIZE *Map, OPTIONSTRUCT *Options,
-			      TOPOPIX **TopoMap, uchar ****MetWeights,
-			      METLOCATION *Stats, int NStats);
+			      TOPOPIX **TopoMap, METWEIGHTS *MetWeights,
+			      METLOCATION *Stats, int NStats, GRID *Grid);
 
 void InitMapDump(LISTPTR Input, MAPSIZE *Map, int MaxSoilLayers, int MaxVegLayers,
 		 char *Path, int TotalMapImages, int NMaps, MAPDUMP **DMap);
 
 void InitMappedConstants(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
-                         SNOWPIX ***SnowMap, double Anovapara[NPARAM]);
+                         SNOWPIX ***SnowMap, double *Anovapara);
 
 void InitMassWaste(LISTPTR Input, TIMESTRUCT *Time);
 
 void InitGridMet(OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map, TOPOPIX **TopoMap,  
          GRID *Grid, METLOCATION **Stat, int *NStats);
 
+void InitMetLattice(GRID *Grid, MAPSIZE *Map, int NPoints, float *Lat,
+		    float *Lon);
+
 void InitMetMaps(LISTPTR Input, int NDaySteps, MAPSIZE *Map, MAPSIZE *Radar,
 		 OPTIONSTRUCT *Options, char *WindPath, char *PrecipLapsePath,
 		 float ***PrecipLapseMap, float ***PrismMap,
 		 unsigned char ****ShadowMap, float ***SkyViewMap,
-		 EVAPPIX ***EvapMap, PRECIPPIX ***PrecipMap, float ***PptMultiplierMap,
-		 RADARPIX ***RadarMap, PIXRAD ***RadMap, SOILPIX **SoilMap, 
-                 LAYER *Soil, VEGPIX **VegMap, LAYER *Veg, TOPOPIX **TopoMap, 
-                 float ****MM5Input, float ****WindModel);
+		 float ***PptMultiplierMap, RADARPIX ***RadarMap, int NSoilLayers,
+		 float ****MM5Input, float ****WindModel);
 
 void InitMetSources(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
             TOPOPIX **TopoMap, int NSoilLayers, TIMESTRUCT *Time, 
@@ -163,19 +173,20 @@ void InitMM5(LISTPTR Input, int NSoilLayers, TIMESTRUCT *Time,
 	     MAPSIZE *Map);
 
 void InitMM5Maps(int NSoilLayers, int NY, int NX, float ****MM5Input,
-		 PIXRAD ***RadMap, OPTIONSTRUCT *Options);
+		 OPTIONSTRUCT *Options);
 
 void InitModelState(DATE *Start, int StepsPerDay, MAPSIZE *Map, OPTIONSTRUCT *Options,
 		    PRECIPPIX **PrecipMap, SNOWPIX **SnowMap,
-		    SOILPIX **SoilMap, LAYER Soil, SOILTABLE *SType,
-		    VEGPIX **VegMap, LAYER Veg, VEGTABLE *VType, char *Path,
+		    SOILPIX **SoilMap, SOILCELLS *SoilCells, LAYER Soil,
+		    SOILTABLE *SType, VEGPIX **VegMap, LAYER Veg, VEGTABLE *VType,
+		    char *Path,
 		    TOPOPIX **TopoMap,
 		    ROADSTRUCT **Network, UNITHYDRINFO *HydrographInfo,
 		    float *Hydrograph);
 
 void InitNetwork(int NY, int NX, float DX, float DY, TOPOPIX **TopoMap, 
-		 SOILPIX **SoilMap, VEGPIX **VegMap, VEGTABLE *VType, 
-		 ROADSTRUCT ***Network, CHANNEL *ChannelData, 
+		 SOILCELLS *SoilCells, int *BasinIndex, VEGPIX **VegMap,
+		 VEGTABLE *VType, ROADSTRUCT ***Network, CHANNEL *ChannelData, 
 		 LAYER Veg, OPTIONSTRUCT *Options);
 
 void InitNewDay(int DayOfYear, SOLARGEOMETRY *SolarGeo);
@@ -189,12 +200,15 @@ void InitNewStep(INPUTFILES *InFiles, MAPSIZE *Map, TIMESTRUCT *Time,
 		 int NSoilLayers, OPTIONSTRUCT *Options, int NStats,
 		 METLOCATION *Stat, char *RadarFileName, MAPSIZE *Radar,
 		 RADARPIX **RadarMap, SOLARGEOMETRY *SolarGeo, 
-		 TOPOPIX **TopoMap, SOILPIX **SoilMap, float ***MM5Input, 
+		 TOPOPIX **TopoMap, SOILPIX **SoilMap, SOILCELLS *SoilCells,
+		 float ***MM5Input, 
                  float **PrecipLapseMap, float ***WindModel, MAPSIZE *MM5Map);
 
 void InitNewWaterYear(TIMESTRUCT *Time, OPTIONSTRUCT *Options, MAPSIZE *Map,
                 TOPOPIX **TopoMap, SNOWPIX **SnowMap);
 
+void InitParameterBindings(LISTPTR Input, PARBINDINGS *Bindings);
+
 void InitParameterMaps(OPTIONSTRUCT *Options, MAPSIZE *Map, int Id,
   char *FileName, SNOWPIX ***SnowMap, int ParamType, float temp);
 
@@ -228,10 +242,12 @@ void InitSatVaporTable(void);
 void InitSnowMap(MAPSIZE *Map, SNOWPIX ***SnowMap, TIMESTRUCT *Time);
 
 void InitSoilMap(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
-		 LAYER *Soil, TOPOPIX **TopoMap, SOILPIX ***SoilMap, SOILTABLE * SType);
+		 LAYER *Soil, TOPOPIX **TopoMap, SOILPIX ***SoilMap,
+		 SOILCELLS *SoilCells, SOILTABLE * SType);
 
 int InitSoilTable(OPTIONSTRUCT *Options, SOILTABLE **SType, 
-			LISTPTR Input, LAYER *Soil, int InfiltOption, double Anovapara[NPARAM]);
+			LISTPTR Input, LAYER *Soil, int InfiltOption, PARBINDINGS *Bindings,
+			double *Anovapara);
 
 void InitStateDump(LISTPTR Input, int NStates, DATE **DState);
 
@@ -242,23 +258,24 @@ void InitStations(LISTPTR Input, MAPSIZE *Map, int NDaySteps,
 
 void InitTables(int StepsPerDay, LISTPTR Input, OPTIONSTRUCT *Options,
     MAPSIZE *Map, SOILTABLE **SType, LAYER *Soil, VEGTABLE **VType,
-    LAYER *Veg, double Anovapara[NPARAM]);
+    LAYER *Veg, PARBINDINGS *Bindings, double *Anovapara);
     
 void InitTerrainMaps(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
   LAYER *Soil, LAYER *Veg, TOPOPIX ***TopoMap, SOILTABLE *SType,
-  SOILPIX ***SoilMap, VEGTABLE *VType, VEGPIX ***VegMap);
+  SOILPIX ***SoilMap, SOILCELLS *SoilCells, VEGTABLE *VType, VEGPIX ***VegMap);
 
 void InitTopoMap(LISTPTR Input, OPTIONSTRUCT *Options, MAPSIZE *Map,
 		 TOPOPIX ***TopoMap);
 
-void InitUnitHydrograph(LISTPTR Input, MAPSIZE *Map, TOPOPIX **TopoMap,
-			UNITHYDR ***UnitHydrograph, float **Hydrograph,
-			UNITHYDRINFO *HydrographInfo);
+void InitUnitHydrograph(LISTPTR Input, MAPSIZE *Map, int Dt,
+			TOPOPIX **TopoMap, UNITHYDR ***UnitHydrograph,
+			float **Hydrograph, UNITHYDRINFO *HydrographInfo);
 
 void InitVegMap( OPTIONSTRUCT *Options, LISTPTR Input, MAPSIZE *Map, VEGPIX ***VegMap,
 				VEGTABLE *VType);
 
-int InitVegTable(VEGTABLE **VType, LISTPTR Input, OPTIONSTRUCT *Options, LAYER *Veg, double Anovapara[NPARAM]);
+int InitVegTable(VEGTABLE **VType, LISTPTR Input, OPTIONSTRUCT *Options, LAYER *Veg,
+    PARBINDINGS *Bindings, double *Anovapara);
 
 float evalexpint(int n, float x);
 
@@ -279,7 +296,7 @@ float LapseT(float Temp, float FromElev, float ToElev, float LapseRate);
  
 PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
 			OPTIONSTRUCT *Options, int NStats, METLOCATION *Stat, 
-      uchar *MetWeights, float LocalElev, PIXRAD *RadMap,
+      METWEIGHTS *MetWeights, float LocalElev, PIXRAD *RadMap,
 			PRECIPPIX *PrecipMap, MAPSIZE *Radar, RADARPIX **RadarMap,
 			float **PrismMap, SNOWPIX *LocalSnow, 
       CanopyGapStruct **Gap, VEGPIX *VegMap,
@@ -287,6 +304,9 @@ PIXMET MakeLocalMetData(int y, int x, MAPSIZE *Map, int DayStep, int NDaySteps,
 			MET_MAP_PIX ***MetMap, float precipMultiplier, int NGraphics, int Month, float skyview,
 			unsigned char shadow, float SunMax, float SineSolarAltitude);
 
+void MapShadowMonth(OPTIONSTRUCT *Options, MAPSIZE *Map, int NDaySteps,
+		    int Month, unsigned char ***ShadowMap);
+
 void MassBalance(DATE *Current, DATE *Start, FILES *Out, AGGREGATED *Total, WATERBALANCE *Mass);
 
 void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x, float SineSolarAltitude,
@@ -294,11 +314,16 @@ void MassEnergyBalance(OPTIONSTRUCT *Options, int y, int x, float SineSolarAltit
             int InfiltOption, int MaxSoilLayer, int MaxVegLayers, PIXMET *LocalMet,
             ROADSTRUCT *LocalNetwork, PRECIPPIX *LocalPrecip, VEGTABLE *VType,
             VEGPIX *LocalVeg, SOILTABLE *SType, SOILPIX *LocalSoil,
-            SNOWPIX *LocalSnow, PIXRAD *LocalRad, EVAPPIX *LocalEvap, PIXRAD *TotalRad,
-            CHANNEL *ChannelData, float **skyview);
+            float SoilDepth, float SatFlow, float *TableDepth, SNOWPIX *LocalSnow, PIXRAD *LocalRad, EVAPPIX *LocalEvap,
+            CHANNEL *ChannelData, float *ChannelInflow);
 
 float MaxRoadInfiltration(ChannelMapPtr **map, int col, int row);
 
+int MetLatticeNode(GRID *Grid, float Lat, float Lon);
+
+void MetLatticePosition(GRID *Grid, double N, double E, double *Row,
+			double *Col);
+
 double pow (double a, double b);
 
 void quick(ITEM *OrderedCells, int count);
@@ -327,9 +352,10 @@ int Round(double x);
 void RouteSubSurface(int Dt, MAPSIZE *Map, TOPOPIX **TopoMap,
 		     VEGTABLE *VType, VEGPIX **VegMap,
 		     ROADSTRUCT **Network, SOILTABLE *SType,
-		     SOILPIX **SoilMap, CHANNEL *ChannelData, 
+		     SOILPIX **SoilMap, SOILCELLS *SoilCells, CHANNEL *ChannelData, 
 		     TIMESTRUCT *Time, OPTIONSTRUCT *Options, 
-		     char *DumpPath, int MaxStreamID, SNOWPIX **SnowMap);
+		     FILE *SatExtentFile, int MaxStreamID, SNOWPIX **SnowMap,
+		     ROUTEWORK *Work);
 
 void RouteSurface(MAPSIZE * Map, TIMESTRUCT * Time, TOPOPIX ** TopoMap,
   SOILPIX ** SoilMap, OPTIONSTRUCT *Options,
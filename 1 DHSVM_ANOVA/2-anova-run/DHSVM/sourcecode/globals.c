@@ -9,6 +9,15 @@
  * $Id: globals.c,v 1.4 2003/07/01 21:26:30 olivier Exp $
  */
 
+#include <stdio.h>
+#include "settings.h"
+
+/* global strings */
+char *version = "Version 3.2";        /* store version string */
+char commandline[BUFSIZE + 1] = "";		/* store command line */
+char fileext[BUFSIZ + 1] = "";			/* file extension */
+char errorstr[BUFSIZ + 1] = "";			/* error message */
+
 int NDIRS;                      /* How many neighbors are used in surface/subsurface routing */
 /* These indices are so neighbors can be looked up quickly */
 int xdirection4[] = {  0,  1,  0, -1 };
@@ -0,0 +1,55 @@
+/*
+ * SUMMARY:      metcache.h - header file for MetCache.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Layout of the binary met cache.  The file is a METCACHEHEADER,
+ *               NStats METCACHESOURCE records and then, time step by time
+ *               step, NStats records of METCACHE_NVARS floats in native byte
+ *               order, one record per station.  The records of a time step
+ *               are contiguous, so a step is read in one piece.
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:
+ */
+
+#ifndef METCACHE_H
+#define METCACHE_H
+
+#include "settings.h"
+#include "data.h"
+
+#define METCACHE_MAGIC "DHSVMMT2"	/* "DHSVMMET" was by station */
+
+/* position of the variables in a record */
+enum {
+  mc_tair, mc_wind, mc_rh, mc_sin, mc_lin, mc_precip, mc_rain, mc_snow,
+  mc_preciplapse, mc_templapse, mc_winddirection, mc_tsoil,
+  METCACHE_NVARS = mc_tsoil + 3
+};
+
+typedef struct {
+  char Magic[8];		/* METCACHE_MAGIC, not terminated */
+  double StartJulian;		/* Julian day of the first record */
+  int Dt;			/* Time step (s) */
+  int NSteps;			/* Number of records per station */
+  int NStats;			/* Number of stations */
+  int NVars;			/* METCACHE_NVARS */
+  int NSoilLayers;		/* Number of soil layers */
+  int Options;			/* Met options the records were read with */
+} METCACHEHEADER;
+
+typedef struct {
+  long long Size;		/* Size of the station file (bytes) */
+  long long MTime;		/* Modification time of the station file */
+  int IsWindModelLocation;	/* Station reads a wind direction */
+  int Spare;
+} METCACHESOURCE;
+
+void InitMetCache(char *FileName, OPTIONSTRUCT *Options, TIMESTRUCT *Time,
+		  int NSoilLayers, int NStats, METLOCATION *Stat);
+void ReadMetCache(OPTIONSTRUCT *Options, int Step, int NSoilLayers,
+		  int NStats, METLOCATION *Stat);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * SUMMARY:      parmatrix.h - header file for ParameterMatrix.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Layout of the binary parameter matrix that the ANOVA driver
+ *               writes once per campaign.  The file is a PARMATRIXHEADER
+ *               followed by NRows x NCols doubles in row order, one row per
+ *               sample, in native byte order.
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:
+ */
+
+#ifndef PARMATRIX_H
+#define PARMATRIX_H
+
+#define PARMATRIX_MAGIC "DHSVMPAR"
+
+typedef struct {
+  char Magic[8];		/* PARMATRIX_MAGIC, not terminated */
+  int NRows;			/* Number of samples */
+  int NCols;			/* Number of values per sample (PARBINDINGS NParam) */
+} PARMATRIXHEADER;
+
+void ReadParameterMatrix(char *FileName, int Row, int NCols, double *Values);
+
+#endif
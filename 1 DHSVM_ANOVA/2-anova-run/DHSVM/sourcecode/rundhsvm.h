@@ -0,0 +1,95 @@
+/*
+ * SUMMARY:      rundhsvm.h - header file for RunDHSVM.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Data structures and functions to run DHSVM repeatedly within
+ *               one process, one parameter vector at a time
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:
+ */
+
+#ifndef RUNDHSVM_H
+#define RUNDHSVM_H
+
+#include "settings.h"
+#include "data.h"
+#include "getinit.h"
+#include "functions.h"
+#include "DHSVMChannel.h"
+
+/* Inputs that do not depend on the parameter vector.  These are read once by
+   InitStaticInput() and shared by every call to RunParameterSample(), which
+   treats them as read-only */
+typedef struct {
+  LISTPTR Input;                /* Linked list with input strings */
+  INPUTFILES InFiles;
+  OPTIONSTRUCT Options;
+  MAPSIZE Map;                  /* Size and location of model area */
+  MAPSIZE Radar;                /* Area covered by precipitation radar */
+  MAPSIZE MM5Map;               /* Area covered by MM5 input files */
+  GRID Grid;
+  SOLARGEOMETRY SolarGeo;
+  TIMESTRUCT Time;              /* Model period, copied at the start of each run */
+  PARBINDINGS Bindings;         /* Table entries taken from the parameter vector */
+  int NSoilLayers;              /* Maximum number of soil layers */
+  int NStats;                   /* Number of meteorological stations */
+  METLOCATION *Stat;
+  TOPOPIX **TopoMap;
+  METWEIGHTS MetWeights;        /* Station interpolation weights */
+  float **PrecipLapseMap;
+  float **PrismMap;
+  unsigned char ***ShadowMap;
+  float **SkyViewMap;
+  float **PptMultiplierMap;
+  float ***MM5Input;
+  float ***WindModel;
+  RADARPIX **RadarMap;
+  MET_MAP_PIX **MetMap;         /* Only used for X11 graphics */
+  int argc;                     /* Command line, only used for X11 graphics */
+  char **argv;
+} STATICINPUT;
+
+/* Model state that depends on the parameter vector.  It is built from
+   scratch for each run and released by FreeModelState() */
+typedef struct {
+  int RunNumber;
+  OPTIONSTRUCT Options;
+  TIMESTRUCT Time;
+  SOLARGEOMETRY SolarGeo;
+  LAYER Soil;
+  LAYER Veg;
+  SOILTABLE *SType;
+  VEGTABLE *VType;
+  SOILPIX **SoilMap;
+  SOILCELLS SoilCells;          /* Soil variables of the routing, by basin cell */
+  VEGPIX **VegMap;
+  SNOWPIX **SnowMap;
+  EVAPPIX **EvapMap;
+  PRECIPPIX **PrecipMap;
+  PIXRAD **RadiationMap;
+  PIXSTEP **StepMap;            /* Pixel contributions to shared totals */
+  ROUTEWORK RouteWork;          /* Subsurface and snow slide directions */
+  ROADSTRUCT **Network;
+  CHANNEL ChannelData;
+  int MaxStreamID;
+  int MaxRoadID;
+  UNITHYDR **UnitHydrograph;
+  UNITHYDRINFO HydrographInfo;
+  float *Hydrograph;
+  DUMPSTRUCT Dump;
+  int NGraphics;                /* number of graphics for X11 */
+  int *which_graphics;          /* which graphics for X11 */
+  AGGREGATED Total;             /* Basin totals and averages */
+  WATERBALANCE Mass;
+} MODELSTATE;
+
+void InitStaticInput(char *ConfigFile, int argc, char **argv,
+		     STATICINPUT *Static);
+int RunParameterSample(STATICINPUT *Static, double *Anovapara);
+void RunModel(STATICINPUT *Static, double *Anovapara, MODELSTATE *State);
+int FreeModelState(STATICINPUT *Static, MODELSTATE *State);
+
+#endif
@@ -63,6 +63,8 @@ typedef unsigned int unint;
 #define INVDIST        1
 #define NEAREST        2
 #define VARCRESS       3
+#define GRIDCELL       4
+#define BILINEAR       5
 
 /* Options for model extent */
 #define POINT 1
@@ -81,6 +83,10 @@ typedef unsigned int unint;
 #define FIXED    1
 #define VARIABLE 2
 
+/* tables that parameter bindings refer to */
+#define SOIL_BINDING 1
+#define VEG_BINDING  2
+
 /* indicate ICE or GLACIER class */
 #define GLACIER -1234
 
@@ -120,7 +126,7 @@ enum KEYS {
   temp_lapse, precip_lapse, cressman_radius, cressman_stations, prism_data_path, 
   prism_data_ext, shading_data_path, shading_data_ext, skyview_data_path, 
   stream_temp, canopy_shading, improv_radiation, gapping, snowslide, sepr, 
-  snowstats, routing_neighbors, 
+  snowstats, routing_neighbors, threads, 
   /* Area */
   coordinate_system, extreme_north, extreme_west, center_latitude,
   center_longitude, time_zone_meridian, number_of_rows,
@@ -180,6 +186,7 @@ enum KEYS {
   /* number of each type of output */
   output_path =
     0, initial_state_path, npixels, nstates, nmapvars, nimagevars, ngraphics,
+  ensemble_store,
   /* pixel information */
   north = 0, east, name,
   /* state information */
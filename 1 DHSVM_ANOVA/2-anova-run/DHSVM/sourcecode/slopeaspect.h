@@ -30,9 +30,9 @@ extern int yneighbor[NNEIGHBORS];
    ------------------------------------------------------------- */
 void ElevationSlopeAspect(MAPSIZE * Map, TOPOPIX ** TopoMap);
 void HeadSlopeAspect(MAPSIZE * Map, TOPOPIX ** TopoMap, SOILPIX ** SoilMap,
-  float **FlowGrad, unsigned char ***Dir, unsigned int **TotalDir);
+  float *FlowGrad, unsigned char *Dir, unsigned int *TotalDir);
 void SnowSlopeAspect(MAPSIZE * Map, TOPOPIX ** TopoMap, SNOWPIX ** Snow,
-  float **FlowGrad, unsigned char ***Dir, unsigned int **TotalDir);
+  float *FlowGrad, unsigned char *Dir, unsigned int *TotalDir);
 int valid_cell(MAPSIZE * Map, int x, int y);
 void quick(ITEM *OrderedCells, int count);
 #endif
@@ -0,0 +1,55 @@
+/*
+ * SUMMARY:      staticshare.h - header file for StaticShare.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Layout of the shared static input file.  The file is a
+ *               STATICSHAREHEADER followed by the blocks named in its Blocks
+ *               mask, in the order of the ss_ flags.  Every block starts at a
+ *               multiple of STATICSHARE_ALIGN bytes and holds its maps row by
+ *               row in native byte order.
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:
+ */
+
+#ifndef STATICSHARE_H
+#define STATICSHARE_H
+
+#include "settings.h"
+#include "data.h"
+
+#define STATICSHARE_MAGIC "DHSVMSTA"
+#define STATICSHARE_ALIGN 4096
+
+/* blocks in the file */
+enum {
+  ss_weights = 1,		/* MetWeights, NY * NX + 1 size_t starts and
+				   NWeights METWEIGHT */
+  ss_skyview = 2,		/* SkyViewMap, NY * NX float */
+  ss_preciplapse = 4,		/* PrecipLapseMap, NY * NX float */
+  ss_pptmultiplier = 8,		/* PptMultiplierMap, NY * NX float */
+  ss_windmodel = 16		/* WindModel, NWindMaps * NY * NX float */
+};
+
+typedef struct {
+  char Magic[8];		/* STATICSHARE_MAGIC, not terminated */
+  unsigned long long Key;	/* Hash of the inputs of the blocks */
+  int NY;			/* Number of rows */
+  int NX;			/* Number of columns */
+  int NStats;			/* Number of met stations */
+  int NWindMaps;		/* Number of wind model maps */
+  int Blocks;			/* ss_ flags of the blocks in the file */
+  int Spare;
+  unsigned long long NWeights;	/* Number of nonzero weights */
+} STATICSHAREHEADER;
+
+void InitStaticShare(char *FileName, MAPSIZE *Map, OPTIONSTRUCT *Options,
+		     TOPOPIX **TopoMap, METWEIGHTS *MetWeights,
+		     METLOCATION *Stat, int NStats, GRID *Grid,
+		     float **SkyViewMap,
+		     float **PrecipLapseMap, float **PptMultiplierMap,
+		     float ***WindModel);
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * SUMMARY:      stationindex.h - header file for StationIndex.c
+ * USAGE:        Part of DHSVM
+ *
+ * AUTHOR:       DHSVM ANOVA project
+ * ORIG-DATE:    Oct-2026
+ * DESCRIPTION:  Uniform grid of buckets over the met station locations.  The
+ *               buckets are square, Size pixels wide, and cover the stations
+ *               from (MinN, MinE) on.  The stations of bucket b are
+ *               Station[Start[b]] to Station[Start[b + 1] - 1].
+ * DESCRIP-END.
+ * FUNCTIONS:
+ * COMMENTS:
+ */
+
+#ifndef STATIONINDEX_H
+#define STATIONINDEX_H
+
+#include "settings.h"
+#include "data.h"
+
+typedef struct {
+  int MinN;			/* Row of the first bucket */
+  int MinE;			/* Column of the first bucket */
+  int Size;			/* Width of a bucket (pixels) */
+  int NBN;			/* Number of buckets north - south */
+  int NBE;			/* Number of buckets east - west */
+  int *Start;			/* First station of each bucket, NBN * NBE + 1 */
+  int *Station;			/* Stations, bucket by bucket */
+} STATIONINDEX;
+
+typedef struct {
+  int Station;			/* Index of the station */
+  double Distance;		/* Distance to the station (pixels) */
+} STATIONDISTANCE;
+
+void InitStationIndex(METLOCATION *Station, int NStats, STATIONINDEX *Index);
+
+int FindNearestStations(STATIONINDEX *Index, METLOCATION *Station,
+			COORD *Loc, int K, STATIONDISTANCE *Nearest);
+
+void FreeStationIndex(STATIONINDEX *Index);
+
+#endif
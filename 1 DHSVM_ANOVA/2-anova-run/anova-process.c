@@ -1,16 +1,63 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include "mpi.h"
+#ifndef EXTERNAL_DHSVM
+#include "rundhsvm.h" //DHSVM is linked in and run in-process
+#else
+#include "parmatrix.h" //binary parameter matrix read by DHSVM3.2
+#endif
 #define NSAMPLE 12916 //number of final parameter sets
-#define NPARAM 105 //NPARAM+RunNumber=104+1=105
-int min(int x,int y)
-{
-   if (x>=y)
-     return 1;
-   else
-     return 0;
-}
+#define CONFIGFILE "./DHSVM/config/Shaduan_modified2.txt"
+#define LEDGER "anova_ledger.txt" //one line per finished run: RunNumber status seconds processor
+#define FAILEDPAR "failed_par" //parameter sets that still failed after MAX_ATTEMPTS runs
+#define PARMATRIX "final_par.bin" //binary copy of final_par for DHSVM3.2, see parmatrix.h
+#define MAX_ATTEMPTS 3 //runs of a failing sample, including the first one
+#define TAG_REQUEST 1 //worker -> rank 0: results of the finished chunk, asks for the next one
+#define TAG_WORK 2 //rank 0 -> worker: next chunk, count 0 means stop
+#define CHUNK_SECONDS 1800.0 //a chunk should not take much longer than this
+#define POLL_NSEC 10000000 //rank 0 looks for requests every 10 ms
+
+//build (in-process, default):
+//  make -C DHSVM/sourcecode libDHSVM.a
+//  mpicc -pthread -I./DHSVM/sourcecode anova-process.c -L./DHSVM/sourcecode -lDHSVM -lm -o anova-process
+//build with -DEXTERNAL_DHSVM (and -I./DHSVM/sourcecode) to run ./DHSVM/sourcecode/DHSVM3.2
+//once per sample instead. Rank 0 then writes PARMATRIX once and each run gets
+//its row number on the command line, so the values stay exact doubles.
+//
+//scheduling: every rank reads the whole parameter matrix, so only sample
+//numbers are sent. Rank 0 hands out chunks from a queue of samples on request
+//(guided self-scheduling: half the remaining samples per rank, limited to
+//CHUNK_SECONDS of run time at the requester's mean time per sample). Rank 0
+//runs samples itself in a second thread; only its main thread calls MPI.
+//
+//restart: rank 0 appends every finished run to LEDGER and flushes it. When
+//the campaign is started again, samples with a successful run in LEDGER are
+//skipped and failed ones are run again until they failed MAX_ATTEMPTS times.
+
+//values per parameter set, the parameters of the binding file of CONFIGFILE
+//plus the RunNumber; counted from the first line of final_par
+int nparam;
+
+//scheduler state, only used on rank 0
+int *queue; //samples still to run, failed samples are added again at the end
+int queue_head=0,queue_tail=0;
+int *done_by; //rank that finished each sample, -1 if not finished
+int *attempts; //number of failed runs of each sample
+int *last_status; //exit status of the last failed run of each sample
+FILE *ledgerfp;
+pthread_mutex_t sched_lock=PTHREAD_MUTEX_INITIALIZER;
+
+//what the rank 0 compute thread needs
+typedef struct {
+    double **par;
+    int nranks;
+#ifndef EXTERNAL_DHSVM
+    STATICINPUT *Static;
+#endif
+} LOCALWORK;
 
 double **DoubleMatrix(int m, int n)
 {
@@ -33,13 +80,273 @@ int FreeDoubleMatrix (double **x, int m)
    return 0;
 }
 
+double wall_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return ts.tv_sec+1e-9*ts.tv_nsec;
+}
+
+//sample index of a RunNumber, -1 if it is not in par
+int find_sample(double **par,int run)
+{
+    static int *index=NULL; //sample of each RunNumber
+    static int maxrun=-1;
+    int i;
+
+    if (index==NULL)
+    {
+        for (i=0; i<NSAMPLE; i++)
+            if ((int)par[i][nparam-1]>maxrun)
+                maxrun=(int)par[i][nparam-1];
+        index=(int *)malloc((maxrun+1)*sizeof(int));
+        for (i=0; i<=maxrun; i++)
+            index[i]=-1;
+        for (i=0; i<NSAMPLE; i++)
+            if ((int)par[i][nparam-1]>=0)
+                index[(int)par[i][nparam-1]]=i;
+    }
+    if (run<0 || run>maxrun)
+        return -1;
+    return index[run];
+}
+
+//read the ledger of an earlier start, open it for appending and fill the queue
+void init_ledger(double **par)
+{
+    FILE *fp;
+    int i,run,status,rank;
+    double seconds;
+    int nskip=0,nretry=0;
+
+    done_by=(int *)malloc(NSAMPLE*sizeof(int));
+    attempts=(int *)calloc(NSAMPLE,sizeof(int));
+    last_status=(int *)calloc(NSAMPLE,sizeof(int));
+    queue=(int *)malloc(NSAMPLE*MAX_ATTEMPTS*sizeof(int));
+    for (i=0; i<NSAMPLE; i++)
+        done_by[i]=-1;
+
+    fp=fopen(LEDGER,"r");
+    if (fp!=NULL)
+    {
+        while (fscanf(fp,"%d %d %lf %d",&run,&status,&seconds,&rank)==4)
+        {
+            i=find_sample(par,run);
+            if (i<0)
+                continue;
+            if (status==0)
+                done_by[i]=rank;
+            else
+            {
+                attempts[i]++;
+                last_status[i]=status;
+            }
+        }
+        fclose(fp);
+    }
+
+    for (i=0; i<NSAMPLE; i++)
+    {
+        if (done_by[i]>=0)
+            nskip++;
+        else if (attempts[i]<MAX_ATTEMPTS)
+        {
+            if (attempts[i]>0)
+                nretry++;
+            queue[queue_tail++]=i;
+        }
+    }
+    printf("ledger %s: %d samples already finished, %d to retry, %d to run\n",
+           LEDGER,nskip,nretry,queue_tail);
+
+    ledgerfp=fopen(LEDGER,"a");
+    if (ledgerfp==NULL)
+    {
+        printf("fail to open %s\n",LEDGER);
+        exit(1);
+    }
+}
+
+//hand out the next chunk into samples[]; returns its size, 0 when the queue is empty
+int next_chunk(double mean_seconds,int nranks,int *samples)
+{
+    int i,count;
+    int remaining;
+
+    pthread_mutex_lock(&sched_lock);
+    remaining=queue_tail-queue_head;
+    count=remaining/(2*nranks);
+    if (mean_seconds<=0)
+        count=1; //no run time known yet, measure it with a single sample
+    else if (count>CHUNK_SECONDS/mean_seconds)
+        count=(int)(CHUNK_SECONDS/mean_seconds);
+    if (count<1)
+        count=1;
+    if (count>remaining)
+        count=remaining;
+    for (i=0; i<count; i++)
+        samples[i]=queue[queue_head++];
+    pthread_mutex_unlock(&sched_lock);
+    return count;
+}
+
+//record one finished run in the ledger; a failed sample goes back into the queue
+void report_sample(double **par,int sample,int status,double seconds,int rank)
+{
+    pthread_mutex_lock(&sched_lock);
+    fprintf(ledgerfp,"%d\t%d\t%.1f\t%d\n",(int)par[sample][nparam-1],status,seconds,rank);
+    fflush(ledgerfp);
+    if (status==0)
+        done_by[sample]=rank;
+    else
+    {
+        attempts[sample]++;
+        last_status[sample]=status;
+        if (attempts[sample]<MAX_ATTEMPTS)
+            queue[queue_tail++]=sample;
+        printf("RunNumber %d failed with status %d (attempt %d of %d)\n",
+               (int)par[sample][nparam-1],status,attempts[sample],MAX_ATTEMPTS);
+    }
+    pthread_mutex_unlock(&sched_lock);
+}
+
+//run the samples of one chunk, returns the elapsed time
+#ifdef EXTERNAL_DHSVM
+double run_chunk(double **par,int *samples,int count,int *status,double *seconds)
+#else
+double run_chunk(double **par,int *samples,int count,STATICINPUT *Static,int *status,double *seconds)
+#endif
+{
+    int i;
+    double start=wall_seconds(),t;
+
+    for (i=0; i<count; i++)
+    {
+        t=wall_seconds();
+#ifdef EXTERNAL_DHSVM
+        char name_for_system[400];
+
+        sprintf(name_for_system,"./DHSVM/sourcecode/DHSVM3.2 %s %s %d",CONFIGFILE,PARMATRIX,samples[i]);
+        status[i] = system(name_for_system); //run another exe
+#else
+        status[i] = RunParameterSample(Static, par[samples[i]]); //run DHSVM for this sample
+#endif
+        seconds[i]=wall_seconds()-t;
+
+        if (status[i]!=0)
+            printf("fail to run DHSVM\n");
+        else
+            printf("success to run DHSVM\n");
+    }
+    return wall_seconds()-start;
+}
+
+//rank 0 compute thread, takes chunks from the same scheduler as the workers
+void *local_worker(void *arg)
+{
+    LOCALWORK *work=(LOCALWORK *)arg;
+    int *samples=(int *)malloc(NSAMPLE*sizeof(int));
+    int *status=(int *)malloc(NSAMPLE*sizeof(int));
+    double *seconds=(double *)malloc(NSAMPLE*sizeof(double));
+    double mean_seconds=0,busy_seconds=0;
+    int i,nrun=0,count;
+
+    while ((count=next_chunk(mean_seconds,work->nranks,samples))>0)
+    {
+#ifdef EXTERNAL_DHSVM
+        busy_seconds+=run_chunk(work->par,samples,count,status,seconds);
+#else
+        busy_seconds+=run_chunk(work->par,samples,count,work->Static,status,seconds);
+#endif
+        for (i=0; i<count; i++)
+            report_sample(work->par,samples[i],status[i],seconds[i],0);
+        nrun+=count;
+        mean_seconds=busy_seconds/nrun;
+    }
+    free(samples);
+    free(status);
+    free(seconds);
+    return NULL;
+}
+
+#ifdef EXTERNAL_DHSVM
+//write par as a binary matrix (see parmatrix.h) for DHSVM3.2
+void write_parmatrix(double **par)
+{
+    FILE *fp;
+    PARMATRIXHEADER header;
+    int i;
+
+    memcpy(header.Magic,PARMATRIX_MAGIC,sizeof(header.Magic));
+    header.NRows=NSAMPLE;
+    header.NCols=nparam;
+    fp=fopen(PARMATRIX,"wb");
+    if (fp==NULL)
+    {
+        printf("fail to open %s\n",PARMATRIX);
+        exit(1);
+    }
+    fwrite(&header,sizeof(header),1,fp);
+    for (i=0; i<NSAMPLE; i++)
+        fwrite(par[i],sizeof(double),nparam,fp);
+    if (fclose(fp)!=0)
+    {
+        printf("fail to write %s\n",PARMATRIX);
+        exit(1);
+    }
+}
+#endif
+
+//write the parameter sets that never ran successfully, in the format of final_par
+void write_failed(double **par)
+{
+    FILE *fp;
+    int i,j,nfailed=0;
+
+    fp=fopen(FAILEDPAR,"w");
+    if (fp==NULL)
+    {
+        printf("fail to open %s\n",FAILEDPAR);
+        return;
+    }
+    for (i=0; i<NSAMPLE; i++)
+    {
+        if (done_by[i]>=0)
+            continue;
+        for (j=0; j<nparam; j++)
+            fprintf(fp,"%lf\t",par[i][j]);
+        fprintf(fp,"\n");
+        printf("RunNumber %d failed %d times, last status %d\n",
+               (int)par[i][nparam-1],attempts[i],last_status[i]);
+        nfailed++;
+    }
+    fclose(fp);
+    printf("%d failed parameter sets written to %s\n",nfailed,FAILEDPAR);
+}
+
+//number of values on the first line of fp, which is rewound
+int count_columns(FILE *fp)
+{
+    char line[65536];
+    char *p;
+    int n=0;
+
+    if (fgets(line,sizeof(line),fp)!=NULL)
+    {
+        for (p=strtok(line," \t\r\n"); p!=NULL; p=strtok(NULL," \t\r\n"))
+            n++;
+    }
+    rewind(fp);
+    return n;
+}
+
 int main(int argc,char *argv[])
 {
-    double** par=DoubleMatrix(NSAMPLE,NPARAM); //parameter matrix
-    int i,j,k;
-    int myid,numprocs;
-    double buffer[NPARAM]={0};
-    
+    double** par; //parameter matrix
+    int i,j;
+    int myid,numprocs,provided;
+
     //read parameter sample "par"
     FILE*parfp;
     parfp=fopen("final_par","r");
@@ -48,88 +355,156 @@ int main(int argc,char *argv[])
         printf("fail to open par file\n");
         exit(1);
     }
+    nparam=count_columns(parfp);
+    if (nparam<1)
+    {
+        printf("no values in par file\n");
+        exit(1);
+    }
+    par=DoubleMatrix(NSAMPLE,nparam);
     for (i=0; i<NSAMPLE; i++)
     {
-         for (j=0; j<NPARAM; j++)
+         for (j=0; j<nparam; j++)
          {
               fscanf(parfp,"%lf",&par[i][j]);
          }
-    } 
+    }
     fclose(parfp);
 
 
-    MPI_Init(&argc,&argv);
+    MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&provided);
     MPI_Status status;
     MPI_Comm_rank(MPI_COMM_WORLD,&myid);
     MPI_Comm_size(MPI_COMM_WORLD,&numprocs);
 
-    int send_cycle_number=(int)(NSAMPLE/(numprocs-1));
-    int remainder=NSAMPLE%(numprocs-1);
-    if (myid==0)//send par from master processor.
+#ifndef EXTERNAL_DHSVM
+    //read the inputs that are the same for every sample once per processor
+    STATICINPUT Static;
+    InitStaticInput(CONFIGFILE, argc, argv, &Static);
+    if (Static.Bindings.NParam!=nparam)
     {
-        printf("send_cycle_number= %d,remainder=%d\n",send_cycle_number,remainder);
-        for (k=0; k<send_cycle_number; k++)//send_cycle_number
+        printf("final_par has %d values per set, the binding file of %s needs %d\n",
+               nparam,CONFIGFILE,Static.Bindings.NParam);
+        MPI_Abort(MPI_COMM_WORLD,1);
+    }
+#else
+    if (myid==0)
+        write_parmatrix(par);
+    MPI_Barrier(MPI_COMM_WORLD); //PARMATRIX is complete before any run starts
+#endif
+
+    //request: mean time per sample, count, then sample, status and seconds of each run
+    double *request=(double *)malloc((2+3*NSAMPLE)*sizeof(double));
+    //reply: count, then the samples to run
+    int *reply=(int *)malloc((1+NSAMPLE)*sizeof(int));
+
+    if (myid==0)//hand out samples and run samples in a second thread
+    {
+        LOCALWORK work;
+        pthread_t thread;
+        int active=numprocs-1;
+        int flag,n;
+        struct timespec poll={0,POLL_NSEC};
+
+        if (provided<MPI_THREAD_FUNNELED)
         {
-             for (i=0; i<numprocs-1; i++)
-             {
-                  for (j=0; j<NPARAM; j++)
-                  {
-                       buffer[j]=par[k*(numprocs-1)+i][j];
-                  }
-                  MPI_Send(buffer,NPARAM,MPI_DOUBLE,i+1,k*(numprocs-1)+i,MPI_COMM_WORLD);
-             }
+            printf("MPI does not support threads, rank 0 will not run samples\n");
         }
-        for (i=0; i<remainder; i++)
+        init_ledger(par);
+
+        work.par=par;
+        work.nranks=numprocs;
+#ifndef EXTERNAL_DHSVM
+        work.Static=&Static;
+#endif
+        if (provided>=MPI_THREAD_FUNNELED)
+            pthread_create(&thread,NULL,local_worker,&work);
+        else if (numprocs==1)
+            local_worker(&work);
+
+        //workers keep their own mean time per sample, it comes with each request.
+        //results are reported before the next chunk is handed out, so a failed
+        //sample that is queued again is always picked up by a rank still running
+        while (active>0)
         {
-             for (j=0; j<NPARAM; j++)
-             {
-                  buffer[j]=par[send_cycle_number*(numprocs-1)+i][j];
-             }
-             MPI_Send(buffer,NPARAM,MPI_DOUBLE,i+1,send_cycle_number*(numprocs-1)+i,MPI_COMM_WORLD);
+            MPI_Iprobe(MPI_ANY_SOURCE,TAG_REQUEST,MPI_COMM_WORLD,&flag,&status);
+            if (!flag)
+            {
+                nanosleep(&poll,NULL);
+                continue;
+            }
+            MPI_Get_count(&status,MPI_DOUBLE,&n);
+            MPI_Recv(request,n,MPI_DOUBLE,status.MPI_SOURCE,TAG_REQUEST,MPI_COMM_WORLD,&status);
+            for (i=0; i<(int)request[1]; i++)
+                report_sample(par,(int)request[2+3*i],(int)request[3+3*i],request[4+3*i],status.MPI_SOURCE);
+            reply[0]=next_chunk(request[0],numprocs,&reply[1]);
+            MPI_Send(reply,1+reply[0],MPI_INT,status.MPI_SOURCE,TAG_WORK,MPI_COMM_WORLD);
+            if (reply[0]==0)
+                active--;
         }
+        if (provided>=MPI_THREAD_FUNNELED)
+            pthread_join(thread,NULL);
+        fclose(ledgerfp);
+
+        //summary of who ran what
+        int *per_rank=(int *)calloc(numprocs,sizeof(int));
+        int missing=0;
+        for (i=0; i<NSAMPLE; i++)
+        {
+            if (done_by[i]<0)
+                missing++;
+            else if (done_by[i]<numprocs)
+                per_rank[done_by[i]]++;
+        }
+        for (i=0; i<numprocs; i++)
+            printf("processor %d ran %d samples\n",i,per_rank[i]);
+        printf("%d of %d samples finished\n",NSAMPLE-missing,NSAMPLE);
+        write_failed(par);
+        free(per_rank);
+        free(done_by);
+        free(attempts);
+        free(last_status);
+        free(queue);
     }
     else
     {
-        //receive message.
-        char Filename[100];//tem_file
-        FILE*temfp[numprocs];//the temporary file is used to deposit a sample which will be runned by DHSVM soon.
-        char name_for_system[400];
+        int *status_run=(int *)malloc(NSAMPLE*sizeof(int));
+        double *seconds=(double *)malloc(NSAMPLE*sizeof(double));
+        double busy_seconds=0;
+        int nrun=0,count=0;
 
-        for (i=0; i<send_cycle_number+min(remainder,myid); i++)//if remainder-1>=myid,plus 1; else 0.
+        request[0]=0;
+        request[1]=0;
+        for (;;)
         {
-             MPI_Recv(buffer,NPARAM,MPI_DOUBLE,0,i*(numprocs-1)+myid-1,MPI_COMM_WORLD,&status);
-
-             sprintf(Filename,"tem_file[%d]",myid);
-             printf("Filename = %s\n",Filename);
-             temfp[myid]=fopen(Filename,"w");
-             if (temfp[myid]==NULL)
-             {
-                 printf("fail to open tem_file[%d]\n",myid);
-                 exit(1);
-             }
-             else
-                 printf("success to open tem_file[%d]\n",myid);
-             for (j=0; j<NPARAM; j++)
-             {
-                  fprintf(temfp[myid],"%lf\t",buffer[j]);
-             }
-             fclose(temfp[myid]);
-             
-             sprintf(name_for_system,"./DHSVM/sourcecode/DHSVM3.2 ./DHSVM/config/Shaduan_modified2.txt %d",myid);
-             int b = system(name_for_system); //run another exe
-
-             if (b!=0)
-             {
-                 printf("fail to run DHSVM\n");
-                 exit(1);
-             }
-             else
-                 printf("success to run DHSVM\n");
+            MPI_Send(request,2+3*count,MPI_DOUBLE,0,TAG_REQUEST,MPI_COMM_WORLD);
+            MPI_Recv(reply,1+NSAMPLE,MPI_INT,0,TAG_WORK,MPI_COMM_WORLD,&status);
+            count=reply[0];
+            if (count==0)
+                break;
+#ifdef EXTERNAL_DHSVM
+            busy_seconds+=run_chunk(par,&reply[1],count,status_run,seconds);
+#else
+            busy_seconds+=run_chunk(par,&reply[1],count,&Static,status_run,seconds);
+#endif
+            nrun+=count;
+            request[0]=busy_seconds/nrun;
+            request[1]=count;
+            for (i=0; i<count; i++)
+            {
+                request[2+3*i]=reply[1+i];
+                request[3+3*i]=status_run[i];
+                request[4+3*i]=seconds[i];
+            }
         }
+        free(status_run);
+        free(seconds);
     }
-    
+
+    free(request);
+    free(reply);
     MPI_Finalize();
     FreeDoubleMatrix(par,NSAMPLE);
-    
+
     return 0;
 }
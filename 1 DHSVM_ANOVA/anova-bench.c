@@ -0,0 +1,262 @@
+/*
+Benchmark of the fused ANOVA kernel (anova-kernel.c) against the original
+ANOVA() of anova.c, on synthetic levels and objectives, and of the bootstrap
+on one thread against all threads.
+
+build: gcc -O3 -fopenmp anova-bench.c anova-kernel.c -o anova-bench -lm
+usage: ./anova-bench [nsample [nparam [nrspl]]]   (default 12916 samples, 104 parameters,
+       50 resamples)
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "anova-kernel.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//original kernel from anova.c, unchanged
+void ANOVA(float *objs,int **LL, int nsample, int nparam, float *F, float *R2)
+{
+	int i,j,k,l;
+	float Yi[3],Yj[3],GY;//Level mean, grand mean
+	int ni[3],nj[3];//number of points at each level
+	float Yij[3][3];
+	int nij[3][3];
+	float SSTR;//treatment sum of squares
+	float SSTO;
+	float SSE;//error sum of squares
+	float MSTR;//treatmeant mean squre
+	float MSE;//error eman squre
+	float SSAB;//cross-factor sum of squares
+	float SSTRAB;
+	float SSEAB;
+	float MSAB;
+	float MSEAB;
+	float s;
+	int index;
+
+	s=0;
+	for(i=0;i<nsample;i++)
+	{
+		s=s+objs[i];
+	}
+	GY=s/nsample;
+
+	SSTO=0;
+	for(i=0;i<nsample;i++)
+	{
+		SSTO=SSTO+(objs[i]-GY)*(objs[i]-GY);
+	}
+	R2[0]=0;
+	R2[1]=0;
+
+	//main effects
+	for(i=0;i<nparam;i++)
+	{
+		for(j=0;j<3;j++)
+		{
+			Yi[j]=0;
+			ni[j]=0;
+		}
+		for(j=0;j<nsample;j++)
+		{
+			Yi[LL[j][i]+1]=Yi[LL[j][i]+1]+objs[j];
+			ni[LL[j][i]+1]=ni[LL[j][i]+1]+1;
+		}
+		SSTR=0;
+		for(j=0;j<3;j++)
+		{
+			if(ni[j]>0) Yi[j]=Yi[j]/ni[j];
+			SSTR=SSTR+ni[j]*(Yi[j]-GY)*(Yi[j]-GY);
+		}
+		SSE=0;
+		for(j=0;j<nsample;j++)
+		{
+			SSE=SSE+(objs[j]-Yi[LL[j][i]+1])*(objs[j]-Yi[LL[j][i]+1]);
+		}
+
+		MSTR=SSTR/(3-1);
+		MSE=SSE/(nsample-3);
+		if(MSE>0) F[i]=MSTR/MSE;
+		R2[0]=R2[0]+SSTR/SSTO;
+		R2[1]=R2[1]+SSTR/SSTO;
+	}
+
+	//Interactions
+	index=nparam;
+	for(i=0;i<nparam-1;i++)
+	{
+		for(j=0;j<3;j++)
+		{
+			Yi[j]=0;
+			ni[j]=0;
+		}
+		for(j=0;j<nsample;j++)
+		{
+			Yi[LL[j][i]+1]=Yi[LL[j][i]+1]+objs[j];
+			ni[LL[j][i]+1]=ni[LL[j][i]+1]+1;
+		}
+		for(j=0;j<3;j++)
+		{
+			if(ni[j]>0) Yi[j]=Yi[j]/ni[j];
+		}
+
+		for(j=i+1;j<nparam;j++)
+		{
+			for(k=0;k<3;k++)
+			{
+				Yj[k]=0;
+				nj[k]=0;
+			}
+			for(k=0;k<nsample;k++)
+			{
+				Yj[LL[k][j]+1]=Yj[LL[k][j]+1]+objs[k];
+				nj[LL[k][j]+1]=nj[LL[k][j]+1]+1;
+			}
+			for(k=0;k<3;k++)
+			{
+				if(nj[k]>0) Yj[k]=Yj[k]/nj[k];
+			}
+
+			for(k=0;k<3;k++)
+			{
+				for(l=0;l<3;l++)
+				{
+					Yij[k][l]=0;
+					nij[k][l]=0;
+				}
+			}
+			for(k=0;k<nsample;k++)
+			{
+				Yij[LL[k][i]+1][LL[k][j]+1]=Yij[LL[k][i]+1][LL[k][j]+1]+objs[k];
+				nij[LL[k][i]+1][LL[k][j]+1]=nij[LL[k][i]+1][LL[k][j]+1]+1;
+			}
+			SSTRAB=0;
+			for(k=0;k<3;k++)
+			{
+				for(l=0;l<3;l++)
+				{
+					if(nij[k][l]>0) Yij[k][l]=Yij[k][l]/nij[k][l];
+					SSTRAB=SSTRAB+nij[k][l]*(Yij[k][l]-GY)*(Yij[k][l]-GY);
+				}
+			}
+			SSAB=0;
+			for(k=0;k<3;k++)
+			{
+				for(l=0;l<3;l++)
+				{
+					SSAB=SSAB+nij[k][l]*(Yij[k][l]-Yi[k]-Yj[l]+GY)*(Yij[k][l]-Yi[k]-Yj[l]+GY);
+				}
+			}
+			MSAB=SSAB/((3-1)*(3-1));
+			SSEAB=0;
+			for(k=0;k<nsample;k++)
+			{
+				SSEAB=SSEAB+(objs[k]-Yij[LL[k][i]+1][LL[k][j]+1])*(objs[k]-Yij[LL[k][i]+1][LL[k][j]+1]);
+			}
+			MSEAB=SSEAB/(nsample-3*3);
+			if(MSEAB>0) F[index]=MSAB/MSEAB;
+			R2[1]=R2[1]+SSAB/SSTO;
+			index=index+1;
+		}
+	}
+
+}
+
+double Seconds(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC,&t);
+	return t.tv_sec+1e-9*t.tv_nsec;
+}
+
+int main(int argc, char* argv[])
+{
+	int nsample=argc>1 ? atoi(argv[1]) : 12916;
+	int nparam=argc>2 ? atoi(argv[2]) : 104;
+	int nrspl=argc>3 ? atoi(argv[3]) : 50;
+	int np=nparam+nparam*(nparam-1)/2;
+	int nthread=1;
+	float *C1,*CN;
+	int **LL;
+	float *obj,*F0,*F1,R20[2],R21[2];
+	signed char *lv;
+	double t0,t1,t2,d,maxrel=0;
+	unsigned int seed=12345;
+	int i,k,ndiff=0;
+	char s0[32],s1[32];
+
+	LL=(int **) malloc(nsample*sizeof(int *));
+	obj=(float *) malloc(nsample*sizeof(float));
+	F0=(float *) calloc(np,sizeof(float));
+	F1=(float *) calloc(np,sizeof(float));
+	//levels from a fixed LCG, objective with main effects, one interaction and noise
+	for(k=0;k<nsample;k++)
+	{
+		LL[k]=(int *) malloc(nparam*sizeof(int));
+		for(i=0;i<nparam;i++)
+		{
+			seed=seed*1103515245u+12345u;
+			LL[k][i]=(int)((seed>>16)%3)-1;
+		}
+		seed=seed*1103515245u+12345u;
+		obj[k]=100+5*LL[k][0]+2*LL[k][1]*LL[k][1]+3*LL[k][0]*LL[k][2]+((seed>>16)%1000)/100.0f;
+	}
+
+	t0=Seconds();
+	ANOVA(obj,LL,nsample,nparam,F0,R20);
+	t1=Seconds();
+	lv=PackLevels(LL,nsample,nparam);
+	ANOVA_FUSED(obj,lv,nsample,nparam,F1,R21,NULL,NULL);
+	t2=Seconds();
+
+	//the results files print F with %10.4f and R2 with %6.4f
+	for(i=0;i<np;i++)
+	{
+		d=fabs((double)F1[i]-F0[i])/(fabs(F0[i])>1e-6 ? fabs(F0[i]) : 1e-6);
+		if(d>maxrel) maxrel=d;
+		sprintf(s0,"%10.4f",F0[i]);
+		sprintf(s1,"%10.4f",F1[i]);
+		if(strcmp(s0,s1)!=0) ndiff++;
+	}
+	printf("%d samples, %d parameters, %d effects\n",nsample,nparam,np);
+	printf("ANOVA:       %8.3f s\n",t1-t0);
+	printf("ANOVA_FUSED: %8.3f s (including PackLevels), speedup %.1f\n",t2-t1,(t1-t0)/(t2-t1));
+	printf("max relative difference of F: %g\n",maxrel);
+	printf("F values that differ in %%10.4f: %d of %d\n",ndiff,np);
+	printf("R2-1: %6.4f %6.4f\n",R20[0],R21[0]);
+	printf("R2-2: %6.4f %6.4f\n",R20[1],R21[1]);
+
+	//bootstrap on one thread and on all threads must give the same bits
+	C1=(float *) calloc(np,sizeof(float));
+	CN=(float *) calloc(np,sizeof(float));
+#ifdef _OPENMP
+	nthread=omp_get_max_threads();
+	omp_set_num_threads(1);
+#endif
+	t0=Seconds();
+	BOOTSTRAP_ANOVA(obj,lv,nsample,nparam,nrspl,1,C1);
+	t1=Seconds();
+#ifdef _OPENMP
+	omp_set_num_threads(nthread);
+#endif
+	BOOTSTRAP_ANOVA(obj,lv,nsample,nparam,nrspl,1,CN);
+	t2=Seconds();
+	printf("BOOTSTRAP_ANOVA, %d resamples: %8.3f s on 1 thread, %8.3f s on %d threads\n",
+	       nrspl,t1-t0,t2-t1,nthread);
+	printf("intervals identical: %s\n",memcmp(C1,CN,np*sizeof(float))==0 ? "yes" : "no");
+
+	free(C1);
+	free(CN);
+	free(lv);
+	for(k=0;k<nsample;k++) free(LL[k]);
+	free(LL);
+	free(obj);
+	free(F0);
+	free(F1);
+	return 0;
+}
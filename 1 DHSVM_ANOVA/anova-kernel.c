@@ -0,0 +1,288 @@
+/*
+Fused ANOVA kernel for many parameters and 2-way interactions.
+
+ANOVA() in anova.c makes one pass over the samples per main effect and three
+per interaction pair, through the LL row pointers, in float. This kernel
+gives the same F values and R2 with:
+  - the levels as bytes in a column major matrix (PackLevels()), so that the
+    levels of one parameter are a contiguous stream;
+  - objectives centered on the grand mean and all sums in double;
+  - one pass per parameter for the level sums and one pass per pair for the
+    3x3 cell sums. Only the 2x2 cells of levels -1 and 0 are accumulated, the
+    others follow from the level sums. The error sums of squares follow from
+    SSTO = SSTR + SSE, so no pass is needed for them;
+  - the samples are processed in blocks, so that the objectives and the
+    column of the first parameter stay in cache while the columns of all
+    partners stream past;
+  - OpenMP over the first parameter of the pairs. Every pair is summed by
+    one thread in a fixed order, so the results do not depend on the number
+    of threads.
+
+BOOTSTRAP_ANOVA() replaces the resampling loop of Bt_ANOVA(). A resample is
+a vector of sample counts instead of a copy of the LL rows and objectives;
+the kernel weights every sample by its count, which gives the same sums as
+the copied samples. Resamples run in parallel, each with its own stream of
+a counter based generator, and the variance of F is accumulated in
+resample order, so the intervals do not depend on the number of threads.
+
+build: add anova-kernel.c to the compile line, with -fopenmp for threads, e.g.
+  gcc -O3 -fopenmp anova-final.c anova-kernel.c -o anova-final -lm
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "anova-kernel.h"
+
+#define BLOCK 4096 //samples per cache block
+#define BATCH 64 //resamples held in memory by BOOTSTRAP_ANOVA
+
+static void Fused(float *objs, const int *w, signed char *lv, int nsample,
+		  int nparam, float *F, float *R2, double *SSA, double *SSB);
+static unsigned long long Mix(unsigned long long x);
+
+signed char *PackLevels(int **LL, int nsample, int nparam)
+{
+	size_t i,k;
+	signed char *lv;
+
+	lv=(signed char *) malloc((size_t) nsample*nparam);
+	for(k=0;k<(size_t)nsample;k++)
+	{
+		for(i=0;i<(size_t)nparam;i++) lv[i*nsample+k]=(signed char)(LL[k][i]+1);
+	}
+	return lv;
+}
+
+void ANOVA_FUSED(float *objs, signed char *lv, int nsample, int nparam,
+		 float *F, float *R2, double *SSA, double *SSB)
+{
+	Fused(objs,NULL,lv,nsample,nparam,F,R2,SSA,SSB);
+}
+
+void BOOTSTRAP_ANOVA(float *objs, signed char *lv, int nsample, int nparam,
+		     int nrspl, unsigned long long seed, float *FCI)
+{
+	int np=nparam+nparam*(nparam-1)/2;
+	int r0,nb,b,ii;
+	float *Fb;//F of the resamples of one batch
+	double *mean,*M2;//running mean and sum of squared deviations of F
+	double d;
+
+	Fb=(float *) malloc((size_t) BATCH*np*sizeof(float));
+	mean=(double *) calloc((size_t) np,sizeof(double));
+	M2=(double *) calloc((size_t) np,sizeof(double));
+
+	for(r0=0;r0<nrspl;r0+=BATCH)
+	{
+		nb=r0+BATCH<nrspl ? BATCH : nrspl-r0;
+		#pragma omp parallel for schedule(dynamic)
+		for(b=0;b<nb;b++)
+		{
+			int *w=(int *) calloc((size_t) nsample,sizeof(int));
+			float R2[2];
+			unsigned long long c=(unsigned long long)(r0+b)*nsample;
+			int k;
+
+			//draw nsample samples with replacement from stream r0+b
+			for(k=0;k<nsample;k++)
+			{
+				unsigned long long x=Mix(seed+(c+k+1)*0x9E3779B97F4A7C15ULL);
+				w[(int)(((x>>32)*(unsigned long long)nsample)>>32)]++;
+			}
+			memset(Fb+(size_t)b*np,0,np*sizeof(float));
+			Fused(objs,w,lv,nsample,nparam,Fb+(size_t)b*np,R2,NULL,NULL);
+			free(w);
+		}
+		//Welford update in resample order
+		for(b=0;b<nb;b++)
+		{
+			for(ii=0;ii<np;ii++)
+			{
+				d=Fb[(size_t)b*np+ii]-mean[ii];
+				mean[ii]=mean[ii]+d/(r0+b+1);
+				M2[ii]=M2[ii]+d*(Fb[(size_t)b*np+ii]-mean[ii]);
+			}
+		}
+	}
+	for(ii=0;ii<np;ii++)
+		FCI[ii]=(float)(1.96*sqrt(nrspl>1 ? M2[ii]/(nrspl-1) : 0));
+
+	free(Fb);
+	free(mean);
+	free(M2);
+}
+
+//splitmix64 output function
+static unsigned long long Mix(unsigned long long x)
+{
+	x=(x^(x>>30))*0xBF58476D1CE4E5B9ULL;
+	x=(x^(x>>27))*0x94D049BB133111EBULL;
+	return x^(x>>31);
+}
+
+//the kernel; every sample k counts w[k] times, or once if w is NULL
+static void Fused(float *objs, const int *w, signed char *lv, int nsample,
+		  int nparam, float *F, float *R2, double *SSA, double *SSB)
+{
+	int i,j,k,a;
+	int npair=nparam*(nparam-1)/2;
+	double *y;//objectives minus the grand mean, times the sample count
+	int *n;//sample counts
+	int ntotal;
+	double *S;//level sums of y, S[3*i+a] for level a-1 of parameter i
+	int *N;//number of samples at each level
+	double *R2AB;//SSAB/SSTO of each pair
+	double GY,SSTO,SSTR,SSE,R2main;
+	double s;
+
+	y=(double *) malloc((size_t) nsample*sizeof(double));
+	n=(int *) malloc((size_t) nsample*sizeof(int));
+	S=(double *) calloc((size_t) 3*nparam,sizeof(double));
+	N=(int *) calloc((size_t) 3*nparam,sizeof(int));
+	R2AB=(double *) calloc((size_t) (npair>0 ? npair : 1),sizeof(double));
+
+	s=0;
+	ntotal=0;
+	for(k=0;k<nsample;k++)
+	{
+		n[k]=w!=NULL ? w[k] : 1;
+		s=s+n[k]*(double)objs[k];
+		ntotal=ntotal+n[k];
+	}
+	GY=s/ntotal;
+	SSTO=0;
+	for(k=0;k<nsample;k++)
+	{
+		y[k]=n[k]*(objs[k]-GY);
+		SSTO=SSTO+y[k]*(objs[k]-GY);
+	}
+
+	//main effects
+	R2main=0;
+	for(i=0;i<nparam;i++)
+	{
+		const signed char *col=lv+(size_t)i*nsample;
+		for(k=0;k<nsample;k++)
+		{
+			S[3*i+col[k]]=S[3*i+col[k]]+y[k];
+			N[3*i+col[k]]=N[3*i+col[k]]+n[k];
+		}
+		SSTR=0;
+		for(a=0;a<3;a++)
+		{
+			if(N[3*i+a]>0) SSTR=SSTR+S[3*i+a]*S[3*i+a]/N[3*i+a];
+		}
+		SSE=SSTO-SSTR;
+		if(SSE/(nsample-3)>0) F[i]=(float)((SSTR/(3-1))/(SSE/(nsample-3)));
+		if(SSA!=NULL) SSA[i]=SSTR;
+		if(SSB!=NULL) SSB[i]=SSE;
+		R2main=R2main+SSTR/SSTO;
+	}
+
+	//interactions
+	#pragma omp parallel for schedule(dynamic) private(j,k)
+	for(i=0;i<nparam-1;i++)
+	{
+		const signed char *ci=lv+(size_t)i*nsample;
+		int np=nparam-1-i;//partners j=i+1..nparam-1
+		int first=i*(2*nparam-i-1)/2;//pair (i,i+1) in pair order
+		double *acc=(double *) calloc((size_t) 4*np,sizeof(double));
+		int *cnt=(int *) calloc((size_t) 4*np,sizeof(int));
+		int k0,k1,p,l,m;
+
+		for(k0=0;k0<nsample;k0+=BLOCK)
+		{
+			k1=k0+BLOCK<nsample ? k0+BLOCK : nsample;
+			for(p=0;p<np;p++)
+			{
+				const signed char *cj=lv+(size_t)(i+1+p)*nsample;
+				double s00=0,s01=0,s10=0,s11=0;
+				int n00=0,n01=0,n10=0,n11=0;
+				for(k=k0;k<k1;k++)
+				{
+					int a0=ci[k]==0,a1=ci[k]==1,b0=cj[k]==0,b1=cj[k]==1;
+					s00=s00+y[k]*(a0&b0);
+					s01=s01+y[k]*(a0&b1);
+					s10=s10+y[k]*(a1&b0);
+					s11=s11+y[k]*(a1&b1);
+					n00=n00+n[k]*(a0&b0);
+					n01=n01+n[k]*(a0&b1);
+					n10=n10+n[k]*(a1&b0);
+					n11=n11+n[k]*(a1&b1);
+				}
+				acc[4*p]=acc[4*p]+s00;
+				acc[4*p+1]=acc[4*p+1]+s01;
+				acc[4*p+2]=acc[4*p+2]+s10;
+				acc[4*p+3]=acc[4*p+3]+s11;
+				cnt[4*p]=cnt[4*p]+n00;
+				cnt[4*p+1]=cnt[4*p+1]+n01;
+				cnt[4*p+2]=cnt[4*p+2]+n10;
+				cnt[4*p+3]=cnt[4*p+3]+n11;
+			}
+		}
+
+		for(p=0;p<np;p++)
+		{
+			double Sij[3][3],Yi[3],Yj[3];
+			int nij[3][3];
+			double SSTRAB,SSAB,SSEAB;
+			j=i+1+p;
+
+			//complete the 3x3 table from the level sums
+			Sij[0][0]=acc[4*p]; Sij[0][1]=acc[4*p+1];
+			Sij[1][0]=acc[4*p+2]; Sij[1][1]=acc[4*p+3];
+			nij[0][0]=cnt[4*p]; nij[0][1]=cnt[4*p+1];
+			nij[1][0]=cnt[4*p+2]; nij[1][1]=cnt[4*p+3];
+			for(l=0;l<2;l++)
+			{
+				Sij[l][2]=S[3*i+l]-Sij[l][0]-Sij[l][1];
+				nij[l][2]=N[3*i+l]-nij[l][0]-nij[l][1];
+				Sij[2][l]=S[3*j+l]-Sij[0][l]-Sij[1][l];
+				nij[2][l]=N[3*j+l]-nij[0][l]-nij[1][l];
+			}
+			Sij[2][2]=S[3*i+2]-Sij[2][0]-Sij[2][1];
+			nij[2][2]=N[3*i+2]-nij[2][0]-nij[2][1];
+
+			for(l=0;l<3;l++)
+			{
+				Yi[l]=N[3*i+l]>0 ? S[3*i+l]/N[3*i+l] : 0;
+				Yj[l]=N[3*j+l]>0 ? S[3*j+l]/N[3*j+l] : 0;
+			}
+			SSTRAB=0;
+			SSAB=0;
+			for(l=0;l<3;l++)
+			{
+				for(m=0;m<3;m++)
+				{
+					if(nij[l][m]>0)
+					{
+						double Yij=Sij[l][m]/nij[l][m];
+						SSTRAB=SSTRAB+Sij[l][m]*Yij;
+						SSAB=SSAB+nij[l][m]*(Yij-Yi[l]-Yj[m])*(Yij-Yi[l]-Yj[m]);
+					}
+				}
+			}
+			SSEAB=SSTO-SSTRAB;
+			if(SSEAB/(nsample-3*3)>0)
+				F[nparam+first+p]=(float)((SSAB/((3-1)*(3-1)))/(SSEAB/(nsample-3*3)));
+			if(SSA!=NULL) SSA[nparam+first+p]=SSAB;
+			if(SSB!=NULL) SSB[nparam+first+p]=SSEAB;
+			R2AB[first+p]=SSAB/SSTO;
+		}
+		free(acc);
+		free(cnt);
+	}
+
+	//summed in pair order, so R2 does not depend on the number of threads
+	s=R2main;
+	for(i=0;i<npair;i++) s=s+R2AB[i];
+	R2[0]=(float)R2main;
+	R2[1]=(float)s;
+
+	free(y);
+	free(n);
+	free(S);
+	free(N);
+	free(R2AB);
+}
@@ -0,0 +1,25 @@
+/*
+Fused ANOVA kernel shared by anova.c, anova-final.c and anova-bench.c.
+See anova-kernel.c.
+*/
+
+#ifndef ANOVA_KERNEL_H
+#define ANOVA_KERNEL_H
+
+//parameter levels -1, 0, +1 stored as 0, 1, 2 in one byte, column major:
+//level of parameter i in sample k is lv[(size_t)i*nsample+k]
+signed char *PackLevels(int **LL, int nsample, int nparam);
+
+//F values and R2 of the main effects and 2-way interactions, same as ANOVA().
+//If SSA and SSB are not NULL they get, for every effect, SSTR and SSE (main
+//effects) or SSAB and SSEAB (interactions), in the order of F.
+void ANOVA_FUSED(float *objs, signed char *lv, int nsample, int nparam,
+		 float *F, float *R2, double *SSA, double *SSB);
+
+//bootstrap confidence intervals of F, 1.96 times the standard deviation of F
+//over nrspl resamples with replacement. The resamples depend only on seed,
+//not on the number of threads.
+void BOOTSTRAP_ANOVA(float *objs, signed char *lv, int nsample, int nparam,
+		     int nrspl, unsigned long long seed, float *FCI);
+
+#endif
@@ -3,12 +3,17 @@ Code Reference:
 Tang, Yong, Reed, P. M., Wagener, T., and van Werkhoven, K., "Comparing 
 sensitivity analysis methods to advance lumped watershed model identification 
 and evaluation." Hydrology and Earth System Sciences, 11, 793-817, 2007.
+
+build: gcc -O3 -fopenmp anova.c anova-kernel.c -o anova -lm
 */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include "anova-kernel.h"
+
+#define BOOTSTRAP_SEED 20070101ULL //seed of the bootstrap resamples
 
 int *IntVector(int n)
 {
@@ -458,198 +463,20 @@ void IFFD(int nrep,int nparm,int ncol,int nzero,double *lb, double *ub,double **
 //F is the array storing F values
 void ANOVA(float *objs,int **LL, int nsample, int nparam, float *F, float *R2)
 {
-	int i,j,k,l;
-	float Yi[3],Yj[3],GY;//Level mean, grand mean
-	int ni[3],nj[3];//number of points at each level
-	float Yij[3][3];
-	int nij[3][3];
-	float SSTR;//treatment sum of squares
-	float SSTO;
-	float SSE;//error sum of squares
-	float MSTR;//treatmeant mean squre 
-	float MSE;//error eman squre
-	float SSAB;//cross-factor sum of squares
-	float SSTRAB;
-	float SSEAB;
-	float MSAB;
-	float MSEAB;
-	float s; //sum of objs()
-	int index;
-	
-	s=0;
-	for(i=0;i<nsample;i++)
-	{
-		s=s+objs[i];
-	}
-	GY=s/nsample;
-	
-	SSTO=0;
-	for(i=0;i<nsample;i++)
-	{
-		SSTO=SSTO+(objs[i]-GY)*(objs[i]-GY);
-	}
-	R2[0]=0;
-	R2[1]=0;
-	//main effects
-	for(i=0;i<nparam;i++)
-	{
-		for(j=0;j<3;j++) 
-		{
-			Yi[j]=0;
-			ni[j]=0;
-		}
-		for(j=0;j<nsample;j++)
-		{
-			Yi[LL[j][i]+1]=Yi[LL[j][i]+1]+objs[j];
-			ni[LL[j][i]+1]=ni[LL[j][i]+1]+1;
-		}
-		SSTR=0;
-		for(j=0;j<3;j++) 
-		{
-			if(ni[j]>0) Yi[j]=Yi[j]/ni[j]; 
-			SSTR=SSTR+ni[j]*(Yi[j]-GY)*(Yi[j]-GY); 
-		}
-		SSE=0;
-		for(j=0;j<nsample;j++)
-		{
-			SSE=SSE+(objs[j]-Yi[LL[j][i]+1])*(objs[j]-Yi[LL[j][i]+1]);
-		}
-		MSTR=SSTR/(3-1);
-		MSE=SSE/(nsample-3);
-		if(MSE>0) F[i]=MSTR/MSE;
-		R2[0]=R2[0]+SSTR/SSTO;
-		R2[1]=R2[1]+SSTR/SSTO;
-	}
-	//Interactions
-	index=nparam;
-	for(i=0;i<nparam-1;i++)
-	{
-		for(j=0;j<3;j++) 
-		{
-			Yi[j]=0;
-			ni[j]=0;
-		}
-		for(j=0;j<nsample;j++)
-		{
-			Yi[LL[j][i]+1]=Yi[LL[j][i]+1]+objs[j];
-			ni[LL[j][i]+1]=ni[LL[j][i]+1]+1;
-		}
-		for(j=0;j<3;j++) 
-		{
-			if(ni[j]>0) Yi[j]=Yi[j]/ni[j]; 
-		}
-
-		for(j=i+1;j<nparam;j++)
-		{
-			for(k=0;k<3;k++) 
-			{
-				Yj[k]=0;
-				nj[k]=0;
-			}
-			for(k=0;k<nsample;k++)
-			{
-				Yj[LL[k][j]+1]=Yj[LL[k][j]+1]+objs[k];
-				nj[LL[k][j]+1]=nj[LL[k][j]+1]+1;
-			}
-			for(k=0;k<3;k++) 
-			{
-				if(nj[k]>0) Yj[k]=Yj[k]/nj[k]; 
-			}
+	signed char *lv;
 
-			for(k=0;k<3;k++)
-			{
-				for(l=0;l<3;l++)
-				{
-					Yij[k][l]=0;
-					nij[k][l]=0;
-				}
-			}
-			for(k=0;k<nsample;k++)
-			{
-				Yij[LL[k][i]+1][LL[k][j]+1]=Yij[LL[k][i]+1][LL[k][j]+1]+objs[k];
-				nij[LL[k][i]+1][LL[k][j]+1]=nij[LL[k][i]+1][LL[k][j]+1]+1;
-			}
-			SSTRAB=0;
-			for(k=0;k<3;k++)
-			{
-				for(l=0;l<3;l++)
-				{
-					if(nij[k][l]>0) Yij[k][l]=Yij[k][l]/nij[k][l];
-					SSTRAB=SSTRAB+nij[k][l]*(Yij[k][l]-GY)*(Yij[k][l]-GY);
-				}
-			}
-			SSAB=0;
-			for(k=0;k<3;k++)
-			{
-				for(l=0;l<3;l++)
-				{
-					SSAB=SSAB+nij[k][l]*(Yij[k][l]-Yi[k]-Yj[l]+GY)*(Yij[k][l]-Yi[k]-Yj[l]+GY);
-				}
-			}
-			MSAB=SSAB/((3-1)*(3-1));
-			SSEAB=0;
-			for(k=0;k<nsample;k++)
-			{
-				SSEAB=SSEAB+(objs[k]-Yij[LL[k][i]+1][LL[k][j]+1])*(objs[k]-Yij[LL[k][i]+1][LL[k][j]+1]);
-			}
-			MSEAB=SSEAB/(nsample-3*3);
-			if(MSEAB>0) F[index]=MSAB/MSEAB;
-			R2[1]=R2[1]+SSAB/SSTO;
-			index=index+1;
-		}
-	}
-	
+	lv=PackLevels(LL,nsample,nparam);
+	ANOVA_FUSED(objs,lv,nsample,nparam,F,R2,NULL,NULL);
+	free(lv);
 }
 
 void Bt_ANOVA(int nsample, int nparam, int np, int nrspl, int **LL, float *stobj, float *FCI)
 {
-	int i,j,k;
-	float *obj;
-	int rspl;
-	int **LL1;
-	float **s;
-	float *ss,*sss;
-	float R2[2];
-	int ii,kk;
-
-	s=FloatMatrix(nrspl,np);
-	ss=FloatVector(np);
-	sss=FloatVector(np);
-	LL1=IntMatrix(nsample,nparam);
-	obj=FloatVector(nsample);
-
-			for(ii=0;ii<np;ii++)
-			{
-				ss[ii]=0;
-				sss[ii]=0;
-			}
-			for(rspl=0;rspl<nrspl;rspl++)
-			{
-				for(k=0;k<nsample;k++)
-				{
-					kk=(int)Round((nsample-1)*RandomDbl());
-					obj[k]=stobj[kk];
-					for(ii=0;ii<nparam;ii++) LL1[k][ii]=LL[kk][ii];
-				}
-				ANOVA(obj,LL1,nsample,nparam,s[rspl],R2);
-				for(ii=0;ii<np;ii++) ss[ii]=ss[ii]+s[rspl][ii];
-			}
-			for(ii=0;ii<np;ii++) ss[ii]=ss[ii]/nrspl;
-			for(rspl=0;rspl<nrspl;rspl++)
-			{
-				for(ii=0;ii<np;ii++)
-					sss[ii]=sss[ii]+(s[rspl][ii]-ss[ii])*(s[rspl][ii]-ss[ii]);
-			}
-			for(ii=0;ii<np;ii++)
-			{
-				FCI[ii]=1.96*sqrt(sss[ii]/(nrspl-1));
-			}
+	signed char *lv;
 
-	FreeFloatMatrix(s,nrspl);
-	FreeIntMatrix(LL1,nsample);
-	FreeFloatVector(ss);
-	FreeFloatVector(sss);
-	FreeFloatVector(obj);
+	lv=PackLevels(LL,nsample,nparam);
+	BOOTSTRAP_ANOVA(stobj,lv,nsample,nparam,nrspl,BOOTSTRAP_SEED,FCI);
+	free(lv);
 }
 
 int main(int argc, char* argv[]) {
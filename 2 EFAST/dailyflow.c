@@ -2,9 +2,21 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #define NSTEP 7670
 #define NSAMPLE 12336
+#define FIRSTDAY 364  //first day written, the year before is spin-up
+//days transposed per pass over the output files, all of them by default
+//(NDAYBLOCK x NSAMPLE doubles, about 720 MB); lower it to save memory
+#define NDAYBLOCK (NSTEP - FIRSTDAY)
+
+//layout of the binary ensemble store, shared with DHSVM and objective.c
+//build: gcc -O2 -I"../1 DHSVM_ANOVA/2-anova-run/DHSVM/sourcecode" dailyflow.c -o dailyflow -lm
+#include "ensemble.h"
 
 void del_date_sim(FILE *fp)
 {
@@ -78,56 +90,136 @@ void LoadOutput(double Sim[NSTEP], char filename[200])
        fclose(fp);
 }
 
+//binary ensemble store written by DHSVM ("Ensemble Store" in the [OUTPUT] section)
+char *Store = NULL;
+ENSEMBLEHEADER *StoreHeader;
+long StoreRows;
+
+void OpenStore(char *filename)
+{
+        struct stat st;
+        int fd;
+        fd = open(filename, O_RDONLY);
+        if (fd == -1 || fstat(fd, &st) == -1)
+        {
+                printf("can not open %s.\n", filename);
+                exit(1);
+        }
+        Store = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (Store == (char *)MAP_FAILED || st.st_size < (long)sizeof(ENSEMBLEHEADER))
+        {
+                printf("can not read %s.\n", filename);
+                exit(1);
+        }
+        StoreHeader = (ENSEMBLEHEADER *)Store;
+        //step 0 is the start date, which has no value in Streamflow.Only either
+        if (strncmp(StoreHeader->Magic, ENSEMBLE_MAGIC, 8) != 0 ||
+            StoreHeader->Version != ENSEMBLE_VERSION ||
+            StoreHeader->NSeries < 1 || StoreHeader->NSteps < NSTEP + 1 ||
+            st.st_size < StoreHeader->DataOffset ||
+            StoreHeader->RowSize < (long)sizeof(ENSEMBLEROW) + (long)StoreHeader->NSteps * StoreHeader->NSeries * (long)sizeof(float))
+        {
+                printf("%s is not an ensemble store of %d steps.\n", filename, NSTEP + 1);
+                exit(1);
+        }
+        //StoreFlow() converts m^3/day, so the store must have a daily time step
+        if (StoreHeader->Dt != 3600 * 24)
+        {
+                printf("%s has a time step of %d s, not one day.\n", filename, StoreHeader->Dt);
+                exit(1);
+        }
+        StoreRows = (st.st_size - StoreHeader->DataOffset) / StoreHeader->RowSize;
+}
+
+double StoreFlow(int k, int j)
+{
+        ENSEMBLEROW *row;
+        float *value;
+        if (k >= StoreRows)
+        {
+                printf("run %d is not in the ensemble store.\n", k);
+                exit(1);
+        }
+        row = (ENSEMBLEROW *)(Store + StoreHeader->DataOffset + (long)k * StoreHeader->RowSize);
+        if (row->Status != ENSEMBLE_ROW_DONE)
+        {
+                printf("run %d is not in the ensemble store.\n", k);
+                exit(1);
+        }
+        value = (float *)(row + 1);
+        //first series is the outlet, day j is step j+1 as in LoadOutput()
+        return value[(long)(j + 1) * StoreHeader->NSeries] / 3600 / 24;// conversion of unit:m^3/day to m^3/s (same as obsfile).
+}
+
 int main(int argc, char* argv[]) 
 {
-	int i, j, k;
-        double sum_obs, average_obs;
-        double obj[NSAMPLE], obj1[NSAMPLE], obj2[NSAMPLE];
+	int j, k;
+        int day0, nday;
+        double *flow;  //flow[j * NSAMPLE + k]: day day0 + j of the k th parameter set
 
-        if (argc != 2)
+        if (argc != 2 && argc != 3)
         {
-            fprintf(stderr, "\nUsage: ./NS output_filename\n\n");
+            fprintf(stderr, "\nUsage: ./dailyflow output_prefix [ensemble_store]\n\n");
             exit(EXIT_FAILURE);
         }
 
-        int number=0;
-        obj[k] = 0;
         //Load Obs_file: observed outlet discharge.
         static double Obs[NSTEP];
         LoadInput(Obs);
-       
+        //Load Sim from the binary ensemble store instead of the Streamflow.Only files.
+        if (argc == 3)
+            OpenStore(argv[2]);
+
+        flow = (double *)malloc((size_t)NDAYBLOCK * NSAMPLE * sizeof(double));
+        if (flow == NULL)
+        {
+            printf("can not allocate %d days x %d samples, lower NDAYBLOCK.\n", NDAYBLOCK, NSAMPLE);
+            exit(1);
+        }
+
         FILE* NSfile;
         char obj_filename[100];
+        static double Sim[NSTEP];
+        char filename[300];
 
-       for (j = 364; j < NSTEP; j++)
+        //transpose a block of days at a time: each file is read once per block
+        for (day0 = FIRSTDAY; day0 < NSTEP; day0 += NDAYBLOCK)
         {
+            nday = NSTEP - day0 < NDAYBLOCK ? NSTEP - day0 : NDAYBLOCK;
+
             for (k = 0; k < NSAMPLE; k++) //k th parameter set
             {
+                if (Store != NULL)
+                {
+                    for (j = 0; j < nday; j++)
+                        flow[(size_t)j * NSAMPLE + k] = StoreFlow(k, day0 + j);
+                    continue;
+                }
                 //Load Sim_file: simulated outlet discharge streamflow.Only (yield by DHSVM).
-                double Sim[NSTEP];
-                char filename[300];
                 sprintf(filename, "./output/Streamflow.Only.[%d]", k);
                 LoadOutput(Sim, filename);
-                //calculate obj: daily sim.	
-                obj[k] = Sim[j];  //extract all the j th simulated flow
-                //printf("%f\n", obj[k]);
+                for (j = 0; j < nday; j++)
+                    flow[(size_t)j * NSAMPLE + k] = Sim[day0 + j];
             }
-            number = number + 1;  //for counting the j th day
-            
-               
-               sprintf(obj_filename, "%s%d.txt", argv[1], number);
+
+            //one file per day with the simulated flow of all parameter sets
+            for (j = 0; j < nday; j++)
+            {
+               sprintf(obj_filename, "%s%d.txt", argv[1], day0 + j - FIRSTDAY + 1);
                NSfile = fopen(obj_filename, "w");
-              /* if (NSfile == NULL)
+               if (NSfile == NULL)
                {
-                   printf("fail to open %s.\n", obj_filename[number]);
+                   printf("fail to open %s.\n", obj_filename);
                    exit(1);
-               }  */
+               }
                for (k = 0; k < NSAMPLE; k++)
                {
-                   fprintf(NSfile, "%lf\n", obj[k]);
+                   fprintf(NSfile, "%lf\n", flow[(size_t)j * NSAMPLE + k]);
                }
                fclose(NSfile);
+            }
         }
+        free(flow);
 	return 0;
 }
-